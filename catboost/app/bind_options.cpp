@@ -348,6 +348,14 @@ void ParseCommandLine(int argc, const char* argv[],
         })
         .Help("Use full history to calculate approxes.");
 
+    parser.AddLongOption("single-precision-fold-approxes")
+        .NoArgument()
+        .Handler0([plainJsonPtr]() {
+            (*plainJsonPtr)["single_precision_fold_approxes"] = true;
+        })
+        .Help("Keep approxes of learning folds in single precision between iterations and release derivatives buffers."
+              " Reduces memory usage of Ordered boosting, derivatives are still calculated in double precision.");
+
     parser.AddLongOption("fold-permutation-block",
                          "Enables fold permutation by blocks of given length, preserving documents order inside each block.")
         .RequiredArgument("BLOCKSIZE")
@@ -702,6 +710,14 @@ void ParseCommandLine(int argc, const char* argv[],
             (*plainJsonPtr)["allow_const_label"] = true;
         });
 
+    parser.AddLongOption("use-quantile-sketch-for-borders",
+                         "Select float feature borders from a streaming quantile sketch of all feature values"
+                         " instead of sorting full (or subsampled) data. Useful for very large datasets")
+        .NoArgument()
+        .Handler0([plainJsonPtr]() {
+            (*plainJsonPtr)["use_quantile_sketch_for_borders"] = true;
+        });
+
     parser.AddLongOption("classes-count", "number of classes")
         .RequiredArgument("int")
         .Handler1T<int>([plainJsonPtr](const int classesCount) {
@@ -0,0 +1,100 @@
+#include "modes.h"
+
+#include <catboost/libs/data_new/load_data.h>
+#include <catboost/libs/data_new/raw_columnar_pool.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/logging/logging.h>
+#include <catboost/libs/options/analytical_mode_params.h>
+#include <catboost/libs/quantization_schema/schema.h>
+#include <catboost/libs/quantization_schema/serialization.h>
+#include <catboost/libs/quantized_pool/streaming_writer.h>
+
+#include <library/getopt/small/last_getopt.h>
+
+#include <util/stream/file.h>
+#include <util/system/info.h>
+
+
+using namespace NCB;
+
+
+struct TConvertPoolParams {
+    TPathWithScheme InputPath;
+    TString OutputPath;
+    NCatboostOptions::TDsvPoolFormatParams DsvPoolFormatParams;
+    TString InputBordersFile;
+    ui32 QuantizedChunkSize = TQuantizedPoolStreamingWriter::DEFAULT_DOCUMENTS_PER_CHUNK;
+    TString QuantizedChunksCodec;
+    int ThreadCount = NSystemInfo::CachedNumberOfCpus();
+
+    void BindParserOpts(NLastGetopt::TOpts& parser) {
+        parser.AddLongOption("input-path", "input pool path")
+            .StoreResult(&InputPath)
+            .RequiredArgument("PATH");
+        BindDsvPoolFormatParams(&parser, &DsvPoolFormatParams);
+        parser.AddLongOption('o', "output-path", "output raw columnar pool path, load it with raw-columnar:// scheme")
+            .StoreResult(&OutputPath)
+            .RequiredArgument("PATH");
+        parser.AddLongOption("input-borders-file", "write quantized pool (load it with quantized:// scheme) with float features borders from this file instead, data is processed in a streaming fashion")
+            .StoreResult(&InputBordersFile)
+            .RequiredArgument("PATH");
+        parser.AddLongOption("quantized-chunk-size", "number of objects in chunks of quantized pool")
+            .StoreResult(&QuantizedChunkSize)
+            .RequiredArgument("INT");
+        parser.AddLongOption("quantized-chunks-codec", "compress chunks of quantized pool with this codec from library/blockcodecs (e.g. lz4 or zstd_1)")
+            .StoreResult(&QuantizedChunksCodec)
+            .RequiredArgument("NAME");
+        parser.AddLongOption('T', "thread-count", "worker thread count (default: core count)")
+            .StoreResult(&ThreadCount);
+    }
+};
+
+int mode_convert_pool(int argc, const char* argv[]) {
+    TConvertPoolParams params;
+
+    auto parser = NLastGetopt::TOpts();
+    parser.AddHelpOption();
+    params.BindParserOpts(parser);
+    parser.SetFreeArgsNum(0);
+    NLastGetopt::TOptsParseResult parserResult{&parser, argc, argv};
+
+    NPar::TLocalExecutor localExecutor;
+    localExecutor.RunAdditionalThreads(params.ThreadCount - 1);
+
+    if (params.InputBordersFile) {
+        const TPoolQuantizationSchema quantizationSchema = LoadQuantizationSchema(
+            EQuantizationSchemaSerializationFormat::Matrixnet,
+            params.InputBordersFile
+        );
+        TFileOutput output(params.OutputPath);
+        SaveQuantizedPoolFromRawDataset(
+            params.InputPath,
+            params.DsvPoolFormatParams,
+            /*ignoredFeatures*/ {},
+            quantizationSchema,
+            &output,
+            &localExecutor,
+            params.QuantizedChunkSize,
+            params.QuantizedChunksCodec
+        );
+        CATBOOST_INFO_LOG << "Saved quantized pool to " << params.OutputPath << Endl;
+        return 0;
+    }
+
+    TDataProviderPtr dataProvider = ReadDataset(
+        params.InputPath,
+        /*pairsFilePath=*/TPathWithScheme(),
+        /*groupWeightsFilePath=*/TPathWithScheme(),
+        params.DsvPoolFormatParams,
+        /*ignoredFeatures*/ {},
+        EObjectsOrder::Undefined,
+        &localExecutor
+    );
+
+    TRawDataProviderPtr rawDataProvider = dataProvider->CastMoveTo<TRawObjectsDataProvider>();
+    CB_ENSURE(rawDataProvider, "Only raw (not quantized) pools can be converted to raw columnar format");
+
+    SaveRawColumnarPool(*rawDataProvider, params.OutputPath);
+    CATBOOST_INFO_LOG << "Saved raw columnar pool to " << params.OutputPath << Endl;
+    return 0;
+}
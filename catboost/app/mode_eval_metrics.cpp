@@ -10,6 +10,7 @@
 #include <catboost/libs/model/model.h>
 #include <catboost/libs/options/analytical_mode_params.h>
 #include <catboost/libs/options/loss_description.h>
+#include <catboost/libs/options/system_options.h>
 #include <catboost/libs/target/data_providers.h>
 
 #include <library/getopt/small/last_getopt_opts.h>
@@ -30,6 +31,7 @@ struct TModeEvalMetricsParams {
     TString MetricsDescription;
     TString ResultDirectory;
     TString TmpDir;
+    TString UsedRamLimit;
 
     void BindParserOpts(NLastGetopt::TOpts& parser) {
         parser.AddLongOption("ntree-start", "Start iteration.")
@@ -51,10 +53,13 @@ struct TModeEvalMetricsParams {
                 .RequiredArgument("INT")
                 .DefaultValue("150000")
                 .StoreResult(&ReadBlockSize);
-        parser.AddLongOption("tmp-dir", "Dir to store approx for non-additive metrics. Use \"-\" to generate directory.")
+        parser.AddLongOption("tmp-dir", "Dir to store approx for non-additive metrics if they do not fit into used-ram-limit. Use \"-\" to generate directory.")
                 .RequiredArgument("String")
                 .DefaultValue("-")
                 .StoreResult(&TmpDir);
+        parser.AddLongOption("used-ram-limit", "RAM for approx of non-additive metrics, e.g. 4GB. Default is half of the total RAM.")
+                .RequiredArgument("SIZE")
+                .StoreResult(&UsedRamLimit);
     }
 };
 
@@ -155,6 +160,9 @@ int mode_eval_metrics(int argc, const char* argv[]) {
         plotParams.TmpDir,
         metrics
     );
+    if (!plotParams.UsedRamLimit.empty()) {
+        plotCalcer.SetApproxRamLimit(ParseMemorySizeDescription(plotParams.UsedRamLimit));
+    }
 
     TVector<TProcessedDataProvider> datasetParts;
     if (plotCalcer.HasAdditiveMetric()) {
@@ -10,6 +10,9 @@ int mode_model_sum(int argc, const char* argv[]) {
     TVector<std::pair<TString, double>> modelPathsWithWeights;
     TString outputModelPath;
     ECtrTableMergePolicy ctrMergePolicy = ECtrTableMergePolicy::IntersectingCountersAverage;
+    bool reorderTreesForLocality = false;
+    bool foldIdenticalTrees = false;
+    int threadCount = 1;
 
     auto parser = NLastGetopt::TOpts();
     parser.AddHelpOption();
@@ -33,6 +36,20 @@ int mode_model_sum(int argc, const char* argv[]) {
             GetEnumAllNames<ECtrTableMergePolicy>()))
         .Optional()
         .StoreResult(&ctrMergePolicy);
+    parser.AddLongOption("reorder-trees-for-locality",
+        "Reorder trees of the resulting model so that consecutive trees use the same binarized features."
+        " Predictions stay the same up to floating point summation order")
+        .SetFlag(&reorderTreesForLocality)
+        .NoArgument();
+    parser.AddLongOption("fold-identical-trees",
+        "Fold trees of the resulting model with identical splits into one tree with summed leaf values."
+        " Predictions stay the same up to floating point summation order")
+        .SetFlag(&foldIdenticalTrees)
+        .NoArgument();
+    parser.AddLongOption('T', "thread-count", "Number of threads used to merge intersecting ctr tables")
+        .RequiredArgument("INT")
+        .DefaultValue(threadCount)
+        .StoreResult(&threadCount);
     parser.SetFreeArgsNum(0);
     NLastGetopt::TOptsParseResult parserResult{&parser, argc, argv};
     TVector<THolder<TFullModel>> models;
@@ -43,7 +60,16 @@ int mode_model_sum(int argc, const char* argv[]) {
         modelPtrs.emplace_back(models.back().Get());
         weights.emplace_back(weight);
     }
-    TFullModel result = SumModels(modelPtrs, weights, ctrMergePolicy);
+    // ctr tables are merged while the model is written, so merged tables are not kept in memory together
+    TFullModel result = SumModelsForSerialization(modelPtrs, weights, ctrMergePolicy, threadCount);
+    if (foldIdenticalTrees) {
+        result.ObliviousTrees.FoldIdenticalTrees();
+        result.ObliviousTrees.UpdateMetadata();
+    }
+    if (reorderTreesForLocality) {
+        result.ObliviousTrees.ReorderTreesForFeatureLocality();
+        result.ObliviousTrees.UpdateMetadata();
+    }
     OutputModel(result, outputModelPath);
     return 0;
 }
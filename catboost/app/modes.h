@@ -7,3 +7,4 @@ int mode_metadata(int argc, const char* argv[]);
 int mode_run_worker(int argc, const char* argv[]);
 int mode_roc(int argc, const char* argv[]);
 int mode_model_sum(int argc, const char* argv[]);
+int mode_convert_pool(int argc, const char* argv[]);
@@ -2,6 +2,9 @@ package ai.catboost;
 
 import javax.annotation.Nullable;
 import javax.validation.constraints.NotNull;
+import java.nio.DoubleBuffer;
+import java.nio.FloatBuffer;
+import java.nio.IntBuffer;
 
 class CatBoostJNI {
     final void catBoostHashCatFeature(
@@ -87,4 +90,16 @@ class CatBoostJNI {
             final @NotNull double[] predictions) throws CatBoostError {
         CatBoostJNIImpl.checkCall(CatBoostJNIImpl.catBoostModelPredict(handle, numericFeatures, catFeatureHashes, predictions));
     }
+
+    final void catBoostModelPredict(
+            final long handle,
+            final @Nullable FloatBuffer numericFeatures,
+            final int numericFeatureCount,
+            final @Nullable IntBuffer catFeatureHashes,
+            final int catFeatureCount,
+            final int objectCount,
+            final @NotNull DoubleBuffer predictions) throws CatBoostError {
+        CatBoostJNIImpl.checkCall(CatBoostJNIImpl.catBoostModelPredict(
+                handle, numericFeatures, numericFeatureCount, catFeatureHashes, catFeatureCount, objectCount, predictions));
+    }
 }
@@ -5,6 +5,12 @@ import javax.validation.constraints.NotNull;
 import java.io.ByteArrayOutputStream;
 import java.io.IOException;
 import java.io.InputStream;
+import java.nio.Buffer;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.DoubleBuffer;
+import java.nio.FloatBuffer;
+import java.nio.IntBuffer;
 
 /**
  * CatBoost model, supports basic model application.
@@ -333,6 +339,99 @@ public class CatBoostModel implements AutoCloseable {
         return prediction;
     }
 
+    /**
+     * Apply model to a batch of objects stored in direct buffers, without copying either features or predictions.
+     *
+     * Features are stored in row-major order starting from the current position of each buffer: object `i` has its
+     * numeric features at `[i * numericFeatureCount, (i + 1) * numericFeatureCount)` and its categoric feature
+     * hashes (computed by {@link #hashCategoricalFeature(String)}) at `[i * catFeatureCount, (i + 1) *
+     * catFeatureCount)`. Predictions for object `i` are written to `[i * getPredictionDimension(), (i + 1) *
+     * getPredictionDimension())` starting from the current position of `predictions`. Buffer positions are not
+     * changed.
+     *
+     * All buffers must be direct and use native byte order, see {@link ByteBuffer#allocateDirect(int)} and
+     * {@link ByteOrder#nativeOrder()}.
+     *
+     * @param numericFeatures     Numeric features, may be null if numericFeatureCount is 0.
+     * @param numericFeatureCount Number of numeric features per object.
+     * @param catFeatureHashes    Categoric feature hashes, may be null if catFeatureCount is 0.
+     * @param catFeatureCount     Number of categoric features per object.
+     * @param objectCount         Number of objects.
+     * @param predictions         Model predictions.
+     * @throws CatBoostError In case of error within native library or if buffers are not direct.
+     */
+    public void predict(
+            final @Nullable FloatBuffer numericFeatures,
+            final int numericFeatureCount,
+            final @Nullable IntBuffer catFeatureHashes,
+            final int catFeatureCount,
+            final int objectCount,
+            final @NotNull DoubleBuffer predictions) throws CatBoostError {
+        checkDirectBuffer(numericFeatures, numericFeatures == null ? null : numericFeatures.order(), "numericFeatures");
+        checkDirectBuffer(catFeatureHashes, catFeatureHashes == null ? null : catFeatureHashes.order(), "catFeatureHashes");
+        checkDirectBuffer(predictions, predictions == null ? null : predictions.order(), "predictions");
+        NativeLib.handle().catBoostModelPredict(
+                handle,
+                numericFeatures == null ? null : numericFeatures.slice(),
+                numericFeatureCount,
+                catFeatureHashes == null ? null : catFeatureHashes.slice(),
+                catFeatureCount,
+                objectCount,
+                predictions == null ? null : predictions.slice());
+    }
+
+    /**
+     * Same as {@link #predict(FloatBuffer, int, IntBuffer, int, int, DoubleBuffer)}, but takes byte buffers, which
+     * is convenient when data comes from memory-mapped files or off-heap storage. Byte order of the buffers is
+     * ignored, data is always interpreted in native byte order.
+     *
+     * @param numericFeatures     Numeric features as 32-bit floats, may be null if numericFeatureCount is 0.
+     * @param numericFeatureCount Number of numeric features per object.
+     * @param catFeatureHashes    Categoric feature hashes as 32-bit ints, may be null if catFeatureCount is 0.
+     * @param catFeatureCount     Number of categoric features per object.
+     * @param objectCount         Number of objects.
+     * @param predictions         Model predictions as 64-bit doubles.
+     * @throws CatBoostError In case of error within native library or if buffers are not direct.
+     */
+    public void predict(
+            final @Nullable ByteBuffer numericFeatures,
+            final int numericFeatureCount,
+            final @Nullable ByteBuffer catFeatureHashes,
+            final int catFeatureCount,
+            final int objectCount,
+            final @NotNull ByteBuffer predictions) throws CatBoostError {
+        predict(
+                numericFeatures == null
+                        ? null
+                        : numericFeatures.duplicate().order(ByteOrder.nativeOrder()).asFloatBuffer(),
+                numericFeatureCount,
+                catFeatureHashes == null
+                        ? null
+                        : catFeatureHashes.duplicate().order(ByteOrder.nativeOrder()).asIntBuffer(),
+                catFeatureCount,
+                objectCount,
+                predictions == null
+                        ? null
+                        : predictions.duplicate().order(ByteOrder.nativeOrder()).asDoubleBuffer());
+    }
+
+    private static void checkDirectBuffer(
+            final @Nullable Buffer buffer,
+            final @Nullable ByteOrder order,
+            final @NotNull String name) throws CatBoostError {
+        if (buffer == null) {
+            return;
+        }
+
+        if (!buffer.isDirect()) {
+            throw new CatBoostError("`" + name + "` must be a direct buffer");
+        }
+
+        if (order != ByteOrder.nativeOrder()) {
+            throw new CatBoostError("`" + name + "` must use native byte order");
+        }
+    }
+
     @Override
     protected void finalize() throws Throwable {
         try {
@@ -617,5 +617,86 @@ JNIEXPORT jstring JNICALL Java_ai_catboost_CatBoostJNIImpl_catBoostModelPredict_
     Y_END_JNI_API_CALL();
 }
 
+// Unlike the functions above this one doesn't copy anything: features are read directly from the
+// memory of direct NIO buffers and predictions are written directly into the memory of `jpredictions`.
+JNIEXPORT jstring JNICALL Java_ai_catboost_CatBoostJNIImpl_catBoostModelPredict__JLjava_nio_FloatBuffer_2ILjava_nio_IntBuffer_2IILjava_nio_DoubleBuffer_2
+  (JNIEnv* jenv, jclass, jlong jhandle, jobject jnumericFeatures, jint jnumericFeatureCount, jobject jcatFeatures, jint jcatFeatureCount, jint jobjectCount, jobject jpredictions) {
+    Y_BEGIN_JNI_API_CALL();
+
+    const auto* const model = ToConstFullModelPtr(jhandle);
+    CB_ENSURE(model, "got nullptr model pointer");
+    CB_ENSURE(jnumericFeatureCount >= 0, LabeledOutput(jnumericFeatureCount));
+    CB_ENSURE(jcatFeatureCount >= 0, LabeledOutput(jcatFeatureCount));
+    CB_ENSURE(jobjectCount >= 0, LabeledOutput(jobjectCount));
+
+    const size_t modelPredictionSize = model->ObliviousTrees.ApproxDimension;
+    const size_t minNumericFeatureCount = model->GetNumFloatFeatures();
+    const size_t minCatFeatureCount = model->GetNumCatFeatures();
+    const size_t numericFeatureCount = jnumericFeatureCount;
+    const size_t catFeatureCount = jcatFeatureCount;
+    const size_t documentCount = jobjectCount;
+
+    CB_ENSURE(
+        numericFeatureCount >= minNumericFeatureCount,
+        LabeledOutput(numericFeatureCount, minNumericFeatureCount));
+
+    CB_ENSURE(
+        catFeatureCount >= minCatFeatureCount,
+        LabeledOutput(catFeatureCount, minCatFeatureCount));
+
+    if (documentCount == 0) {
+        return nullptr;
+    }
+
+    const auto getBufferData = [jenv, documentCount](jobject buffer, size_t rowSize, const char* name) -> void* {
+        if (rowSize == 0) {
+            return nullptr;
+        }
+        CB_ENSURE(jenv->IsSameObject(buffer, NULL) == JNI_FALSE, "`" << name << "` buffer is null");
+        void* const data = jenv->GetDirectBufferAddress(buffer);
+        CB_ENSURE(data, "`" << name << "` buffer is not a direct buffer");
+        const auto capacity = jenv->GetDirectBufferCapacity(buffer);
+        CB_ENSURE(
+            capacity >= 0 && static_cast<size_t>(capacity) >= documentCount * rowSize,
+            "`" << name << "` buffer is too small, must be at least document count * row size: "
+            LabeledOutput(capacity, documentCount * rowSize));
+        return data;
+    };
+
+    const auto* const numericFeaturesData = static_cast<const float*>(
+        getBufferData(jnumericFeatures, numericFeatureCount, "numericFeatures"));
+    const auto* const catFeaturesData = static_cast<const int*>(
+        getBufferData(jcatFeatures, catFeatureCount, "catFeatureHashes"));
+    auto* const predictionsData = static_cast<double*>(
+        getBufferData(jpredictions, modelPredictionSize, "predictions"));
+
+    TVector<TConstArrayRef<float>> numericFeatureMatrixRows;
+    if (numericFeatureCount) {
+        numericFeatureMatrixRows.reserve(documentCount);
+        for (size_t i = 0; i < documentCount; ++i) {
+            numericFeatureMatrixRows.push_back(MakeArrayRef(
+                numericFeaturesData + i * numericFeatureCount,
+                numericFeatureCount));
+        }
+    }
+
+    TVector<TConstArrayRef<int>> catFeatureMatrixRows;
+    if (catFeatureCount) {
+        catFeatureMatrixRows.reserve(documentCount);
+        for (size_t i = 0; i < documentCount; ++i) {
+            catFeatureMatrixRows.push_back(MakeArrayRef(
+                catFeaturesData + i * catFeatureCount,
+                catFeatureCount));
+        }
+    }
+
+    model->Calc(
+        numericFeatureMatrixRows,
+        catFeatureMatrixRows,
+        MakeArrayRef(predictionsData, documentCount * modelPredictionSize));
+
+    Y_END_JNI_API_CALL();
+}
+
 #undef Y_BEGIN_JNI_API_CALL
 #undef Y_END_JNI_API_CALL
@@ -6,6 +6,11 @@ import org.junit.Test;
 
 import javax.validation.constraints.NotNull;
 import java.io.*;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.DoubleBuffer;
+import java.nio.FloatBuffer;
+import java.nio.IntBuffer;
 
 import static org.junit.Assert.fail;
 
@@ -832,4 +837,107 @@ public class CatBoostModelTest {
             }
         }
     }
+
+    static FloatBuffer toDirectBuffer(@NotNull float[][] matrix) {
+        final int columnCount = matrix.length == 0 ? 0 : matrix[0].length;
+        final FloatBuffer buffer = ByteBuffer
+                .allocateDirect(4 * matrix.length * columnCount)
+                .order(ByteOrder.nativeOrder())
+                .asFloatBuffer();
+        for (float[] row : matrix) {
+            buffer.put(row);
+        }
+        buffer.rewind();
+        return buffer;
+    }
+
+    static IntBuffer toDirectBuffer(@NotNull int[][] matrix) {
+        final int columnCount = matrix.length == 0 ? 0 : matrix[0].length;
+        final IntBuffer buffer = ByteBuffer
+                .allocateDirect(4 * matrix.length * columnCount)
+                .order(ByteOrder.nativeOrder())
+                .asIntBuffer();
+        for (int[] row : matrix) {
+            buffer.put(row);
+        }
+        buffer.rewind();
+        return buffer;
+    }
+
+    static DoubleBuffer allocateDirectDoubleBuffer(int size) {
+        return ByteBuffer.allocateDirect(8 * size).order(ByteOrder.nativeOrder()).asDoubleBuffer();
+    }
+
+    @Test
+    public void testSuccessfulPredictMultipleDirectBuffers() throws CatBoostError {
+        try(final CatBoostModel model = loadTestModel()) {
+            final float[][] numericFeatures = new float[][]{
+                    {0.5f, 1.5f},
+                    {0.7f, 6.4f},
+                    {-2.0f, -1.0f}};
+            final int[][] catFeatures = new int[][]{
+                    {-805065478, 2136526169, 785836961},
+                    {1982436109, 1400211492, 1076941191},
+                    {-1883343840, -1452597217, 2122455585}};
+            final CatBoostPredictions expected = model.predict(numericFeatures, catFeatures);
+
+            final DoubleBuffer predictions = allocateDirectDoubleBuffer(3 * model.getPredictionDimension());
+            model.predict(toDirectBuffer(numericFeatures), 2, toDirectBuffer(catFeatures), 3, 3, predictions);
+            final double[] actual = new double[3 * model.getPredictionDimension()];
+            predictions.get(actual);
+            assertEqual(expected, new CatBoostPredictions(3, model.getPredictionDimension(), actual));
+        }
+    }
+
+    @Test
+    public void testSuccessfulPredictMultipleDirectByteBuffersWithOffset() throws CatBoostError {
+        try(final CatBoostModel model = loadNumericOnlyTestModel()) {
+            final float[][] numericFeatures = new float[][]{
+                    {0.5f, 1.5f, -2.5f},
+                    {0.7f, 6.4f, 2.4f},
+                    {-2.0f, -1.0f, +6.0f}};
+            final CatBoostPredictions expected = model.predict(numericFeatures, (String[][]) null);
+
+            final ByteBuffer features = ByteBuffer.allocateDirect(4 * (1 + 9)).order(ByteOrder.nativeOrder());
+            features.putFloat(100.f);
+            for (float[] row : numericFeatures) {
+                for (float value : row) {
+                    features.putFloat(value);
+                }
+            }
+            features.position(4);
+
+            final ByteBuffer predictions = ByteBuffer.allocateDirect(8 * 3 * model.getPredictionDimension());
+            model.predict(features, 3, null, 0, 3, predictions);
+            TestCase.assertEquals(4, features.position());
+
+            final double[] actual = new double[3 * model.getPredictionDimension()];
+            predictions.order(ByteOrder.nativeOrder()).asDoubleBuffer().get(actual);
+            assertEqual(expected, new CatBoostPredictions(3, model.getPredictionDimension(), actual));
+        }
+    }
+
+    @Test
+    public void testFailPredictMultipleNonDirectBuffer() throws CatBoostError {
+        try(final CatBoostModel model = loadNumericOnlyTestModel()) {
+            try {
+                final FloatBuffer features = FloatBuffer.wrap(new float[]{0.5f, 1.5f, -2.5f});
+                model.predict(features, 3, null, 0, 1, allocateDirectDoubleBuffer(1));
+                fail();
+            } catch (CatBoostError e) {
+            }
+        }
+    }
+
+    @Test
+    public void testFailPredictMultipleInsufficientDirectBuffer() throws CatBoostError {
+        try(final CatBoostModel model = loadNumericOnlyTestModel()) {
+            try {
+                final FloatBuffer features = toDirectBuffer(new float[][]{{0.5f, 1.5f, -2.5f}});
+                model.predict(features, 3, null, 0, 2, allocateDirectDoubleBuffer(2));
+                fail();
+            } catch (CatBoostError e) {
+            }
+        }
+    }
 }
@@ -40,6 +40,7 @@ void CalcApproxDeltaIterationMulti(
     const IDerCalcer& error,
     int iteration,
     float l2Regularizer,
+    NPar::TLocalExecutor* localExecutor,
     TVector<TSumMulti>* buckets,
     TVector<TVector<double>>* resArr,
     TVector<TVector<double>>* sumLeafValues
@@ -50,7 +51,7 @@ void CalcApproxDeltaIterationMulti(
     const int approxDimension = resArr->ysize();
     const int leafCount = buckets->ysize();
     TVector<TVector<double>> curLeafValues(approxDimension, TVector<double>(leafCount));
-    CalcMixedModelMulti(CalcModel, *buckets, l2Regularizer, bt.BodySumWeight, bt.BodyFinish, &curLeafValues);
+    CalcMixedModelMulti(CalcModel, *buckets, l2Regularizer, bt.BodySumWeight, bt.BodyFinish, localExecutor, &curLeafValues);
     if (sumLeafValues != nullptr) {
         AddElementwise(curLeafValues, sumLeafValues);
     }
@@ -59,8 +60,7 @@ void CalcApproxDeltaIterationMulti(
     // compute tail
     TVector<double> curApprox(approxDimension);
     TVector<double> avrg(approxDimension);
-    TVector<double> bufferDer(approxDimension);
-    THessianInfo bufferDer2(approxDimension, error.GetHessianType());
+    TMultiDersBuffers buffers;
     for (int z = bt.BodyFinish; z < bt.TailFinish; ++z) {
         for (int dim = 0; dim < approxDimension; ++dim) {
             curApprox[dim] = UpdateApprox(error.GetIsExpApprox(), bt.Approx[dim][z], (*resArr)[dim][z]);
@@ -68,7 +68,7 @@ void CalcApproxDeltaIterationMulti(
 
         TSumMulti& bucket = (*buckets)[indices[z]];
         AddSampleToBucket(error, curApprox, target[z], weight.empty() ? 1 : weight[z], iteration,
-                          &bufferDer, &bufferDer2, &bucket);
+                          &buffers, &bucket);
 
         CalcModel(bucket, l2Regularizer, bt.BodySumWeight, bt.BodyFinish, &avrg);
         ExpApproxIf(error.GetIsExpApprox(), &avrg);
@@ -102,12 +102,12 @@ void CalcApproxDeltaMulti(
         if (estimationMethod == ELeavesEstimation::Newton) {
             CalcApproxDeltaIterationMulti(CalcModelNewtonMulti, AddSampleToBucketNewtonMulti,
                                           indices, ff.LearnTarget, ff.GetLearnWeights(), bt, error, it, l2Regularizer,
-                                          &buckets, approxDelta, sumLeafValues);
+                                          ctx->LocalExecutor, &buckets, approxDelta, sumLeafValues);
         } else {
             Y_ASSERT(estimationMethod == ELeavesEstimation::Gradient);
             CalcApproxDeltaIterationMulti(CalcModelGradientMulti, AddSampleToBucketGradientMulti,
                                           indices, ff.LearnTarget, ff.GetLearnWeights(), bt, error, it, l2Regularizer,
-                                          &buckets, approxDelta, sumLeafValues);
+                                          ctx->LocalExecutor, &buckets, approxDelta, sumLeafValues);
         }
     }
 }
@@ -123,6 +123,7 @@ void CalcLeafValuesIterationMulti(
     int iteration,
     float l2Regularizer,
     double sumWeight,
+    NPar::TLocalExecutor* localExecutor,
     TVector<TSumMulti>* buckets,
     TVector<TVector<double>>* approx
 ) {
@@ -133,7 +134,7 @@ void CalcLeafValuesIterationMulti(
     UpdateBucketsMulti(AddSampleToBucket, indices, target, weight, /*approx*/ TVector<TVector<double>>(), *approx, error, learnSampleCount, iteration, buckets);
 
     TVector<TVector<double>> curLeafValues(approxDimension, TVector<double>(leafCount));
-    CalcMixedModelMulti(CalcModel, *buckets, l2Regularizer, sumWeight, learnSampleCount, &curLeafValues);
+    CalcMixedModelMulti(CalcModel, *buckets, l2Regularizer, sumWeight, learnSampleCount, localExecutor, &curLeafValues);
 
     UpdateApproxDeltasMulti(error.GetIsExpApprox(), indices, learnSampleCount, &curLeafValues, approx);
 }
@@ -160,7 +161,7 @@ void CalcLeafValuesMulti(
     const ELeavesEstimation estimationMethod = treeLearnerOptions.LeavesEstimationMethod;
     const float l2Regularizer = treeLearnerOptions.L2Reg;
     leafValues->assign(approxDimension, TVector<double>(leafCount));
-    TVector<double> avrg(approxDimension);
+    TVector<TVector<double>> curLeafValues(approxDimension, TVector<double>(leafCount));
     for (int it = 0; it < gradientIterations; ++it) {
         for (auto& bucket : buckets) {
             bucket.SetZeroDers();
@@ -168,23 +169,17 @@ void CalcLeafValuesMulti(
         if (estimationMethod == ELeavesEstimation::Newton) {
             CalcLeafValuesIterationMulti(CalcModelNewtonMulti, AddSampleToBucketNewtonMulti,
                                          indices, ff.LearnTarget, ff.GetLearnWeights(), error, it, l2Regularizer,
-                                         ff.GetSumWeight(), &buckets, &approx);
+                                         ff.GetSumWeight(), ctx->LocalExecutor, &buckets, &approx);
+            CalcMixedModelMulti(CalcModelNewtonMulti, buckets, l2Regularizer, bt.BodySumWeight, bt.TailFinish,
+                                ctx->LocalExecutor, &curLeafValues);
         } else {
             Y_ASSERT(estimationMethod == ELeavesEstimation::Gradient);
             CalcLeafValuesIterationMulti(CalcModelGradientMulti, AddSampleToBucketGradientMulti,
                                          indices, ff.LearnTarget, ff.GetLearnWeights(), error, it, l2Regularizer,
-                                         ff.GetSumWeight(), &buckets, &approx);
-        }
-
-        for (int leaf = 0; leaf < leafCount; ++leaf) {
-            if (estimationMethod == ELeavesEstimation::Newton) {
-                CalcModelNewtonMulti(buckets[leaf], l2Regularizer, bt.BodySumWeight, bt.TailFinish, &avrg);
-            } else {
-                CalcModelGradientMulti(buckets[leaf], l2Regularizer, bt.BodySumWeight, bt.TailFinish, &avrg);
-            }
-            for (int dim = 0; dim < approxDimension; ++dim) {
-                (*leafValues)[dim][leaf] += avrg[dim];
-            }
+                                         ff.GetSumWeight(), ctx->LocalExecutor, &buckets, &approx);
+            CalcMixedModelMulti(CalcModelGradientMulti, buckets, l2Regularizer, bt.BodySumWeight, bt.TailFinish,
+                                ctx->LocalExecutor, &curLeafValues);
         }
+        AddElementwise(curLeafValues, leafValues);
     }
 }
@@ -15,34 +15,34 @@ void UpdateApproxDeltasMulti(
 
 inline void AddSampleToBucketNewtonMulti(
     const IDerCalcer& error,
-    const TVector<double>& approx,
+    TConstArrayRef<double> approx,
     float target,
     double weight,
     int,
-    TVector<double>* curDer,
-    THessianInfo* curDer2,
+    TMultiDersBuffers* buffers,
     TSumMulti* bucket
 ) {
-    Y_ASSERT(curDer != nullptr && curDer2 != nullptr);
-    error.CalcDersMulti(approx, target, weight, curDer, curDer2);
-    bucket->AddDerDer2(*curDer, *curDer2);
+    error.AddDersMulti(approx, target, weight, bucket->SumDer, bucket->SumDer2.Data, buffers);
 }
 
 inline void AddSampleToBucketGradientMulti(
     const IDerCalcer& error,
-    const TVector<double>& approx,
+    TConstArrayRef<double> approx,
     float target,
     double weight,
     int iteration,
-    TVector<double>* curDer,
-    THessianInfo* /*curDer2*/,
+    TMultiDersBuffers* buffers,
     TSumMulti* bucket
 ) {
-    Y_ASSERT(curDer != nullptr);
-    error.CalcDersMulti(approx, target, weight, curDer, nullptr);
-    bucket->AddDerWeight(*curDer, weight, iteration);
+    error.AddDersMulti(approx, target, weight, bucket->SumDer, /*sumDer2*/ {}, buffers);
+    if (iteration == 0) {
+        bucket->SumWeights += weight;
+    }
 }
 
+// Number of objects whose approxes are gathered together before their derivatives are added to buckets.
+constexpr int MultiDersBlockSize = 64;
+
 template <typename TAddSampleToBucket>
 void UpdateBucketsMulti(
     TAddSampleToBucket AddSampleToBucket,
@@ -58,19 +58,34 @@ void UpdateBucketsMulti(
 ) {
     const int approxDimension = resArr.ysize();
     Y_ASSERT(approxDimension > 0);
-    TVector<double> curApprox(approxDimension);
-    TVector<double> bufferDer(approxDimension);
-    THessianInfo bufferDer2(approxDimension, error.GetHessianType());
-    for (int z = 0; z < sampleCount; ++z) {
+    const bool isExpApprox = error.GetIsExpApprox();
+    TVector<double> blockApprox; // [objectIdxInBlock][dim]
+    blockApprox.yresize(MultiDersBlockSize * approxDimension);
+    TMultiDersBuffers buffers;
+    for (int blockStart = 0; blockStart < sampleCount; blockStart += MultiDersBlockSize) {
+        const int blockEnd = Min(blockStart + MultiDersBlockSize, sampleCount);
         for (int dim = 0; dim < approxDimension; ++dim) {
-            curApprox[dim] = approx.empty() ? resArr[dim][z] : UpdateApprox(error.GetIsExpApprox(), approx[dim][z], resArr[dim][z]);
+            const double* resArrData = resArr[dim].data();
+            double* blockApproxData = blockApprox.data() + dim;
+            if (approx.empty()) {
+                for (int z = blockStart; z < blockEnd; ++z) {
+                    blockApproxData[(z - blockStart) * approxDimension] = resArrData[z];
+                }
+            } else {
+                const double* approxData = approx[dim].data();
+                for (int z = blockStart; z < blockEnd; ++z) {
+                    blockApproxData[(z - blockStart) * approxDimension] = UpdateApprox(isExpApprox, approxData[z], resArrData[z]);
+                }
+            }
+        }
+        for (int z = blockStart; z < blockEnd; ++z) {
+            AddSampleToBucket(error, MakeArrayRef(blockApprox.data() + (z - blockStart) * approxDimension, approxDimension),
+                              target[z], weight.empty() ? 1 : weight[z], iteration, &buffers, &(*buckets)[indices[z]]);
         }
-        TSumMulti& bucket = (*buckets)[indices[z]];
-        AddSampleToBucket(error, curApprox, target[z], weight.empty() ? 1 : weight[z], iteration,
-                          &bufferDer, &bufferDer2, &bucket);
     }
 }
 
+// Leaf systems are independent, so they are solved in parallel.
 template <typename TCalcModel>
 void CalcMixedModelMulti(
     TCalcModel CalcModel,
@@ -78,16 +93,17 @@ void CalcMixedModelMulti(
     float l2Regularizer,
     double sumAllWeights,
     int docCount,
+    NPar::TLocalExecutor* localExecutor,
     TVector<TVector<double>>* curLeafValues
 ) {
     const int leafCount = buckets.ysize();
-    TVector<double> avrg;
-    for (int leaf = 0; leaf < leafCount; ++leaf) {
+    NPar::ParallelFor(*localExecutor, 0, leafCount, [&](int leaf) {
+        TVector<double> avrg;
         CalcModel(buckets[leaf], l2Regularizer, sumAllWeights, docCount, &avrg);
         for (int dim = 0; dim < avrg.ysize(); ++dim) {
             (*curLeafValues)[dim][leaf] = avrg[dim];
         }
-    }
+    });
 }
 
 void CalcApproxDeltaMulti(
@@ -32,11 +32,21 @@ TVector<TBucketStats, TPoolAllocator>& TBucketStatsCache::GetStats(const TSplitC
 
 void TBucketStatsCache::GarbageCollect() {
     if (MemoryPool->MemoryWaste() > InitialSize) { // limit memory overhead
-        Stats.clear();
+        Clear();
+    }
+}
+
+void TBucketStatsCache::Clear() {
+    Stats.clear();
+    if (MemoryPool) {
         MemoryPool->Clear();
     }
 }
 
+ui64 TBucketStatsCache::GetMemoryUsage() const {
+    return MemoryPool ? MemoryPool->MemoryAllocated() + MemoryPool->MemoryWaste() : 0;
+}
+
 TVector<TBucketStats> TBucketStatsCache::GetStatsInUse(int segmentCount,
     int segmentSize,
     int statsCount,
@@ -215,9 +225,16 @@ static int GetMaxTailFinish(const TVector<TFold>& folds, int bodyTailIdx) {
     return maxTailFinish;
 }
 
-void TCalcScoreFold::Create(const TVector<TFold>& folds, bool isPairwiseScoring, int defaultCalcStatsObjBlockSize, float sampleRate) {
-    BernoulliSampleRate = sampleRate;
-    Y_ASSERT(BernoulliSampleRate > 0.0f && BernoulliSampleRate <= 1.0f);
+void TCalcScoreFold::Create(
+    const TVector<TFold>& folds,
+    bool isPairwiseScoring,
+    int defaultCalcStatsObjBlockSize,
+    float sampleRate,
+    bool isSampledBySampleWeights
+) {
+    SampleRate = sampleRate;
+    Y_ASSERT(SampleRate > 0.0f && SampleRate <= 1.0f);
+    IsSampledBySampleWeights = isSampledBySampleWeights;
     DocCount = folds[0].GetLearnSampleCount();
     Y_ASSERT(DocCount > 0);
     Indices.yresize(DocCount);
@@ -370,7 +387,7 @@ void TCalcScoreFold::SelectSmallestSplitSide(int curDepth, const TCalcScoreFold&
 }
 
 void TCalcScoreFold::Sample(const TFold& fold, const TVector<TIndexType>& indices, TRestorableFastRng64* rand, NPar::TLocalExecutor* localExecutor) {
-    SetSampledControl(indices.ysize(), rand);
+    SetSampledControl(fold, indices.ysize(), rand);
 
     TVectorSlicing srcBlocks;
     TVectorSlicing dstBlocks;
@@ -400,8 +417,8 @@ void TCalcScoreFold::Sample(const TFold& fold, const TVector<TIndexType>& indice
         SelectBlockFromFold(fold, srcBlock, dstBlock);
     }, 0, blockCount, NPar::TLocalExecutor::WAIT_COMPLETE);
     SetPermutationBlockSizeAndCalcStatsRanges(
-        (BernoulliSampleRate == 1.0f || IsPairwiseScoring) ? fold.PermutationBlockSize : FoldPermutationBlockSizeNotSet,
-        (BernoulliSampleRate == 1.0f || IsPairwiseScoring) ? DocCount : FoldPermutationBlockSizeNotSet
+        (SampleRate == 1.0f || IsPairwiseScoring) ? fold.PermutationBlockSize : FoldPermutationBlockSizeNotSet,
+        (SampleRate == 1.0f || IsPairwiseScoring) ? DocCount : FoldPermutationBlockSizeNotSet
     );
 }
 
@@ -413,7 +430,7 @@ void TCalcScoreFold::UpdateIndices(const TVector<TIndexType>& indices, NPar::TLo
     srcBlocks.Create(blockParams);
 
     TVectorSlicing dstBlocks;
-    if (BernoulliSampleRate < 1.0f && !IsPairwiseScoring) {
+    if (SampleRate < 1.0f && !IsPairwiseScoring) {
         dstBlocks.CreateByControl(blockParams, Control, localExecutor);
     } else {
         dstBlocks = srcBlocks;
@@ -437,6 +454,31 @@ int TCalcScoreFold::GetDocCount() const {
     return DocCount;
 }
 
+template <typename TData>
+static ui64 GetUnsizedVectorMemoryUsage(const TVector<TData>& data) {
+    return data.capacity() * sizeof(TData);
+}
+
+ui64 TCalcScoreFold::GetMemoryUsage() const {
+    ui64 result = GetUnsizedVectorMemoryUsage(Indices)
+        + GetUnsizedVectorMemoryUsage(IndexInFold)
+        + GetUnsizedVectorMemoryUsage(LearnWeights)
+        + GetUnsizedVectorMemoryUsage(SampleWeights)
+        + GetUnsizedVectorMemoryUsage(LearnQueriesInfo)
+        + GetUnsizedVectorMemoryUsage(Control);
+    for (const auto& bodyTail : BodyTailArr) {
+        for (const auto& derivatives : bodyTail.WeightedDerivatives) {
+            result += GetUnsizedVectorMemoryUsage(derivatives);
+        }
+        for (const auto& derivatives : bodyTail.SampleWeightedDerivatives) {
+            result += GetUnsizedVectorMemoryUsage(derivatives);
+        }
+        result += GetUnsizedVectorMemoryUsage(bodyTail.PairwiseWeights);
+        result += GetUnsizedVectorMemoryUsage(bodyTail.SamplePairwiseWeights);
+    }
+    return result;
+}
+
 int TCalcScoreFold::GetBodyTailCount() const {
     return BodyTailCount;
 }
@@ -485,13 +527,20 @@ void TCalcScoreFold::SetSmallestSideControl(int curDepth, int docCount, const TU
     }
 }
 
-void TCalcScoreFold::SetSampledControl(int docCount, TRestorableFastRng64* rand) {
-    if (BernoulliSampleRate == 1.0f || IsPairwiseScoring) {
+void TCalcScoreFold::SetSampledControl(const TFold& fold, int docCount, TRestorableFastRng64* rand) {
+    if (SampleRate == 1.0f || IsPairwiseScoring) {
         Fill(Control.begin(), Control.end(), true);
         return;
     }
+    if (IsSampledBySampleWeights) {
+        const float* sampleWeightsData = GetDataPtr(fold.SampleWeights);
+        for (int docIdx = 0; docIdx < docCount; ++docIdx) {
+            Control[docIdx] = sampleWeightsData[docIdx] != 0.0f;
+        }
+        return;
+    }
     for (int docIdx = 0; docIdx < docCount; ++docIdx) {
-        Control[docIdx] = rand->GenRandReal1() < BernoulliSampleRate;
+        Control[docIdx] = rand->GenRandReal1() < SampleRate;
     }
 }
 
@@ -51,6 +51,19 @@ static inline float GetBernoulliSampleRate(const NCatboostOptions::TOption<NCatb
     return 1.0f;
 }
 
+// expected fraction of objects taken into TCalcScoreFold by sampling bootstraps
+static inline float GetSampleRate(const NCatboostOptions::TOption<NCatboostOptions::TBootstrapConfig>& samplingConfig) {
+    if (samplingConfig->GetBootstrapType() == EBootstrapType::MVS) {
+        return samplingConfig->GetTakenFraction();
+    }
+    return GetBernoulliSampleRate(samplingConfig);
+}
+
+// objects are selected by bootstrap itself (zero sample weight means object is not taken)
+static inline bool IsSampledBySampleWeights(const NCatboostOptions::TOption<NCatboostOptions::TBootstrapConfig>& samplingConfig) {
+    return samplingConfig->GetBootstrapType() == EBootstrapType::MVS;
+}
+
 static inline int GetMaxBodyTailCount(const TVector<TFold>& folds) {
     int maxBodyTailCount = 0;
     for (const auto& fold : folds) {
@@ -119,6 +132,8 @@ struct TBucketStatsCache {
     }
     TVector<TBucketStats, TPoolAllocator>& GetStats(const TSplitCandidate& split, int statsCount, bool* areStatsDirty);
     void GarbageCollect();
+    void Clear();
+    ui64 GetMemoryUsage() const;
     static TVector<TBucketStats> GetStatsInUse(int segmentCount,
         int segmentSize,
         int statsCount,
@@ -215,11 +230,17 @@ struct TCalcScoreFold {
     int CtrDataPermutationBlockSize = FoldPermutationBlockSizeNotSet;
 
 
-    void Create(const TVector<TFold>& folds, bool isPairwiseScoring, int defaultCalcStatsObjBlockSize, float sampleRate = 1.0f);
+    void Create(
+        const TVector<TFold>& folds,
+        bool isPairwiseScoring,
+        int defaultCalcStatsObjBlockSize,
+        float sampleRate = 1.0f,
+        bool isSampledBySampleWeights = false);
     void SelectSmallestSplitSide(int curDepth, const TCalcScoreFold& fold, NPar::TLocalExecutor* localExecutor);
     void Sample(const TFold& fold, const TVector<TIndexType>& indices, TRestorableFastRng64* rand, NPar::TLocalExecutor* localExecutor);
     void UpdateIndices(const TVector<TIndexType>& indices, NPar::TLocalExecutor* localExecutor);
     int GetDocCount() const;
+    ui64 GetMemoryUsage() const;
     int GetBodyTailCount() const;
     int GetApproxDimension() const;
     const TVector<float>& GetLearnWeights() const { return LearnWeights; }
@@ -239,7 +260,7 @@ private:
     template <typename TFoldType>
     void SelectBlockFromFold(const TFoldType& fold, TSlice srcBlock, TSlice dstBlock);
     void SetSmallestSideControl(int curDepth, int docCount, const TUnsizedVector<TIndexType>& indices, NPar::TLocalExecutor* localExecutor);
-    void SetSampledControl(int docCount, TRestorableFastRng64* rand);
+    void SetSampledControl(const TFold& fold, int docCount, TRestorableFastRng64* rand);
 
     void CreateBlocksAndUpdateQueriesInfoByControl(
         NPar::TLocalExecutor* localExecutor,
@@ -257,7 +278,8 @@ private:
     int DocCount;
     int BodyTailCount;
     int ApproxDimension;
-    float BernoulliSampleRate;
+    float SampleRate;
+    bool IsSampledBySampleWeights;
     bool HasPairwiseWeights;
     bool IsPairwiseScoring;
     int DefaultCalcStatsObjBlockSize;
@@ -14,11 +14,19 @@
 #include <library/fast_exp/fast_exp.h>
 #include <library/threading/local_executor/local_executor.h>
 
+#include <util/generic/array_ref.h>
 #include <util/generic/vector.h>
 #include <util/generic/ymath.h>
 #include <util/system/yassert.h>
 #include <util/string/iterator.h>
 
+// Per-object buffers of IDerCalcer::AddDersMulti, kept by the caller between objects.
+struct TMultiDersBuffers {
+    TVector<double> Approx;
+    TVector<double> Der;
+    THessianInfo Der2;
+};
+
 class IDerCalcer {
 public:
     explicit IDerCalcer(
@@ -88,6 +96,36 @@ public:
         CB_ENSURE(false, "Not implemented");
     }
 
+    /* Adds derivatives of an object to derivative sums of its leaf, sumDer2 uses THessianInfo::Data layout
+     * and is not updated if empty. Implementations may avoid per-object vectors, buffers are reused between calls.
+     */
+    virtual void AddDersMulti(
+        TConstArrayRef<double> approx,
+        float target,
+        float weight,
+        TArrayRef<double> sumDer,
+        TArrayRef<double> sumDer2,
+        TMultiDersBuffers* buffers
+    ) const {
+        const int approxDimension = approx.size();
+        buffers->Approx.assign(approx.begin(), approx.end());
+        buffers->Der.resize(approxDimension);
+        THessianInfo* der2 = nullptr;
+        if (!sumDer2.empty()) {
+            if (buffers->Der2.Data.empty()) {
+                buffers->Der2 = THessianInfo(approxDimension, HessianType);
+            }
+            der2 = &buffers->Der2;
+        }
+        CalcDersMulti(buffers->Approx, target, weight, &buffers->Der, der2);
+        for (int dim = 0; dim < approxDimension; ++dim) {
+            sumDer[dim] += buffers->Der[dim];
+        }
+        for (size_t idx = 0; idx < sumDer2.size(); ++idx) {
+            sumDer2[idx] += der2->Data[idx];
+        }
+    }
+
     virtual void CalcDersForQueries(
         int /*queryStartIndex*/,
         int /*queryEndIndex*/,
@@ -396,6 +434,39 @@ public:
             }
         }
     }
+
+    // Same values as CalcDersMulti, hessian of the object is added to sumDer2 row by row without a temporary copy.
+    void AddDersMulti(
+        TConstArrayRef<double> approx,
+        float target,
+        float weight,
+        TArrayRef<double> sumDer,
+        TArrayRef<double> sumDer2,
+        TMultiDersBuffers* buffers
+    ) const override {
+        const int approxDimension = approx.size();
+        buffers->Der.yresize(approxDimension);
+        CalcSoftmax(approx, &buffers->Der);
+        const double* softmax = buffers->Der.data();
+        const int targetClass = static_cast<int>(target);
+        const double objectWeight = weight;
+
+        for (int dim = 0; dim < approxDimension; ++dim) {
+            const double der = dim == targetClass ? -softmax[dim] + 1 : -softmax[dim];
+            sumDer[dim] += der * objectWeight;
+        }
+        if (!sumDer2.empty()) {
+            Y_ASSERT(sumDer2.size() == static_cast<size_t>(TSymmetricHessian::CalcInternalDer2DataSize(approxDimension)));
+            double* sumDer2Data = sumDer2.data();
+            for (int dimY = 0; dimY < approxDimension; ++dimY) {
+                const double softmaxY = softmax[dimY];
+                *sumDer2Data++ += softmaxY * (softmaxY - 1) * objectWeight;
+                for (int dimX = dimY + 1; dimX < approxDimension; ++dimX) {
+                    *sumDer2Data++ += softmaxY * softmax[dimX] * objectWeight;
+                }
+            }
+        }
+    }
 };
 
 class TMultiClassOneVsAllError final : public IDerCalcer {
@@ -443,6 +514,31 @@ public:
             }
         }
     }
+
+    void AddDersMulti(
+        TConstArrayRef<double> approx,
+        float target,
+        float weight,
+        TArrayRef<double> sumDer,
+        TArrayRef<double> sumDer2,
+        TMultiDersBuffers* buffers
+    ) const override {
+        const int approxDimension = approx.size();
+        TVector<double>* buffer = &buffers->Approx;
+        buffer->assign(approx.begin(), approx.end());
+        FastExpInplace(buffer->data(), approxDimension);
+        const int targetClass = static_cast<int>(target);
+        const double objectWeight = weight;
+
+        for (int dim = 0; dim < approxDimension; ++dim) {
+            const double prob = (*buffer)[dim] / (1 + (*buffer)[dim]);
+            const double der = dim == targetClass ? -prob + 1 : -prob;
+            sumDer[dim] += der * objectWeight;
+            if (!sumDer2.empty()) {
+                sumDer2[dim] += -prob * (1 - prob) * objectWeight;
+            }
+        }
+    }
 };
 
 class TPairLogitError final : public IDerCalcer {
@@ -3,11 +3,13 @@
 #include "approx_updater_helpers.h"
 
 #include <catboost/libs/data_types/groupid.h>
+#include <catboost/libs/helpers/memory_budget.h>
 #include <catboost/libs/helpers/permutation.h>
 #include <catboost/libs/helpers/query_info_helper.h>
 #include <catboost/libs/helpers/restorable_rng.h>
 
 #include <util/generic/cast.h>
+#include <util/generic/xrange.h>
 
 
 using namespace NCB;
@@ -263,6 +265,44 @@ void TFold::DropEmptyCTRs() {
     }
 }
 
+ui64 TFold::GetMemoryUsage() const {
+    ui64 result = 0;
+    for (const auto& bodyTail : BodyTailArr) {
+        result += GetVectorMemoryUsage(bodyTail.Approx);
+        result += GetVectorMemoryUsage(bodyTail.CompactApprox);
+        result += GetVectorMemoryUsage(bodyTail.WeightedDerivatives);
+        result += GetVectorMemoryUsage(bodyTail.SampleWeightedDerivatives);
+        result += GetVectorMemoryUsage(bodyTail.PairwiseWeights);
+        result += GetVectorMemoryUsage(bodyTail.SamplePairwiseWeights);
+    }
+    result += GetVectorMemoryUsage(LearnTarget);
+    result += GetVectorMemoryUsage(SampleWeights);
+    result += GetVectorMemoryUsage(LearnTargetClass);
+    result += GetVectorMemoryUsage(LearnWeights);
+    result += GetVectorMemoryUsage(LearnQueriesInfo);
+    // permutations for features and non-features data
+    result += 2 * sizeof(ui32) * (ui64)GetLearnSampleCount();
+    return result;
+}
+
+static ui64 GetOnlineCTRsMemoryUsage(const TOnlineCTRHash& onlineCtrs) {
+    ui64 result = 0;
+    for (const auto& projCtr : onlineCtrs) {
+        for (const auto& ctr : projCtr.second.Feature) {
+            for (auto y : xrange(ctr.GetYSize())) {
+                for (auto x : xrange(ctr.GetXSize())) {
+                    result += GetVectorMemoryUsage(ctr[y][x]);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+ui64 TFold::GetOnlineCTRsMemoryUsage() const {
+    return ::GetOnlineCTRsMemoryUsage(OnlineSingleCtrs) + ::GetOnlineCTRsMemoryUsage(OnlineCTR);
+}
+
 void TFold::AssignTarget(TMaybeData<TConstArrayRef<float>> target, const TVector<TTargetClassifier>& targetClassifiers) {
     ui32 learnSampleCount = GetLearnSampleCount();
     if (target.Defined()) {
@@ -283,11 +323,35 @@ void TFold::AssignTarget(TMaybeData<TConstArrayRef<float>> target, const TVector
     }
 }
 
+template <class TSrc, class TDst>
+static void CopyApprox(const TVector<TVector<TSrc>>& src, TVector<TVector<TDst>>* dst) {
+    dst->resize(src.size());
+    for (auto dim : xrange(src.size())) {
+        (*dst)[dim].assign(src[dim].begin(), src[dim].end());
+    }
+}
+
+// outer dimension of src is kept so that GetApproxDimension works for both states of fold
+template <class TSrc, class TDst>
+static void MoveApprox(TVector<TVector<TSrc>>* src, TVector<TVector<TDst>>* dst) {
+    CopyApprox(*src, dst);
+    for (auto& dimensionApprox : *src) {
+        dimensionApprox = TVector<TSrc>();
+    }
+}
+
 void TFold::SaveApproxes(IOutputStream* s) const {
     const ui64 bodyTailCount = BodyTailArr.size();
     ::Save(s, bodyTailCount);
     for (ui64 i = 0; i < bodyTailCount; ++i) {
-        ::Save(s, BodyTailArr[i].Approx);
+        if (IsCompactFlag) {
+            // snapshot format does not depend on approxes precision
+            TVector<TVector<double>> approx;
+            CopyApprox(BodyTailArr[i].CompactApprox, &approx);
+            ::Save(s, approx);
+        } else {
+            ::Save(s, BodyTailArr[i].Approx);
+        }
     }
 }
 
@@ -297,5 +361,48 @@ void TFold::LoadApproxes(IInputStream* s) {
     CB_ENSURE(bodyTailCount == BodyTailArr.size());
     for (ui64 i = 0; i < bodyTailCount; ++i) {
         ::Load(s, BodyTailArr[i].Approx);
+        if (IsCompactFlag) {
+            MoveApprox(&BodyTailArr[i].Approx, &BodyTailArr[i].CompactApprox);
+        }
+    }
+}
+
+static void ReleaseDerivatives(TFold::TBodyTail* bt) {
+    for (auto& dimensionDerivatives : bt->WeightedDerivatives) {
+        dimensionDerivatives = TVector<double>();
+    }
+    for (auto& dimensionDerivatives : bt->SampleWeightedDerivatives) {
+        dimensionDerivatives = TVector<double>();
+    }
+}
+
+void TFold::Compact(NPar::TLocalExecutor* localExecutor) {
+    if (IsCompactFlag) {
+        return;
     }
+    localExecutor->ExecRange([&] (int bodyTailIdx) {
+        TBodyTail& bt = BodyTailArr[bodyTailIdx];
+        MoveApprox(&bt.Approx, &bt.CompactApprox);
+        ReleaseDerivatives(&bt);
+    }, 0, BodyTailArr.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+    IsCompactFlag = true;
+}
+
+void TFold::Expand(bool allocateDerivatives, NPar::TLocalExecutor* localExecutor) {
+    localExecutor->ExecRange([&] (int bodyTailIdx) {
+        TBodyTail& bt = BodyTailArr[bodyTailIdx];
+        if (IsCompactFlag) {
+            MoveApprox(&bt.CompactApprox, &bt.Approx);
+        }
+        if (allocateDerivatives) {
+            // zero filled as in freshly built fold, not all elements are overwritten by derivatives calculation
+            for (auto& dimensionDerivatives : bt.WeightedDerivatives) {
+                dimensionDerivatives.resize(bt.TailFinish);
+            }
+            for (auto& dimensionDerivatives : bt.SampleWeightedDerivatives) {
+                dimensionDerivatives.resize(bt.TailFinish);
+            }
+        }
+    }, 0, BodyTailArr.ysize(), NPar::TLocalExecutor::WAIT_COMPLETE);
+    IsCompactFlag = false;
 }
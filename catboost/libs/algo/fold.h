@@ -40,6 +40,8 @@ struct TFold {
         }
 
         TVector<TVector<double>> Approx;  // [dim][]
+        // single precision copy of Approx, Approx[dim] are empty while fold is compact
+        TVector<TVector<float>> CompactApprox;  // [dim][]
         TVector<TVector<double>> WeightedDerivatives;  // [dim][]
         // TODO(annaveronika): make a single vector<vector> for all BodyTail
         TVector<TVector<double>> SampleWeightedDerivatives;  // [dim][]
@@ -125,11 +127,29 @@ struct TFold {
         }
     }
 
+    // dropped online CTRs are recalculated when they are needed again
+    void DropOnlineCTRs() {
+        OnlineSingleCtrs.clear();
+        OnlineCTR.clear();
+    }
+
+    // approximate size of approxes, derivatives, targets and weights in bytes
+    ui64 GetMemoryUsage() const;
+    ui64 GetOnlineCTRsMemoryUsage() const;
+
     const TVector<float>& GetLearnWeights() const { return LearnWeights; }
 
     void SaveApproxes(IOutputStream* s) const;
     void LoadApproxes(IInputStream* s);
 
+    /* Learning folds can be kept compact between iterations to reduce memory usage: approxes of all
+     * body tails are rounded to float and derivatives buffers are released.
+     * All calculations are still done in double precision on expanded fold.
+     */
+    void Compact(NPar::TLocalExecutor* localExecutor);
+    void Expand(bool allocateDerivatives, NPar::TLocalExecutor* localExecutor);
+    bool IsCompact() const { return IsCompactFlag; }
+
     static TFold BuildDynamicFold(
         const NCB::TTrainingForCPUDataProvider& learnData,
         const TVector<TTargetClassifier>& targetClassifiers,
@@ -169,6 +189,8 @@ private:
     TOnlineCTRHash OnlineSingleCtrs;
     TOnlineCTRHash OnlineCTR;
 
+    bool IsCompactFlag = false;
+
 
     void AssignTarget(NCB::TMaybeData<TConstArrayRef<float>> target,
                       const TVector<TTargetClassifier>& targetClassifiers);
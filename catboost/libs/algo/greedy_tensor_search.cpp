@@ -15,7 +15,6 @@
 #include <library/fast_log/fast_log.h>
 
 #include <util/string/builder.h>
-#include <util/system/mem_info.h>
 
 
 using namespace NCB;
@@ -276,7 +275,7 @@ static void AddTreeCtrs(const TQuantizedForCPUObjectsDataProvider& learnObjectsD
     }
 }
 
-static void SelectCtrsToDropAfterCalc(size_t memoryLimit,
+static void SelectCtrsToDropAfterCalc(const NCB::TMemoryBudget& memoryBudget,
                                       int sampleCount,
                                       int threadCount,
                                       const std::function<bool(const TProjection&)>& IsInCache,
@@ -294,11 +293,12 @@ static void SelectCtrsToDropAfterCalc(size_t memoryLimit,
         fullNeededMemoryForCtrs += neededMem;
     }
 
-    auto currentMemoryUsage = NMemInfo::GetMemInfo().RSS;
+    const size_t memoryLimit = memoryBudget.GetLimit();
+    const size_t currentMemoryUsage = memoryBudget.GetTotalUsage();
     if (fullNeededMemoryForCtrs + currentMemoryUsage > memoryLimit) {
         CATBOOST_DEBUG_LOG << "Needed more memory then allowed, will drop some ctrs after score calculation" << Endl;
         const float GB = (ui64)1024 * 1024 * 1024;
-        CATBOOST_DEBUG_LOG << "current rss: " << currentMemoryUsage / GB << " full needed memory: " << fullNeededMemoryForCtrs / GB << Endl;
+        CATBOOST_DEBUG_LOG << "current memory usage: " << currentMemoryUsage / GB << " full needed memory: " << fullNeededMemoryForCtrs / GB << Endl;
         size_t currentNonDroppableMemory = currentMemoryUsage;
         size_t maxMemForOtherThreadsApprox = (ui64)(threadCount - 1) * maxMemoryForOneCtr;
         for (auto& candSubList : *candList) {
@@ -410,8 +410,7 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
         AddTreeCtrs(*data.Learn->ObjectsData, currentSplitTree, fold, ctx, &ctx->PrevTreeLevelStats, &candList);
 
         auto IsInCache = [&fold](const TProjection& proj) -> bool {return fold->GetCtrRef(proj).Feature.empty();};
-        auto cpuUsedRamLimit = ParseMemorySizeDescription(ctx->Params.SystemOptions->CpuUsedRamLimit.Get());
-        SelectCtrsToDropAfterCalc(cpuUsedRamLimit, learnSampleCount + testSampleCount, ctx->Params.SystemOptions->NumThreads, IsInCache, &candList);
+        SelectCtrsToDropAfterCalc(ctx->MemoryBudget, learnSampleCount + testSampleCount, ctx->Params.SystemOptions->NumThreads, IsInCache, &candList);
 
         CheckInterrupted(); // check after long-lasting operation
         if (!isSamplingPerTree) {
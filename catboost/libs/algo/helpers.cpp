@@ -5,6 +5,8 @@
 
 #include <library/malloc/api/malloc.h>
 
+#include <util/generic/xrange.h>
+
 #include <functional>
 
 
@@ -97,19 +99,23 @@ void CalcErrors(
                 auto queryInfo = GetGroupInfo(targetData);
 
                 TVector<bool> skipMetricOnTrain = GetSkipMetricOnTrain(errors);
+                TVector<const IMetric*> learnErrors;
                 for (int i = 0; i < errors.ysize(); ++i) {
                     if (!skipMetricOnTrain[i]) {
-                        const auto& additiveStats = EvalErrors(
-                            ctx->LearnProgress.AvrgApprox,
-                            target,
-                            weights,
-                            queryInfo,
-                            errors[i],
-                            ctx->LocalExecutor
-                        );
-                        ctx->LearnProgress.MetricsAndTimeHistory.AddLearnError(*errors[i].Get(), errors[i]->GetFinalError(additiveStats));
+                        learnErrors.push_back(errors[i].Get());
                     }
                 }
+                const auto learnStats = EvalErrors(
+                    ctx->LearnProgress.AvrgApprox,
+                    target,
+                    weights,
+                    queryInfo,
+                    learnErrors,
+                    ctx->LocalExecutor
+                );
+                for (auto i : xrange(learnErrors.size())) {
+                    ctx->LearnProgress.MetricsAndTimeHistory.AddLearnError(*learnErrors[i], learnErrors[i]->GetFinalError(learnStats[i]));
+                }
             } else {
                 MapCalcErrors(ctx);
             }
@@ -138,6 +144,8 @@ void CalcErrors(
             auto queryInfo = GetGroupInfo(targetData);
 
             const auto& testApprox = ctx->LearnProgress.TestApprox[testIdx];
+            TVector<int> testErrorIndices;
+            TVector<const IMetric*> testErrors;
             for (int i = 0; i < errors.ysize(); ++i) {
                 if (!calcAllMetrics && (i != errorTrackerMetricIdx)) {
                     continue;
@@ -145,19 +153,23 @@ void CalcErrors(
                 if (!maybeTarget && errors[i]->NeedTarget()) {
                     continue;
                 }
+                testErrorIndices.push_back(i);
+                testErrors.push_back(errors[i].Get());
+            }
 
-                const auto& additiveStats = EvalErrors(
-                    testApprox,
-                    target,
-                    weights,
-                    queryInfo,
-                    errors[i],
-                    ctx->LocalExecutor
-                );
-                bool updateBestIteration = (i == 0) && (testIdx == trainingDataProviders.Test.size() - 1);
+            const auto testStats = EvalErrors(
+                testApprox,
+                target,
+                weights,
+                queryInfo,
+                testErrors,
+                ctx->LocalExecutor
+            );
+            for (auto j : xrange(testErrors.size())) {
+                bool updateBestIteration = (testErrorIndices[j] == 0) && (testIdx == trainingDataProviders.Test.size() - 1);
                 ctx->LearnProgress.MetricsAndTimeHistory.AddTestError(testIdx,
-                                                                      *errors[i].Get(),
-                                                                      errors[i]->GetFinalError(additiveStats),
+                                                                      *testErrors[j],
+                                                                      testErrors[j]->GetFinalError(testStats[j]),
                                                                       updateBestIteration);
             }
         }
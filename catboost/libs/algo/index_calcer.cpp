@@ -10,6 +10,12 @@
 #include <catboost/libs/model/model.h>
 #include <catboost/libs/model/formula_evaluator.h>
 #include <catboost/libs/helpers/dense_hash.h>
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
+
+#include <limits>
 
 
 using namespace NCB;
@@ -309,19 +315,12 @@ TVector<TIndexType> BuildIndices(
     return indices;
 }
 
-void BinarizeFeatures(
+static TVector<TConstArrayRef<float>> GetRepackedRawFeatures(
     const TFullModel& model,
     const NCB::TRawObjectsDataProvider& rawObjectsData,
+    const THashMap<ui32, ui32>& columnReorderMap,
     size_t start,
-    size_t end,
-    TVector<ui8>* result) {
-
-    THashMap<ui32, ui32> columnReorderMap;
-    CheckModelAndDatasetCompatibility(model, rawObjectsData, &columnReorderMap);
-    auto docCount = end - start;
-    result->resize(model.ObliviousTrees.GetEffectiveBinaryFeaturesBucketsCount() * docCount);
-    TVector<ui32> transposedHash(docCount * model.GetUsedCatFeaturesCount());
-    TVector<float> ctrs(model.ObliviousTrees.GetUsedModelCtrs().size() * docCount);
+    size_t docCount) {
 
     const ui32 consecutiveSubsetBegin = GetConsecutiveSubsetBegin(rawObjectsData);
     const auto& featuresLayout = *rawObjectsData.GetFeaturesLayout();
@@ -345,6 +344,25 @@ void BinarizeFeatures(
             repackedFeatures[origIdx] = MakeArrayRef(getFeatureDataBeginPtr(sourceIdx) + start, docCount);
         }
     }
+    return repackedFeatures;
+}
+
+void BinarizeFeatures(
+    const TFullModel& model,
+    const NCB::TRawObjectsDataProvider& rawObjectsData,
+    size_t start,
+    size_t end,
+    TVector<ui8>* result) {
+
+    THashMap<ui32, ui32> columnReorderMap;
+    CheckModelAndDatasetCompatibility(model, rawObjectsData, &columnReorderMap);
+    auto docCount = end - start;
+    result->resize(model.ObliviousTrees.GetEffectiveBinaryFeaturesBucketsCount() * docCount);
+    TVector<ui32> transposedHash(docCount * model.GetUsedCatFeaturesCount());
+    TVector<float> ctrs(model.ObliviousTrees.GetUsedModelCtrs().size() * docCount);
+
+    const TVector<TConstArrayRef<float>> repackedFeatures
+        = GetRepackedRawFeatures(model, rawObjectsData, columnReorderMap, start, docCount);
 
     BinarizeFeatures(model,
         [&repackedFeatures](const TFloatFeature& floatFeature, size_t index) -> float {
@@ -397,3 +415,209 @@ TVector<TIndexType> BuildIndicesForBinTree(
         model.ObliviousTrees.TreeSizes[treeId]);
     return indexesVec;
 }
+
+static void ZeroLeafIndices(TArrayRef<ui32> leafIndices) {
+    Fill(leafIndices.begin(), leafIndices.end(), 0);
+}
+
+static void ZeroLeafIndices(TArrayRef<ui8>) {
+    // ui8 CalcIndexes overwrites the result
+}
+
+template <class TLeafIndexType, class TFloatFeatureAccessor, class TCatFeatureAccessor>
+static void BuildLeafIndicesForAllTreesImpl(
+    const TFullModel& model,
+    TFloatFeatureAccessor floatFeatureAccessor,
+    TCatFeatureAccessor catFeatureAccessor,
+    size_t docCount,
+    NPar::TLocalExecutor* localExecutor,
+    TVector<TVector<TLeafIndexType>>* leafIndices) {
+
+    const auto& obliviousTrees = model.ObliviousTrees;
+    const size_t treeCount = obliviousTrees.GetTreeCount();
+    leafIndices->resize(treeCount);
+    for (auto& treeLeafIndices : *leafIndices) {
+        treeLeafIndices.yresize(docCount);
+    }
+    if (docCount == 0) {
+        return;
+    }
+
+    const bool needXorMask = !obliviousTrees.OneHotFeatures.empty();
+    const size_t bucketsCount = obliviousTrees.GetEffectiveBinaryFeaturesBucketsCount();
+    const size_t usedCatFeaturesCount = model.GetUsedCatFeaturesCount();
+    const size_t usedModelCtrsCount = obliviousTrees.GetUsedModelCtrs().size();
+
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, SafeIntegerCast<int>(docCount));
+    blockParams.SetBlockCount(localExecutor->GetThreadCount() + 1);
+    localExecutor->ExecRange([&] (int blockId) {
+        const size_t blockFirstIdx = blockParams.FirstId + blockId * blockParams.GetBlockSize();
+        const size_t blockLastIdx = Min<size_t>(blockParams.LastId, blockFirstIdx + blockParams.GetBlockSize());
+
+        // buffers are reused between evaluation blocks of the thread
+        TVector<ui8> binarizedFeatures;
+        TVector<ui32> transposedHash;
+        TVector<float> ctrs;
+        for (size_t start = blockFirstIdx; start < blockLastIdx; start += FORMULA_EVALUATION_BLOCK_SIZE) {
+            const size_t end = Min(start + FORMULA_EVALUATION_BLOCK_SIZE, blockLastIdx);
+            const size_t blockDocCount = end - start;
+            binarizedFeatures.yresize(bucketsCount * blockDocCount);
+            transposedHash.yresize(usedCatFeaturesCount * blockDocCount);
+            ctrs.yresize(usedModelCtrsCount * blockDocCount);
+            BinarizeFeatures(
+                model,
+                floatFeatureAccessor,
+                catFeatureAccessor,
+                start,
+                end,
+                binarizedFeatures,
+                transposedHash,
+                ctrs);
+
+            for (size_t treeId = 0; treeId < treeCount; ++treeId) {
+                auto treeLeafIndices = MakeArrayRef((*leafIndices)[treeId].data() + start, blockDocCount);
+                ZeroLeafIndices(treeLeafIndices);
+                CalcIndexes(
+                    needXorMask,
+                    binarizedFeatures.data(),
+                    blockDocCount,
+                    treeLeafIndices.data(),
+                    obliviousTrees.GetRepackedBins().data() + obliviousTrees.TreeStartOffsets[treeId],
+                    obliviousTrees.TreeSizes[treeId]);
+            }
+        }
+    }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
+}
+
+/* Each bin of quantized feature is represented by its upper border (the last one - by infinity).
+ * Binarization of these values by model gives exact model bins if model borders are dataset borders as well,
+ * which is the case for models trained on this quantized dataset.
+ */
+static TVector<float> GetQuantizedBinValues(const TFloatFeature& floatFeature, const TVector<float>& datasetBorders) {
+    for (float border : floatFeature.Borders) {
+        CB_ENSURE(
+            BinarySearch(datasetBorders.begin(), datasetBorders.end(), border),
+            "Border " << border << " of feature " << floatFeature.FlatFeatureIndex
+            << " in model is not present in quantized dataset borders");
+    }
+    TVector<float> binValues(datasetBorders.begin(), datasetBorders.end());
+    binValues.push_back(std::numeric_limits<float>::infinity());
+    return binValues;
+}
+
+template <class TLeafIndexType>
+static void BuildLeafIndicesForAllTreesImpl(
+    const TFullModel& model,
+    const NCB::TObjectsDataProvider& objectsData,
+    NPar::TLocalExecutor* localExecutor,
+    TVector<TVector<TLeafIndexType>>* leafIndices) {
+
+    THashMap<ui32, ui32> columnReorderMap;
+    CheckModelAndDatasetCompatibility(model, objectsData, &columnReorderMap);
+    const size_t docCount = objectsData.GetObjectCount();
+
+    if (const auto* rawObjectsData = dynamic_cast<const TRawObjectsDataProvider*>(&objectsData)) {
+        const TVector<TConstArrayRef<float>> repackedFeatures
+            = GetRepackedRawFeatures(model, *rawObjectsData, columnReorderMap, 0, docCount);
+        BuildLeafIndicesForAllTreesImpl(
+            model,
+            [&repackedFeatures](const TFloatFeature& floatFeature, size_t index) -> float {
+                return repackedFeatures[floatFeature.FlatFeatureIndex][index];
+            },
+            [&repackedFeatures](const TCatFeature& catFeature, size_t index) -> ui32 {
+                return ConvertFloatCatFeatureToIntHash(repackedFeatures[catFeature.FlatFeatureIndex][index]);
+            },
+            docCount,
+            localExecutor,
+            leafIndices);
+        return;
+    }
+
+    const auto* quantizedObjectsData = dynamic_cast<const TQuantizedObjectsDataProvider*>(&objectsData);
+    CB_ENSURE_INTERNAL(quantizedObjectsData, "Unsupported objects data provider type");
+    const auto& featuresLayout = *quantizedObjectsData->GetFeaturesLayout();
+    const auto& quantizedFeaturesInfo = *quantizedObjectsData->GetQuantizedFeaturesInfo();
+    auto getSourceFlatFeatureIdx = [&] (ui32 modelFlatFeatureIdx) -> ui32 {
+        return columnReorderMap.empty() ? modelFlatFeatureIdx : columnReorderMap.at(modelFlatFeatureIdx);
+    };
+
+    const size_t flatFeatureCount = model.ObliviousTrees.GetFlatFeatureVectorExpectedSize();
+    TVector<TMaybeOwningArrayHolder<ui8>> floatFeatureBinsHolders;
+    TVector<TConstArrayRef<ui8>> floatFeatureBins(flatFeatureCount); // [modelFlatFeatureIdx][objectIdx]
+    TVector<TVector<float>> floatFeatureBinValues(flatFeatureCount); // [modelFlatFeatureIdx][bin]
+    for (const auto& floatFeature : model.ObliviousTrees.FloatFeatures) {
+        if (!floatFeature.UsedInModel()) {
+            continue;
+        }
+        const ui32 flatFeatureIdx = getSourceFlatFeatureIdx(floatFeature.FlatFeatureIndex);
+        const auto floatFeatureIdx = featuresLayout.GetInternalFeatureIdx<EFeatureType::Float>(flatFeatureIdx);
+        const auto featureData = quantizedObjectsData->GetFloatFeature(*floatFeatureIdx);
+        CB_ENSURE(
+            featureData && quantizedFeaturesInfo.HasBorders(floatFeatureIdx),
+            "Feature " << flatFeatureIdx << " is used in model but is not available in quantized dataset");
+        floatFeatureBinsHolders.push_back((*featureData)->ExtractValues(localExecutor));
+        floatFeatureBins[floatFeature.FlatFeatureIndex] = *floatFeatureBinsHolders.back();
+        floatFeatureBinValues[floatFeature.FlatFeatureIndex]
+            = GetQuantizedBinValues(floatFeature, quantizedFeaturesInfo.GetBorders(floatFeatureIdx));
+    }
+
+    TVector<TMaybeOwningArrayHolder<ui32>> catFeatureBinsHolders;
+    TVector<TConstArrayRef<ui32>> catFeatureBins(flatFeatureCount); // [modelFlatFeatureIdx][objectIdx]
+    TVector<TVector<ui32>> catFeatureBinHashes(flatFeatureCount); // [modelFlatFeatureIdx][bin]
+    if (model.GetUsedCatFeaturesCount()) {
+        TPerfectHashedToHashedCatValuesMap perfectHashedToHashedCatValuesMap
+            = quantizedFeaturesInfo.CalcPerfectHashedToHashedCatValuesMap(localExecutor);
+        for (const auto& catFeature : model.ObliviousTrees.CatFeatures) {
+            if (!catFeature.UsedInModel) {
+                continue;
+            }
+            const ui32 flatFeatureIdx = getSourceFlatFeatureIdx(catFeature.FlatFeatureIndex);
+            const auto catFeatureIdx = featuresLayout.GetInternalFeatureIdx<EFeatureType::Categorical>(flatFeatureIdx);
+            const auto featureData = quantizedObjectsData->GetCatFeature(*catFeatureIdx);
+            CB_ENSURE(
+                featureData,
+                "Feature " << flatFeatureIdx << " is used in model but is not available in quantized dataset");
+            catFeatureBinsHolders.push_back((*featureData)->ExtractValues(localExecutor));
+            catFeatureBins[catFeature.FlatFeatureIndex] = *catFeatureBinsHolders.back();
+            catFeatureBinHashes[catFeature.FlatFeatureIndex] = std::move(perfectHashedToHashedCatValuesMap[*catFeatureIdx]);
+        }
+    }
+
+    BuildLeafIndicesForAllTreesImpl(
+        model,
+        [&floatFeatureBins, &floatFeatureBinValues](const TFloatFeature& floatFeature, size_t index) -> float {
+            const auto flatFeatureIdx = floatFeature.FlatFeatureIndex;
+            return floatFeatureBinValues[flatFeatureIdx][floatFeatureBins[flatFeatureIdx][index]];
+        },
+        [&catFeatureBins, &catFeatureBinHashes](const TCatFeature& catFeature, size_t index) -> ui32 {
+            const auto flatFeatureIdx = catFeature.FlatFeatureIndex;
+            return catFeatureBinHashes[flatFeatureIdx][catFeatureBins[flatFeatureIdx][index]];
+        },
+        docCount,
+        localExecutor,
+        leafIndices);
+}
+
+void BuildLeafIndicesForAllTrees(
+    const TFullModel& model,
+    const NCB::TObjectsDataProvider& objectsData,
+    NPar::TLocalExecutor* localExecutor,
+    TVector<TVector<ui8>>* leafIndices) {
+
+    CB_ENSURE_INTERNAL(GetMaxTreeDepth(model) <= 8, "Leaf indices of trees deeper than 8 don't fit in ui8");
+    BuildLeafIndicesForAllTreesImpl(model, objectsData, localExecutor, leafIndices);
+}
+
+void BuildLeafIndicesForAllTrees(
+    const TFullModel& model,
+    const NCB::TObjectsDataProvider& objectsData,
+    NPar::TLocalExecutor* localExecutor,
+    TVector<TVector<ui32>>* leafIndices) {
+
+    BuildLeafIndicesForAllTreesImpl(model, objectsData, localExecutor, leafIndices);
+}
+
+int GetMaxTreeDepth(const TFullModel& model) {
+    const auto& treeSizes = model.ObliviousTrees.TreeSizes;
+    return treeSizes.empty() ? 0 : *MaxElement(treeSizes.begin(), treeSizes.end());
+}
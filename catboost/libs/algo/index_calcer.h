@@ -52,3 +52,22 @@ TVector<TIndexType> BuildIndicesForBinTree(
     const TFullModel& model,
     const TVector<ui8>& binarizedFeatures,
     size_t treeId);
+
+int GetMaxTreeDepth(const TFullModel& model);
+
+/* Leaf indices of all model trees for all objects, [treeId][objectIdx].
+ * objectsData can be raw or quantized, quantized dataset must have all borders used in model.
+ * Objects are binarized by blocks, so the whole binarized dataset is never kept in memory.
+ * ui8 version requires GetMaxTreeDepth(model) <= 8 and uses SSE implementation of CalcIndexes.
+ */
+void BuildLeafIndicesForAllTrees(
+    const TFullModel& model,
+    const NCB::TObjectsDataProvider& objectsData,
+    NPar::TLocalExecutor* localExecutor,
+    TVector<TVector<ui8>>* leafIndices);
+
+void BuildLeafIndicesForAllTrees(
+    const TFullModel& model,
+    const NCB::TObjectsDataProvider& objectsData,
+    NPar::TLocalExecutor* localExecutor,
+    TVector<TVector<ui32>>* leafIndices);
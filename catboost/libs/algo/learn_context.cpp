@@ -17,6 +17,7 @@
 #include <util/folder/path.h>
 #include <util/system/fs.h>
 #include <util/stream/file.h>
+#include <util/stream/str.h>
 
 
 using namespace NCB;
@@ -24,6 +25,7 @@ using namespace NCB;
 
 
 TLearnContext::~TLearnContext() {
+    WaitForSnapshotSaving();
     if (Params.SystemOptions->IsMaster()) {
         FinalizeMaster(this);
     }
@@ -50,6 +52,14 @@ static bool IsPermutationNeeded(bool hasTime, bool hasCtrs, bool isOrderedBoosti
     return isOrderedBoosting && !isAveragingFold;
 }
 
+// quantized float features are stored as ui8 bins, categorical features - as ui32 perfect hashes
+static ui64 EstimateQuantizedDataMemoryUsage(const TTrainingForCPUDataProvider& data) {
+    const auto& featuresLayout = *data.ObjectsData->GetFeaturesLayout();
+    const ui64 objectSize = featuresLayout.GetFloatFeatureCount() * sizeof(ui8)
+        + featuresLayout.GetCatFeatureCount() * sizeof(ui32);
+    return objectSize * data.GetObjectCount();
+}
+
 static int CountLearningFolds(int permutationCount, bool isPermutationNeededForLearning) {
     return isPermutationNeededForLearning ? Max<ui32>(1, permutationCount - 1) : 1;
 }
@@ -165,17 +175,59 @@ void TLearnContext::InitContext(const TTrainingForCPUDataProviders& data) {
         }
     }
 
+    if (Params.BoostingOptions->SinglePrecisionFoldApproxes) {
+        CB_ENSURE(
+            Params.SystemOptions->IsSingleHost(),
+            "Single precision fold approxes are not supported for distributed training");
+        for (auto& fold : LearnProgress.Folds) {
+            fold.Compact(LocalExecutor);
+        }
+    }
+
     const ui32 maxBodyTailCount = Max(1, GetMaxBodyTailCount(LearnProgress.Folds));
     UseTreeLevelCachingFlag = NeedToUseTreeLevelCaching(Params, maxBodyTailCount, LearnProgress.ApproxDimension);
+
+    ui64 quantizedDataMemoryUsage = EstimateQuantizedDataMemoryUsage(*data.Learn);
+    for (const auto& testData : data.Test) {
+        quantizedDataMemoryUsage += EstimateQuantizedDataMemoryUsage(*testData);
+    }
+    MemoryBudget.SetUsage(EMemoryConsumer::QuantizedData, quantizedDataMemoryUsage);
+    UpdateMemoryUsage();
+    if (MemoryBudget.IsLimited()) {
+        CATBOOST_INFO_LOG << "Memory usage after initialization: " << MemoryBudget.GetBreakdown() << Endl;
+    }
 }
 
 void TLearnContext::SaveProgress() {
     if (!OutputOptions.SaveSnapshot()) {
         return;
     }
-    TProgressHelper(ToString(ETaskType::CPU)).Write(Files.SnapshotFile, [&](IOutputStream* out) {
-        ::SaveMany(out, Rand, LearnProgress, Profile.DumpProfileInfo());
-    });
+
+    // at most one snapshot is written at a time, so the previous one is always complete
+    WaitForSnapshotSaving();
+
+    // serialize a consistent copy of the progress to memory, training continues while it is written to disk
+    auto snapshot = MakeAtomicShared<TString>();
+    {
+        TStringOutput out(*snapshot);
+        ::SaveMany(&out, Rand, LearnProgress, Profile.DumpProfileInfo());
+    }
+
+    SnapshotSavingThread = SystemThreadPool()->Run(
+        [snapshot = std::move(snapshot), snapshotFile = Files.SnapshotFile] () {
+            // Write handles all exceptions and writes to temporary file that is renamed to snapshotFile
+            TProgressHelper(ToString(ETaskType::CPU)).Write(snapshotFile, [&](IOutputStream* out) {
+                out->Write(*snapshot);
+            });
+        }
+    );
+}
+
+void TLearnContext::WaitForSnapshotSaving() {
+    if (SnapshotSavingThread) {
+        SnapshotSavingThread->Join();
+        SnapshotSavingThread.Destroy();
+    }
 }
 
 bool TLearnContext::TryLoadProgress() {
@@ -280,6 +332,55 @@ bool TLearnContext::UseTreeLevelCaching() const {
     return UseTreeLevelCachingFlag;
 }
 
+void TLearnContext::UpdateMemoryUsage() {
+    const auto reportUsage = [this] () {
+        ui64 foldsMemoryUsage = LearnProgress.AveragingFold.GetMemoryUsage();
+        ui64 onlineCtrsMemoryUsage = LearnProgress.AveragingFold.GetOnlineCTRsMemoryUsage();
+        for (const auto& fold : LearnProgress.Folds) {
+            foldsMemoryUsage += fold.GetMemoryUsage();
+            onlineCtrsMemoryUsage += fold.GetOnlineCTRsMemoryUsage();
+        }
+        MemoryBudget.SetUsage(EMemoryConsumer::Folds, foldsMemoryUsage);
+        MemoryBudget.SetUsage(EMemoryConsumer::OnlineCtrs, onlineCtrsMemoryUsage);
+        MemoryBudget.SetUsage(
+            EMemoryConsumer::ScoreCalcCache,
+            SampledDocs.GetMemoryUsage() + SmallestSplitSideDocs.GetMemoryUsage() + PrevTreeLevelStats.GetMemoryUsage());
+        MemoryBudget.SetUsage(
+            EMemoryConsumer::Approxes,
+            GetVectorMemoryUsage(LearnProgress.AvrgApprox)
+                + GetVectorMemoryUsage(LearnProgress.TestApprox)
+                + GetVectorMemoryUsage(LearnProgress.BestTestApprox));
+    };
+
+    reportUsage();
+    CATBOOST_DEBUG_LOG << "Memory usage: " << MemoryBudget.GetBreakdown() << Endl;
+    if (!MemoryBudget.IsExceeded()) {
+        return;
+    }
+
+    bool isAdapted = false;
+    if (MemoryBudget.GetUsage(EMemoryConsumer::OnlineCtrs) > 0) {
+        LearnProgress.AveragingFold.DropOnlineCTRs();
+        for (auto& fold : LearnProgress.Folds) {
+            fold.DropOnlineCTRs();
+        }
+        isAdapted = true;
+    }
+    if (UseTreeLevelCachingFlag) {
+        UseTreeLevelCachingFlag = false;
+        PrevTreeLevelStats.Clear();
+        CATBOOST_INFO_LOG << "Statistics from previous tree level will not be cached to fit into used_ram_limit" << Endl;
+        isAdapted = true;
+    }
+    if (isAdapted) {
+        reportUsage();
+    }
+    if (MemoryBudget.IsExceeded() && !IsMemoryBudgetExceededReported) {
+        CATBOOST_WARNING_LOG << "Memory usage exceeds used_ram_limit: " << MemoryBudget.GetBreakdown() << Endl;
+        IsMemoryBudgetExceededReported = true;
+    }
+}
+
 bool NeedToUseTreeLevelCaching(
     const NCatboostOptions::TCatBoostOptions& params,
     ui32 maxBodyTailCount,
@@ -9,6 +9,7 @@
 
 #include <catboost/libs/data_new/data_provider.h>
 #include <catboost/libs/data_new/features_layout.h>
+#include <catboost/libs/helpers/memory_budget.h>
 #include <catboost/libs/helpers/restorable_rng.h>
 #include <catboost/libs/labels/label_converter.h>
 #include <catboost/libs/loggers/logger.h>
@@ -24,6 +25,8 @@
 
 #include <util/generic/noncopyable.h>
 #include <util/generic/hash_set.h>
+#include <util/generic/ptr.h>
+#include <util/thread/factory.h>
 
 
 struct TLearnProgress {
@@ -104,6 +107,7 @@ public:
         , RootEnvironment(nullptr)
         , SharedTrainData(nullptr)
         , Profile((int)Params.BoostingOptions->IterationCount)
+        , MemoryBudget(ParseMemorySizeDescription(Params.SystemOptions->CpuUsedRamLimit.Get()))
         , UseTreeLevelCachingFlag(false) {
         LearnProgress.SerializedTrainParams = ToString(Params);
         ETaskType taskType = Params.GetTaskType();
@@ -117,10 +121,20 @@ public:
 
     void OutputMeta();
     void InitContext(const NCB::TTrainingForCPUDataProviders& data);
+
+    /* serializes progress on the calling thread and writes it to the snapshot file in the background,
+     * call WaitForSnapshotSaving to make sure the snapshot file is written
+     */
     void SaveProgress();
+    void WaitForSnapshotSaving();
     bool TryLoadProgress();
     bool UseTreeLevelCaching() const;
 
+    /* reports memory usage of folds, caches and approxes to MemoryBudget,
+     * drops caches if `used_ram_limit` is exceeded
+     */
+    void UpdateMemoryUsage();
+
 public:
     TRestorableFastRng64 Rand;
     TLearnProgress LearnProgress;
@@ -133,9 +147,12 @@ public:
     TObj<NPar::IRootEnvironment> RootEnvironment;
     TObj<NPar::IEnvironment> SharedTrainData;
     TProfileInfo Profile;
+    NCB::TMemoryBudget MemoryBudget;
 
 private:
     bool UseTreeLevelCachingFlag;
+    bool IsMemoryBudgetExceededReported = false;
+    THolder<IThreadFactory::IThread> SnapshotSavingThread;
 };
 
 bool NeedToUseTreeLevelCaching(
@@ -2,10 +2,13 @@
 #include "pairwise_leaves_calculation.h"
 
 #include <util/generic/xrange.h>
+#include <util/system/cpu_id.h>
 #include <util/system/yassert.h>
 
 #include <emmintrin.h>
 
+double CalculateScoreRowAvx2(const double* avrg, const double* sumWeights, ui32 size) noexcept;
+
 void TPairwiseStats::Add(const TPairwiseStats& rhs) {
     Y_ASSERT(DerSums.size() == rhs.DerSums.size());
 
@@ -53,27 +56,53 @@ static inline __m128d XmmGather(const double* first, const double* second) {
     return _mm_loadh_pd(_mm_loadl_pd(_mm_undefined_pd(), first), second);
 }
 
+static double CalculateScoreRowSse2(const double* avrgData, const double* sumWeightsData, ui32 sumDerSize) {
+    __m128d subScore0 = _mm_setzero_pd();
+    __m128d subScore2 = _mm_setzero_pd();
+    for (ui32 y = 0; y + 4 <= sumDerSize; y += 4) {
+        subScore0 = XmmFusedMultiplyAdd(avrgData + y + 0, sumWeightsData + y + 0, subScore0);
+        subScore2 = XmmFusedMultiplyAdd(avrgData + y + 2, sumWeightsData + y + 2, subScore2);
+    }
+    double subScore = XmmHorizontalAdd(subScore0) + XmmHorizontalAdd(subScore2);
+    for (ui32 y = sumDerSize & ~3u; y < sumDerSize; ++y) {
+        subScore += avrgData[y] * sumWeightsData[y];
+    }
+    return subScore;
+}
+
 static double CalculateScore(const TVector<double>& avrg, const TVector<double>& sumDer, const TArray2D<double>& sumWeights) {
     const ui32 sumDerSize = sumDer.ysize();
+    // Both implementations sum products in the same order, so scores do not depend on the CPU.
+    const bool useAvx2 = sumDerSize >= 4 && NX86::CachedHaveAVX() && NX86::CachedHaveAVX2();
     double score = 0;
     for (ui32 x = 0; x < sumDerSize; ++x) {
         const double* avrgData = avrg.data();
         const double* sumWeightsData = &sumWeights[x][0];
-        __m128d subScore0 = _mm_setzero_pd();
-        __m128d subScore2 = _mm_setzero_pd();
-        for (ui32 y = 0; y + 4 <= sumDerSize; y += 4) {
-            subScore0 = XmmFusedMultiplyAdd(avrgData + y + 0, sumWeightsData + y + 0, subScore0);
-            subScore2 = XmmFusedMultiplyAdd(avrgData + y + 2, sumWeightsData + y + 2, subScore2);
-        }
-        double subScore = XmmHorizontalAdd(subScore0) + XmmHorizontalAdd(subScore2);
-        for (ui32 y = sumDerSize & ~3u; y < sumDerSize; ++y) {
-            subScore += avrgData[y] * sumWeightsData[y];
-        }
+        const double subScore = useAvx2
+            ? CalculateScoreRowAvx2(avrgData, sumWeightsData, sumDerSize)
+            : CalculateScoreRowSse2(avrgData, sumWeightsData, sumDerSize);
         score += avrg[x] * (sumDer[x] - 0.5 * subScore);
     }
     return score;
 }
 
+namespace {
+    struct TLeafDeltas {
+        double Der;
+        double Weight;
+    };
+
+    struct TLeafPairDeltas {
+        double W00;
+        double W01;
+        double W10;
+        double W11;
+    };
+}
+
+// Statistics of this number of buckets fill a cache line.
+static constexpr int SplitTileSize = 64 / sizeof(TBucketPairWeightStatistics);
+
 void CalculatePairwiseScore(
     const TPairwiseStats& pairwiseStats,
     int bucketCount,
@@ -125,46 +154,79 @@ void CalculatePairwiseScore(
         }
     }
 
-    for (int splitId = 0; splitId < bucketCount - 1; ++splitId) {
+    // Split deltas are gathered for a tile of buckets at once, so every leaf pair statistics cache line is read once
+    // instead of once per split, and then applied to the cumulative sums from a contiguous buffer.
+    const int splitCount = bucketCount - 1;
+    const int leafPairCount = leafCount * (leafCount - 1) / 2;
+    TVector<TLeafDeltas> leafDeltas(SplitTileSize * leafCount); // [tileSplitId][leafId]
+    TVector<TLeafPairDeltas> leafPairDeltas(SplitTileSize * leafPairCount); // [tileSplitId][leafPairId]
+    for (int tileBegin = 0; tileBegin < splitCount; tileBegin += SplitTileSize) {
+        const int tileEnd = Min(tileBegin + SplitTileSize, splitCount);
+
         for (int y = 0; y < leafCount; ++y) {
-            const double derDelta = derSums[y][splitId];
-            derSum[2 * y] += derDelta;
-            derSum[2 * y + 1] -= derDelta;
-
-            const double weightDelta = (pairWeightStatistics[y][y][splitId].SmallerBorderWeightSum -
-                pairWeightStatistics[y][y][splitId].GreaterBorderRightWeightSum);
-            weightSum[2 * y][2 * y + 1] += weightDelta;
-            weightSum[2 * y + 1][2 * y] += weightDelta;
-            weightSum[2 * y][2 * y] -= weightDelta;
-            weightSum[2 * y + 1][2 * y + 1] -= weightDelta;
-            for (int x = y + 1; x < leafCount; ++x) {
-                const TBucketPairWeightStatistics& xy = pairWeightStatistics[x][y][splitId];
-                const TBucketPairWeightStatistics& yx = pairWeightStatistics[y][x][splitId];
-
-                const double w00Delta = xy.GreaterBorderRightWeightSum + yx.GreaterBorderRightWeightSum;
-                const double w01Delta = xy.SmallerBorderWeightSum - xy.GreaterBorderRightWeightSum;
-                const double w10Delta = yx.SmallerBorderWeightSum - yx.GreaterBorderRightWeightSum;
-                const double w11Delta = -(xy.SmallerBorderWeightSum + yx.SmallerBorderWeightSum);
-
-                weightSum[2 * x][2 * y] += w00Delta;
-                weightSum[2 * y][2 * x] += w00Delta;
-                weightSum[2 * x][2 * y + 1] += w01Delta;
-                weightSum[2 * y + 1][2 * x] += w01Delta;
-                weightSum[2 * x + 1][2 * y] += w10Delta;
-                weightSum[2 * y][2 * x + 1] += w10Delta;
-                weightSum[2 * x + 1][2 * y + 1] += w11Delta;
-                weightSum[2 * y + 1][2 * x + 1] += w11Delta;
-
-                weightSum[2 * y][2 * y] -= w00Delta + w10Delta;
-                weightSum[2 * x][2 * x] -= w00Delta + w01Delta;
-                weightSum[2 * x + 1][2 * x + 1] -= w10Delta + w11Delta;
-                weightSum[2 * y + 1][2 * y + 1] -= w01Delta + w11Delta;
+            const double* derData = derSums[y].data();
+            const TBucketPairWeightStatistics* yyData = pairWeightStatistics[y][y].data();
+            for (int splitId = tileBegin; splitId < tileEnd; ++splitId) {
+                auto& deltas = leafDeltas[(splitId - tileBegin) * leafCount + y];
+                deltas.Der = derData[splitId];
+                deltas.Weight = yyData[splitId].SmallerBorderWeightSum - yyData[splitId].GreaterBorderRightWeightSum;
+            }
+        }
+        for (int y = 0, leafPairId = 0; y < leafCount; ++y) {
+            for (int x = y + 1; x < leafCount; ++x, ++leafPairId) {
+                const TBucketPairWeightStatistics* xyData = pairWeightStatistics[x][y].data();
+                const TBucketPairWeightStatistics* yxData = pairWeightStatistics[y][x].data();
+                for (int splitId = tileBegin; splitId < tileEnd; ++splitId) {
+                    const TBucketPairWeightStatistics& xy = xyData[splitId];
+                    const TBucketPairWeightStatistics& yx = yxData[splitId];
+                    auto& deltas = leafPairDeltas[(splitId - tileBegin) * leafPairCount + leafPairId];
+                    deltas.W00 = xy.GreaterBorderRightWeightSum + yx.GreaterBorderRightWeightSum;
+                    deltas.W01 = xy.SmallerBorderWeightSum - xy.GreaterBorderRightWeightSum;
+                    deltas.W10 = yx.SmallerBorderWeightSum - yx.GreaterBorderRightWeightSum;
+                    deltas.W11 = -(xy.SmallerBorderWeightSum + yx.SmallerBorderWeightSum);
+                }
             }
         }
 
-        const TVector<double> leafValues = CalculatePairwiseLeafValues(weightSum, derSum, l2DiagReg, pairwiseBucketWeightPriorReg);
-        (*scoreBins)[splitId].D2 = 1.0;
-        (*scoreBins)[splitId].DP = CalculateScore(leafValues, derSum, weightSum);
+        for (int splitId = tileBegin; splitId < tileEnd; ++splitId) {
+            const TLeafDeltas* splitLeafDeltas = leafDeltas.data() + (splitId - tileBegin) * leafCount;
+            const TLeafPairDeltas* splitLeafPairDeltas = leafPairDeltas.data() + (splitId - tileBegin) * leafPairCount;
+            for (int y = 0; y < leafCount; ++y) {
+                const double derDelta = splitLeafDeltas[y].Der;
+                derSum[2 * y] += derDelta;
+                derSum[2 * y + 1] -= derDelta;
+
+                const double weightDelta = splitLeafDeltas[y].Weight;
+                weightSum[2 * y][2 * y + 1] += weightDelta;
+                weightSum[2 * y + 1][2 * y] += weightDelta;
+                weightSum[2 * y][2 * y] -= weightDelta;
+                weightSum[2 * y + 1][2 * y + 1] -= weightDelta;
+                for (int x = y + 1; x < leafCount; ++x) {
+                    const TLeafPairDeltas& deltas = *splitLeafPairDeltas++;
+                    const double w00Delta = deltas.W00;
+                    const double w01Delta = deltas.W01;
+                    const double w10Delta = deltas.W10;
+                    const double w11Delta = deltas.W11;
+
+                    weightSum[2 * x][2 * y] += w00Delta;
+                    weightSum[2 * y][2 * x] += w00Delta;
+                    weightSum[2 * x][2 * y + 1] += w01Delta;
+                    weightSum[2 * y + 1][2 * x] += w01Delta;
+                    weightSum[2 * x + 1][2 * y] += w10Delta;
+                    weightSum[2 * y][2 * x + 1] += w10Delta;
+                    weightSum[2 * x + 1][2 * y + 1] += w11Delta;
+                    weightSum[2 * y + 1][2 * x + 1] += w11Delta;
+
+                    weightSum[2 * y][2 * y] -= w00Delta + w10Delta;
+                    weightSum[2 * x][2 * x] -= w00Delta + w01Delta;
+                    weightSum[2 * x + 1][2 * x + 1] -= w10Delta + w11Delta;
+                    weightSum[2 * y + 1][2 * y + 1] -= w01Delta + w11Delta;
+                }
+            }
+
+            const TVector<double> leafValues = CalculatePairwiseLeafValues(weightSum, derSum, l2DiagReg, pairwiseBucketWeightPriorReg);
+            (*scoreBins)[splitId].D2 = 1.0;
+            (*scoreBins)[splitId].DP = CalculateScore(leafValues, derSum, weightSum);
+        }
     }
 }
-
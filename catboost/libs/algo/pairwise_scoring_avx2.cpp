@@ -0,0 +1,21 @@
+#include <util/system/types.h>
+
+#include <immintrin.h>
+
+static inline double XmmHorizontalAdd(__m128d x) {
+    return _mm_cvtsd_f64(_mm_add_pd(x, _mm_shuffle_pd(x, x, /*swap halves*/ 0x1)));
+}
+
+// Same summation order as in the SSE2 implementation in pairwise_scoring.cpp, fused multiply-add is not used
+// on purpose to keep scores bitwise equal on all CPUs.
+double CalculateScoreRowAvx2(const double* avrgData, const double* sumWeightsData, ui32 sumDerSize) noexcept {
+    __m256d subScore = _mm256_setzero_pd();
+    for (ui32 y = 0; y + 4 <= sumDerSize; y += 4) {
+        subScore = _mm256_add_pd(_mm256_mul_pd(_mm256_loadu_pd(avrgData + y), _mm256_loadu_pd(sumWeightsData + y)), subScore);
+    }
+    double result = XmmHorizontalAdd(_mm256_castpd256_pd128(subScore)) + XmmHorizontalAdd(_mm256_extractf128_pd(subScore, 1));
+    for (ui32 y = sumDerSize & ~3u; y < sumDerSize; ++y) {
+        result += avrgData[y] * sumWeightsData[y];
+    }
+    return result;
+}
@@ -8,15 +8,15 @@
 #include <catboost/libs/options/json_helper.h>
 
 #include <util/folder/path.h>
+#include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
 #include <util/generic/guid.h>
 #include <util/generic/utility.h>
 #include <util/generic/xrange.h>
 #include <util/stream/fwd.h>
 #include <util/string/builder.h>
-#include <util/system/file.h>
+#include <util/system/info.h>
 #include <util/system/yassert.h>
-#include <util/ysaveload.h>
 
 #include <cmath>
 
@@ -24,6 +24,105 @@
 using namespace NCB;
 
 
+TStagedApproxStorage::TStagedApproxStorage(ui32 approxDimension, const TString& tmpDir, ui64 ramLimit)
+    : ApproxDimension(approxDimension)
+    , TmpDir(tmpDir)
+    , RamLimit(ramLimit)
+{
+}
+
+TStagedApproxStorage::~TStagedApproxStorage() {
+    Clear();
+}
+
+void TStagedApproxStorage::Add(ui32 plotLineIndex, const TVector<TVector<double>>& approx) {
+    Y_ASSERT(approx.size() == ApproxDimension);
+    Y_ASSERT(!FileMap);
+    const ui32 objectCount = approx[0].size();
+    if (objectCount == 0) {
+        return;
+    }
+    auto& objectOffset = ObjectCountPerPlotLine[plotLineIndex];
+    Blocks.push_back(TBlock{plotLineIndex, objectOffset, objectCount, DataSize});
+    objectOffset += objectCount;
+
+    const ui64 blockSize = static_cast<ui64>(objectCount) * ApproxDimension;
+    if (!File && (DataSize + blockSize) * sizeof(double) > RamLimit) {
+        MoveToFile();
+    }
+    for (const auto& approxDim : approx) {
+        if (File) {
+            File->Write(approxDim.data(), objectCount * sizeof(double));
+        } else {
+            Data.insert(Data.end(), approxDim.begin(), approxDim.end());
+        }
+    }
+    DataSize += blockSize;
+}
+
+void TStagedApproxStorage::MoveToFile() {
+    if (!NFs::Exists(TmpDir)) {
+        NFs::MakeDirectory(TmpDir);
+        TmpDirCreated = true;
+    }
+    FileName = JoinFsPaths(TmpDir, TStringBuilder() << CreateGuidAsString() << "_approx.tmp");
+    CATBOOST_DEBUG_LOG << "Approxes for non-additive metrics do not fit into "
+        << RamLimit << " bytes, moving them to " << FileName << Endl;
+    File = MakeHolder<TFile>(FileName, CreateAlways | WrOnly | Seq);
+    File->Write(Data.data(), Data.size() * sizeof(double));
+    Data = TVector<double>();
+}
+
+void TStagedApproxStorage::FinishAdding() {
+    if (File && !FileMap && DataSize) {
+        File->Close();
+        FileMap = MakeHolder<TFileMap>(FileName);
+        FileMap->Map(0, DataSize * sizeof(double));
+    }
+}
+
+const double* TStagedApproxStorage::GetData() const {
+    if (File) {
+        CB_ENSURE(FileMap, "FinishAdding should be called before reading approxes");
+        return static_cast<const double*>(FileMap->Ptr());
+    }
+    return Data.data();
+}
+
+TVector<TVector<double>> TStagedApproxStorage::GetApprox(ui32 plotLineIndex, ui32 objectCount) const {
+    TVector<TVector<double>> result(ApproxDimension);
+    for (auto& approxDim : result) {
+        approxDim.yresize(objectCount);
+    }
+    const double* data = GetData();
+    ui32 storedObjectCount = 0;
+    for (const auto& block : Blocks) {
+        if (block.PlotLineIndex != plotLineIndex) {
+            continue;
+        }
+        const double* blockData = data + block.DataOffset;
+        for (ui32 dim = 0; dim < ApproxDimension; ++dim) {
+            const double* blockDimData = blockData + static_cast<ui64>(dim) * block.ObjectCount;
+            Copy(blockDimData, blockDimData + block.ObjectCount, result[dim].begin() + block.ObjectOffset);
+        }
+        storedObjectCount += block.ObjectCount;
+    }
+    CB_ENSURE(storedObjectCount == objectCount, "Approxes are missing for some objects");
+    return result;
+}
+
+void TStagedApproxStorage::Clear() {
+    Blocks.clear();
+    ObjectCountPerPlotLine.clear();
+    DataSize = 0;
+    Data = TVector<double>();
+    FileMap.Destroy();
+    if (File) {
+        File.Destroy();
+        NFs::Remove(FileName);
+    }
+}
+
 TMetricsPlotCalcer::TMetricsPlotCalcer(
     const TFullModel& model,
     const TVector<THolder<IMetric>>& metrics,
@@ -39,8 +138,10 @@ TMetricsPlotCalcer::TMetricsPlotCalcer(
     , Last(last)
     , Step(step)
     , TmpDir(tmpDir)
+    , ApproxRamLimit(NSystemInfo::TotalMemorySize() / 2)
     , ProcessedIterationsCount(0)
     , ProcessedIterationsStep(processIterationStep)
+    , StagedApproxes(model.ObliviousTrees.ApproxDimension, tmpDir, ApproxRamLimit)
 {
     EnsureCorrectParams();
     for (ui32 iteration = First; iteration < Last; iteration += Step) {
@@ -73,18 +174,9 @@ void TMetricsPlotCalcer::ComputeAdditiveMetric(
     TConstArrayRef<TQueryInfo> queriesInfo,
     ui32 plotLineIndex
 ) {
+    const auto results = EvalErrors(approx, target, weights, queriesInfo, AdditiveMetrics, &Executor);
     for (ui32 metricId = 0; metricId < AdditiveMetrics.size(); ++metricId) {
-        const auto& metric = *AdditiveMetrics[metricId];
-        const auto docCount = static_cast<int>(target.size());
-        const auto queryCount = static_cast<int>(queriesInfo.size());
-        TMetricHolder metricResult;
-        if (metric.GetErrorType() == EErrorType::PerObjectError) {
-            metricResult = metric.Eval(approx, target, weights, queriesInfo, 0, docCount, Executor);
-        } else {
-            CB_ENSURE(metric.GetErrorType() == EErrorType::QuerywiseError || metric.GetErrorType() == EErrorType::PairwiseError);
-            metricResult = metric.Eval(approx, target, weights, queriesInfo, 0, queryCount, Executor);
-        }
-        AdditiveMetricPlots[metricId][plotLineIndex].Add(metricResult);
+        AdditiveMetricPlots[metricId][plotLineIndex].Add(results[metricId]);
     }
 }
 
@@ -127,23 +219,15 @@ TMetricsPlotCalcer& TMetricsPlotCalcer::FinishProceedDataSetForNonAdditiveMetric
     ComputeNonAdditiveMetrics(begin, end);
     ProcessedIterationsCount = end;
     if (AreAllIterationsProcessed()) {
-        DeleteApprox(end - 1);
+        LastApproxes.clear();
     } else {
-        LastApproxes = MakeHolder<TIFStream>(GetApproxFileName(end - 1));
+        LastApproxes = StagedApproxes.GetApprox(end - 1, NonAdditiveMetricsData.Target.size());
+        LastApproxesOffset = 0;
     }
+    StagedApproxes.Clear();
     return *this;
 }
 
-static void Load(ui32 docCount, IInputStream* input, TVector<TVector<double>>* output) {
-    TVector<double> line;
-    for (ui32 i = 0; i < docCount; ++i) {
-        ::Load(input, line);
-        for (ui32 dim = 0; dim < output->size(); ++dim) {
-            (*output)[dim][i] = line[dim];
-        }
-    }
-}
-
 static ui32 GetDocCount(TConstArrayRef<TProcessedDataProvider> datasetParts) {
     ui32 answer = 0;
     for (const auto& datasetPart : datasetParts) {
@@ -218,8 +302,15 @@ TMetricsPlotCalcer& TMetricsPlotCalcer::ProceedDataSet(
     if (beginIterationIndex == 0) {
         begin = 0;
     } else {
-        begin = Iterations[beginIterationIndex];
-        Load(docCount, LastApproxes.Get(), &CurApproxBuffer);
+        begin = Iterations[beginIterationIndex - 1] + 1;
+        CB_ENSURE(
+            LastApproxesOffset + docCount <= LastApproxes[0].size(),
+            "Dataset parts differ from the ones processed for previous plot lines");
+        for (ui32 dim = 0; dim < CurApproxBuffer.size(); ++dim) {
+            const auto lastApproxBegin = LastApproxes[dim].begin() + LastApproxesOffset;
+            Copy(lastApproxBegin, lastApproxBegin + docCount, CurApproxBuffer[dim].begin());
+        }
+        LastApproxesOffset += docCount;
     }
 
     const auto target = GetTarget(processedData.TargetData);
@@ -239,7 +330,7 @@ TMetricsPlotCalcer& TMetricsPlotCalcer::ProceedDataSet(
                 groupInfos,
                 iterationIndex);
         } else {
-            SaveApproxToFile(iterationIndex, CurApproxBuffer);
+            StagedApproxes.Add(iterationIndex, CurApproxBuffer);
         }
         begin = end;
     }
@@ -249,17 +340,47 @@ TMetricsPlotCalcer& TMetricsPlotCalcer::ProceedDataSet(
     return *this;
 }
 
+static ui64 GetApproxRamUsage(ui32 docCount, ui32 approxDimension) {
+    return static_cast<ui64>(docCount) * approxDimension * sizeof(double);
+}
+
+ui32 TMetricsPlotCalcer::GetParallelPlotLineCount(ui32 docCount, ui64 usedRam) const {
+    const ui64 approxSize = Max<ui64>(1, GetApproxRamUsage(docCount, Model.ObliviousTrees.ApproxDimension));
+    const ui64 availableRam = ApproxRamLimit > usedRam ? ApproxRamLimit - usedRam : 0;
+    return Max<ui64>(1, Min<ui64>(Executor.GetThreadCount() + 1, availableRam / approxSize));
+}
+
+void TMetricsPlotCalcer::EvalNonAdditiveMetrics(
+    const TVector<TVector<TVector<double>>>& approxes,
+    TConstArrayRef<float> target,
+    TConstArrayRef<float> weights,
+    ui32 firstPlotLineIndex
+) {
+    const ui32 metricCount = NonAdditiveMetrics.size();
+    NPar::ParallelFor(Executor, 0, approxes.size() * metricCount, [&](ui32 taskIdx) {
+        const ui32 approxIdx = taskIdx / metricCount;
+        const ui32 metricId = taskIdx % metricCount;
+        NonAdditiveMetricPlots[metricId][firstPlotLineIndex + approxIdx] = NonAdditiveMetrics[metricId]->Eval(
+            approxes[approxIdx], target, weights, {}, 0, target.size(), Executor);
+    });
+}
+
 void TMetricsPlotCalcer::ComputeNonAdditiveMetrics(ui32 begin, ui32 end) {
     const auto& target = NonAdditiveMetricsData.Target;
     const auto& weights = NonAdditiveMetricsData.Weights;
-    for (ui32 idx = begin; idx < end; ++idx) {
-        auto approx = LoadApprox(idx);
-        for (ui32 metricId = 0; metricId < NonAdditiveMetrics.size(); ++metricId) {
-            NonAdditiveMetricPlots[metricId][idx] = NonAdditiveMetrics[metricId]->Eval(approx, target, weights, {}, 0, target.size(), Executor);
-        }
-        if (idx != 0) {
-            DeleteApprox(idx - 1);
-        }
+    StagedApproxes.FinishAdding();
+    // approxes of the previous pass are kept until this one is finished
+    const ui64 usedRam = StagedApproxes.GetRamUsage()
+        + (LastApproxes.empty() ? 0 : GetApproxRamUsage(LastApproxes[0].size(), LastApproxes.size()));
+    const ui32 parallelPlotLineCount = GetParallelPlotLineCount(target.size(), usedRam);
+    TVector<TVector<TVector<double>>> approxes;
+    for (ui32 groupBegin = begin; groupBegin < end; groupBegin += parallelPlotLineCount) {
+        const ui32 groupEnd = Min(end, groupBegin + parallelPlotLineCount);
+        approxes.resize(groupEnd - groupBegin);
+        NPar::ParallelFor(Executor, groupBegin, groupEnd, [&](ui32 idx) {
+            approxes[idx - groupBegin] = StagedApproxes.GetApprox(idx, target.size());
+        });
+        EvalNonAdditiveMetrics(approxes, target, weights, groupBegin);
     }
 }
 
@@ -314,6 +435,11 @@ void TMetricsPlotCalcer::ComputeNonAdditiveMetrics(const TVector<TProcessedDataP
     }
 
     auto startDocIdx = GetStartDocIdx(datasetParts);
+    // curApprox is kept besides the copies for plot lines
+    const ui32 parallelPlotLineCount = GetParallelPlotLineCount(
+        allTargets.size(),
+        GetApproxRamUsage(allTargets.size(), Model.ObliviousTrees.ApproxDimension));
+    TVector<TVector<TVector<double>>> approxes;
     for (ui32 iterationIndex = 0; iterationIndex < Iterations.size(); ++iterationIndex) {
         int end = Iterations[iterationIndex] + 1;
         for (int poolPartIdx = 0; poolPartIdx < modelCalcers.ysize(); ++poolPartIdx) {
@@ -321,63 +447,16 @@ void TMetricsPlotCalcer::ComputeNonAdditiveMetrics(const TVector<TProcessedDataP
             calcer.ApplyModelMulti(EPredictionType::InternalRawFormulaVal, begin, end, &FlatApproxBuffer, &NextApproxBuffer);
             Append(NextApproxBuffer, &curApprox, startDocIdx[poolPartIdx]);
         }
+        approxes.push_back(curApprox);
 
-        for (ui32 metricId = 0; metricId < NonAdditiveMetrics.size(); ++metricId) {
-            NonAdditiveMetricPlots[metricId][iterationIndex] = NonAdditiveMetrics[metricId]->Eval(curApprox, allTargets, allWeights, {}, 0, allTargets.size(), Executor);
+        if (approxes.size() == parallelPlotLineCount || iterationIndex + 1 == Iterations.size()) {
+            EvalNonAdditiveMetrics(approxes, allTargets, allWeights, iterationIndex + 1 - approxes.size());
+            approxes.clear();
         }
         begin = end;
     }
 }
 
-TString TMetricsPlotCalcer::GetApproxFileName(ui32 plotLineIndex) {
-    const ui32 plotSize = plotLineIndex + 1;
-    if (NonAdditiveMetricsData.ApproxFiles.size() < plotSize) {
-        NonAdditiveMetricsData.ApproxFiles.resize(plotSize);
-    }
-    if (NonAdditiveMetricsData.ApproxFiles[plotLineIndex].Empty()) {
-        if (!NFs::Exists(TmpDir)) {
-            NFs::MakeDirectory(TmpDir);
-            DeleteTmpDirOnExitFlag = true;
-        }
-        TString name = TStringBuilder() << CreateGuidAsString() << "_approx_" << plotLineIndex << ".tmp";
-        auto path = JoinFsPaths(TmpDir, name);
-        if (NFs::Exists(path)) {
-            CATBOOST_INFO_LOG << "Path already exists " << path << ". Will overwrite file" << Endl;
-            NFs::Remove(path);
-        }
-        NonAdditiveMetricsData.ApproxFiles[plotLineIndex] = path;
-    }
-    return NonAdditiveMetricsData.ApproxFiles[plotLineIndex];
-}
-
-void TMetricsPlotCalcer::SaveApproxToFile(ui32 plotLineIndex,
-                                          const TVector<TVector<double>>& approx) {
-    auto fileName = GetApproxFileName(plotLineIndex);
-    ui32 docCount = approx[0].size();
-    TFile file(fileName, EOpenModeFlag::ForAppend | EOpenModeFlag::OpenAlways);
-    TOFStream out(file);
-    TVector<double> line(approx.size());
-
-    for (ui32 i = 0; i < docCount; ++i) {
-        for (ui32 dim = 0; dim < approx.size(); ++dim) {
-            line[dim] = approx[dim][i];
-        }
-        ::Save(&out, line);
-    }
-}
-
-TVector<TVector<double>> TMetricsPlotCalcer::LoadApprox(ui32 plotLineIndex) {
-    TIFStream input(GetApproxFileName(plotLineIndex));
-    ui32 docCount = NonAdditiveMetricsData.Target.size();
-    TVector<TVector<double>> result(Model.ObliviousTrees.ApproxDimension, TVector<double>(docCount));
-    Load(docCount, &input, &result);
-    return result;
-}
-
-void TMetricsPlotCalcer::DeleteApprox(ui32 plotLineIndex) {
-    NFs::Remove(GetApproxFileName(plotLineIndex));
-}
-
 static inline ELossFunction ReadLossFunction(const TString& modelInfoParams) {
     return ParseLossType(ReadTJsonValue(modelInfoParams)["loss_function"]["type"].GetStringSafe());
 }
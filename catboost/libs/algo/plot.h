@@ -9,14 +9,78 @@
 #include <library/threading/local_executor/local_executor.h>
 
 #include <util/generic/fwd.h>
+#include <util/generic/hash.h>
 #include <util/generic/ptr.h>
 #include <util/generic/string.h>
 #include <util/generic/vector.h>
-#include <util/stream/input.h>
+#include <util/system/file.h>
+#include <util/system/filemap.h>
 #include <util/system/fs.h>
 #include <util/system/types.h>
 
 
+/* Approxes of several plot lines for objects of all dataset parts processed so far.
+ * Kept in memory while they fit into ramLimit, otherwise moved to a file in tmpDir
+ * which is memory-mapped for reading.
+ */
+class TStagedApproxStorage {
+public:
+    TStagedApproxStorage(ui32 approxDimension, const TString& tmpDir, ui64 ramLimit);
+    TStagedApproxStorage(TStagedApproxStorage&& other) = default;
+    ~TStagedApproxStorage();
+
+    // approx of the next dataset part for plotLineIndex, parts must come in the same order for all plot lines
+    void Add(ui32 plotLineIndex, const TVector<TVector<double>>& approx);
+
+    // must be called after the last Add and before GetApprox
+    void FinishAdding();
+
+    // thread-safe
+    TVector<TVector<double>> GetApprox(ui32 plotLineIndex, ui32 objectCount) const;
+
+    void Clear();
+
+    void SetRamLimit(ui64 ramLimit) {
+        RamLimit = ramLimit;
+    }
+
+    bool IsTmpDirCreated() const {
+        return TmpDirCreated;
+    }
+
+    // memory-mapped file is not counted
+    ui64 GetRamUsage() const {
+        return File ? 0 : DataSize * sizeof(double);
+    }
+
+private:
+    struct TBlock {
+        ui32 PlotLineIndex;
+        ui32 ObjectOffset;
+        ui32 ObjectCount;
+        ui64 DataOffset;
+    };
+
+    void MoveToFile();
+    const double* GetData() const;
+
+private:
+    ui32 ApproxDimension;
+    TString TmpDir;
+    ui64 RamLimit;
+    bool TmpDirCreated = false;
+
+    TVector<TBlock> Blocks;
+    THashMap<ui32, ui32> ObjectCountPerPlotLine;
+    ui64 DataSize = 0;
+
+    TVector<double> Data;
+    TString FileName;
+    THolder<TFile> File;
+    THolder<TFileMap> FileMap;
+};
+
+
 class TMetricsPlotCalcer {
 public:
     TMetricsPlotCalcer(
@@ -54,8 +118,15 @@ public:
     TMetricsPlotCalcer& SaveResult(const TString& resultDir, const TString& metricsFile, bool saveMetrics, bool saveStats);
     TVector<TVector<double>> GetMetricsScore();
 
+    // memory for approxes of non-additive metrics, which are moved to tmpDir if they do not fit into it
+    void SetApproxRamLimit(ui64 ramLimit) {
+        ApproxRamLimit = ramLimit;
+        StagedApproxes.SetRamLimit(ramLimit);
+    }
+
     void ClearTempFiles() {
-        if (DeleteTmpDirOnExitFlag) {
+        StagedApproxes.Clear();
+        if (DeleteTmpDirOnExitFlag || StagedApproxes.IsTmpDirCreated()) {
             NFs::RemoveRecursive(TmpDir);
         }
     }
@@ -106,6 +177,16 @@ private:
 
     void ComputeNonAdditiveMetrics(ui32 begin, ui32 end);
 
+    void EvalNonAdditiveMetrics(
+        const TVector<TVector<TVector<double>>>& approxes,
+        TConstArrayRef<float> target,
+        TConstArrayRef<float> weights,
+        ui32 firstPlotLineIndex
+    );
+
+    // number of plot line approxes that fit into ApproxRamLimit besides usedRam bytes, at least 1
+    ui32 GetParallelPlotLineCount(ui32 docCount, ui64 usedRam) const;
+
     void ComputeAdditiveMetric(
         const TVector<TVector<double>>& approx,
         TConstArrayRef<float> target,
@@ -151,18 +232,10 @@ private:
 private:
 
     struct TNonAdditiveMetricData {
-        TVector<TString> ApproxFiles;
         TVector<float> Target;
         TVector<float> Weights;
     };
 
-    TString GetApproxFileName(ui32 plotLineIndex);
-
-    void SaveApproxToFile(ui32 plotLineIndex, const TVector<TVector<double>>& approx);
-
-    TVector<TVector<double>> LoadApprox(ui32 plotLineIndex);
-    void DeleteApprox(ui32 plotLineIndex);
-
 private:
     const TFullModel& Model;
     NPar::TLocalExecutor& Executor;
@@ -172,6 +245,7 @@ private:
     ui32 Step;
     TString TmpDir;
     bool DeleteTmpDirOnExitFlag = false;
+    ui64 ApproxRamLimit;
 
     TVector<const IMetric*> AdditiveMetrics;
     TVector<const IMetric*> NonAdditiveMetrics;
@@ -183,9 +257,11 @@ private:
 
     ui32 ProcessedIterationsCount;
     ui32 ProcessedIterationsStep;
-    THolder<IInputStream> LastApproxes;
 
     TNonAdditiveMetricData NonAdditiveMetricsData;
+    TStagedApproxStorage StagedApproxes;
+    TVector<TVector<double>> LastApproxes;
+    ui32 LastApproxesOffset = 0;
 
     TVector<double> FlatApproxBuffer;
     TVector<TVector<double>> CurApproxBuffer;
@@ -2,6 +2,12 @@
 
 #include <catboost/libs/helpers/restorable_rng.h>
 
+#include <util/generic/algorithm.h>
+#include <util/generic/ymath.h>
+
+#include <functional>
+#include <limits>
+
 THolder<IDerCalcer> BuildError(
     const NCatboostOptions::TCatBoostOptions& params,
     const TMaybe<TCustomObjectiveDescriptor>& descriptor
@@ -155,6 +161,121 @@ static void GenerateBernoulliWeightsForPairs(
     }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
 }
 
+void GenerateMvsSampleWeights(
+    TConstArrayRef<float> gradientNorms,
+    float takenFraction,
+    ui64 randSeed,
+    NPar::TLocalExecutor* localExecutor,
+    TArrayRef<float> sampleWeights
+) {
+    const float infinity = std::numeric_limits<float>::infinity();
+
+    TVector<float> finiteNorms;
+    finiteNorms.reserve(gradientNorms.size());
+    double finiteNormsSum = 0.0;
+    for (float norm : gradientNorms) {
+        if (norm != infinity) {
+            finiteNorms.push_back(norm);
+            finiteNormsSum += norm;
+        }
+    }
+    const int alwaysTakenCount = gradientNorms.size() - finiteNorms.size();
+
+    // regularized norm sqrt(g^2 + lambda) keeps probabilities of objects with tiny gradients nonzero,
+    // lambda is the squared mean gradient norm; if all gradients are zero sampling is uniform
+    const double lambda = finiteNorms.empty() ? 0.0 : Sqr(finiteNormsSum / finiteNorms.size());
+    const auto regularize = [lambda] (float norm) -> float {
+        return lambda > 0.0 ? sqrt(Sqr((double)norm) + lambda) : 1.0f;
+    };
+    for (float& norm : finiteNorms) {
+        norm = regularize(norm);
+    }
+    Sort(finiteNorms.begin(), finiteNorms.end(), std::greater<float>());
+
+    /* If k largest objects are taken unconditionally, the others are taken with probability norm / threshold
+     * and expected sample size is k + tailSum / threshold, so threshold = tailSum / (sampleSize - k).
+     * The first k for which the (k+1)-th norm doesn't exceed this threshold gives the solution.
+     */
+    const double restSampleSize = (double)takenFraction * gradientNorms.size() - alwaysTakenCount;
+    double threshold = infinity;
+    if (!finiteNorms.empty() && restSampleSize > 0) {
+        threshold = finiteNorms.back(); // enough room for all objects
+        double tailSum = Accumulate(finiteNorms, 0.0);
+        for (int k = 0; k < finiteNorms.ysize(); ++k) {
+            if (restSampleSize <= k) {
+                threshold = finiteNorms[k - 1];
+                break;
+            }
+            const double candidateThreshold = tailSum / (restSampleSize - k);
+            if (finiteNorms[k] <= candidateThreshold) {
+                threshold = candidateThreshold;
+                break;
+            }
+            tailSum -= finiteNorms[k];
+        }
+    }
+
+    NPar::TLocalExecutor::TExecRangeParams blockParams(0, gradientNorms.size());
+    blockParams.SetBlockSize(4000);
+    const float* gradientNormsData = gradientNorms.data();
+    float* sampleWeightsData = sampleWeights.data();
+    localExecutor->ExecRange([&](int blockIdx) {
+        TRestorableFastRng64 rand(randSeed + blockIdx);
+        rand.Advance(10); // reduce correlation between RNGs in different threads
+        NPar::TLocalExecutor::BlockedLoopBody(blockParams, [=, &rand](int i) {
+            if (gradientNormsData[i] == infinity) {
+                sampleWeightsData[i] = 1.0f;
+                return;
+            }
+            const double norm = regularize(gradientNormsData[i]);
+            if (norm >= threshold) {
+                sampleWeightsData[i] = 1.0f;
+            } else {
+                const double probability = norm / threshold;
+                sampleWeightsData[i] = rand.GenRandReal1() < probability ? 1.0 / probability : 0.0f;
+            }
+        })(blockIdx);
+    }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
+}
+
+static void GenerateGradientBasedWeights(
+    int learnSampleCount,
+    float takenFraction,
+    EBoostingType boostingType,
+    NPar::TLocalExecutor* localExecutor,
+    TRestorableFastRng64* rand,
+    TFold* fold
+) {
+    if (takenFraction == 1.0f) {
+        Fill(fold->SampleWeights.begin(), fold->SampleWeights.end(), 1);
+        return;
+    }
+
+    // objects outside of all tails (first body in ordered boosting) have no derivatives, always take them
+    TVector<float> gradientNorms(learnSampleCount, std::numeric_limits<float>::infinity());
+    const int approxDimension = fold->GetApproxDimension();
+    for (const TFold::TBodyTail& bt : fold->BodyTailArr) {
+        const int begin = IsPlainMode(boostingType) ? 0 : bt.BodyFinish;
+        float* gradientNormsData = gradientNorms.data();
+        localExecutor->ExecRange([&, gradientNormsData](int z) {
+            double squaredNorm = 0.0;
+            for (int dim = 0; dim < approxDimension; ++dim) {
+                squaredNorm += Sqr(bt.WeightedDerivatives[dim][z]);
+            }
+            gradientNormsData[z] = sqrt(squaredNorm);
+        }, NPar::TLocalExecutor::TExecRangeParams(begin, bt.TailFinish).SetBlockSize(4000)
+         , NPar::TLocalExecutor::WAIT_COMPLETE);
+    }
+
+    GenerateMvsSampleWeights(
+        gradientNorms,
+        takenFraction,
+        rand->GenRand(),
+        localExecutor,
+        MakeArrayRef(fold->SampleWeights.data(), learnSampleCount)
+    );
+}
+
 static void CalcWeightedData(
     int learnSampleCount,
     EBoostingType boostingType,
@@ -230,6 +351,17 @@ void Bootstrap(
                 Fill(fold->SampleWeights.begin(), fold->SampleWeights.end(), 1);
             }
             break;
+        case EBootstrapType::MVS:
+            CB_ENSURE(!isPairwiseScoring, "MVS bootstrap is not supported for pairwise scoring loss functions");
+            GenerateGradientBasedWeights(
+                learnSampleCount,
+                takenFraction,
+                params.BoostingOptions->BoostingType.Get(),
+                localExecutor,
+                rand,
+                fold
+            );
+            break;
         default:
             CB_ENSURE(false, "Not supported bootstrap type on CPU: " << bootstrapType);
     }
@@ -256,10 +388,14 @@ void CalcWeightedDerivatives(
     if (error.GetErrorType() == EErrorType::QuerywiseError || error.GetErrorType() == EErrorType::PairwiseError) {
         TVector<TQueryInfo> recalculatedQueriesInfo;
         const bool shouldGenerateYetiRankPairs = ShouldGenerateYetiRankPairs(params.LossFunctionDescription->GetLossFunction());
+        // In case of YetiRankPairwise loss function generated pairs are stored in the fold for tree structure building,
+        // so they are regenerated in place reusing competitors of the previous iteration.
+        const bool storeGeneratedPairs = params.LossFunctionDescription->GetLossFunction() == ELossFunction::YetiRankPairwise;
+        TVector<TQueryInfo>* generatedQueriesInfo = storeGeneratedPairs ? &takenFold->LearnQueriesInfo : &recalculatedQueriesInfo;
         if (shouldGenerateYetiRankPairs) {
-            YetiRankRecalculation(*takenFold, bt, params, randomSeed, localExecutor, &recalculatedQueriesInfo, &bt.PairwiseWeights);
+            YetiRankRecalculation(*takenFold, bt, params, randomSeed, localExecutor, generatedQueriesInfo, &bt.PairwiseWeights);
         }
-        const TVector<TQueryInfo>& queriesInfo = shouldGenerateYetiRankPairs ? recalculatedQueriesInfo : takenFold->LearnQueriesInfo;
+        const TVector<TQueryInfo>& queriesInfo = shouldGenerateYetiRankPairs ? *generatedQueriesInfo : takenFold->LearnQueriesInfo;
 
         const int tailQueryFinish = bt.TailQueryFinish;
         TVector<TDers> ders((*weightedDerivatives)[0].ysize());
@@ -267,11 +403,7 @@ void CalcWeightedDerivatives(
         for (int docId = 0; docId < ders.ysize(); ++docId) {
             (*weightedDerivatives)[0][docId] = ders[docId].Der1;
         }
-        if (params.LossFunctionDescription->GetLossFunction() == ELossFunction::YetiRankPairwise) {
-            // In case of YetiRankPairwise loss function we need to store generated pairs for tree structure building.
-            Y_ASSERT(takenFold->BodyTailArr.size() == 1);
-            takenFold->LearnQueriesInfo.swap(recalculatedQueriesInfo);
-        }
+        Y_ASSERT(!storeGeneratedPairs || takenFold->BodyTailArr.size() == 1);
     } else {
         const int tailFinish = bt.TailFinish;
         const int approxDimension = approx.ysize();
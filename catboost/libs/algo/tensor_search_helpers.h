@@ -14,6 +14,7 @@
 #include <library/binsaver/bin_saver.h>
 #include <library/threading/local_executor/local_executor.h>
 
+#include <util/generic/array_ref.h>
 #include <util/generic/vector.h>
 
 
@@ -48,6 +49,19 @@ void Bootstrap(const NCatboostOptions::TCatBoostOptions& params,
                NPar::TLocalExecutor* localExecutor,
                TRestorableFastRng64* rand);
 
+/* Minimal variance sampling: object i is taken with probability p_i = min(1, n_i / threshold)
+ * and gets sample weight 1 / p_i, so sums of derivatives stay unbiased.
+ * n_i is the regularized norm sqrt(|g_i|^2 + lambda) of object gradient, infinite gradient norm means
+ * that object is always taken. Threshold is chosen so that expected sample size is
+ * takenFraction * gradientNorms.size().
+ */
+void GenerateMvsSampleWeights(
+    TConstArrayRef<float> gradientNorms,
+    float takenFraction,
+    ui64 randSeed,
+    NPar::TLocalExecutor* localExecutor,
+    TArrayRef<float> sampleWeights);
+
 THolder<IDerCalcer> BuildError(const NCatboostOptions::TCatBoostOptions& params, const TMaybe<TCustomObjectiveDescriptor>&);
 
 void CalcWeightedDerivatives(
@@ -19,6 +19,15 @@ TErrorTracker BuildErrorTracker(EMetricBestValue bestValueType, double bestPossi
     return CreateErrorTracker(odOptions, bestPossibleValue, bestValueType, hasTest);
 }
 
+// approx deltas allocated by UpdateLearningFold
+static ui64 EstimateUpdateLearningFoldMemoryUsage(const TFold& fold) {
+    ui64 result = 0;
+    for (const auto& bodyTail : fold.BodyTailArr) {
+        result += (ui64)bodyTail.TailFinish * fold.GetApproxDimension() * sizeof(double);
+    }
+    return result;
+}
+
 static void UpdateLearningFold(
     const NCB::TTrainingForCPUDataProviders& data,
     const IDerCalcer& error,
@@ -58,12 +67,16 @@ void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnCont
     const int foldCount = ctx->LearnProgress.Folds.ysize();
     const int currentIteration = ctx->LearnProgress.TreeStruct.ysize();
     const double modelLength = currentIteration * ctx->Params.BoostingOptions->LearningRate;
+    const bool compactFolds = ctx->Params.BoostingOptions->SinglePrecisionFoldApproxes;
 
     CheckInterrupted(); // check after long-lasting operation
 
     TSplitTree bestSplitTree;
     {
         TFold* takenFold = &ctx->LearnProgress.Folds[ctx->Rand.GenRand() % foldCount];
+        if (compactFolds) {
+            takenFold->Expand(/*allocateDerivatives*/ true, ctx->LocalExecutor);
+        }
         const TVector<ui64> randomSeeds = GenRandUI64Vector(takenFold->BodyTailArr.ysize(), ctx->Rand.GenRand());
         if (ctx->Params.SystemOptions->IsSingleHost()) {
             ctx->LocalExecutor->ExecRange([&](int bodyTailId) {
@@ -83,6 +96,9 @@ void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnCont
             ctx,
             &bestSplitTree
         );
+        if (compactFolds) {
+            takenFold->Compact(ctx->LocalExecutor);
+        }
     }
     CheckInterrupted(); // check after long-lasting operation
     {
@@ -139,9 +155,27 @@ void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnCont
 
         if (ctx->Params.SystemOptions->IsSingleHost()) {
             const TVector<ui64> randomSeeds = GenRandUI64Vector(foldCount, ctx->Rand.GenRand());
-            ctx->LocalExecutor->ExecRange([&](int foldId) {
-                UpdateLearningFold(data, *error, bestSplitTree, randomSeeds[foldId], trainFolds[foldId], ctx);
-            }, 0, foldCount, NPar::TLocalExecutor::WAIT_COMPLETE);
+            // folds that do not fit into used_ram_limit together are updated in several rounds
+            const ui64 approxDeltaMemoryUsage = EstimateUpdateLearningFoldMemoryUsage(*trainFolds[0]);
+            int foldParallelism = 1;
+            if (!compactFolds) {
+                foldParallelism = ctx->MemoryBudget.GetParallelism(approxDeltaMemoryUsage, foldCount);
+            } else if (ctx->MemoryBudget.IsLimited()) {
+                // compact folds also hold expanded double approxes of the same size while they are updated,
+                // without a limit they are expanded one at a time to keep peak memory low
+                foldParallelism = ctx->MemoryBudget.GetParallelism(2 * approxDeltaMemoryUsage, foldCount);
+            }
+            for (int foldBegin = 0; foldBegin < foldCount; foldBegin += foldParallelism) {
+                ctx->LocalExecutor->ExecRange([&](int foldId) {
+                    if (compactFolds) {
+                        trainFolds[foldId]->Expand(/*allocateDerivatives*/ false, ctx->LocalExecutor);
+                    }
+                    UpdateLearningFold(data, *error, bestSplitTree, randomSeeds[foldId], trainFolds[foldId], ctx);
+                    if (compactFolds) {
+                        trainFolds[foldId]->Compact(ctx->LocalExecutor);
+                    }
+                }, foldBegin, Min(foldBegin + foldParallelism, foldCount), NPar::TLocalExecutor::WAIT_COMPLETE);
+            }
 
             profile.AddOperation("CalcApprox tree struct and update tree structure approx");
             CheckInterrupted(); // check after long-lasting operation
@@ -188,4 +222,5 @@ void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnCont
         profile.AddOperation("Update final approxes");
         CheckInterrupted(); // check after long-lasting operation
     }
+    ctx->UpdateMemoryUsage();
 }
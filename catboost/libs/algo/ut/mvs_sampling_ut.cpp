@@ -0,0 +1,83 @@
+#include <catboost/libs/algo/tensor_search_helpers.h>
+
+#include <library/unittest/registar.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+#include <limits>
+
+
+static int CountTaken(const TVector<float>& sampleWeights) {
+    return CountIf(sampleWeights, [] (float weight) { return weight != 0.0f; });
+}
+
+Y_UNIT_TEST_SUITE(MvsSamplingTest) {
+    Y_UNIT_TEST(ExpectedSampleSizeAndUnbiasedSums) {
+        const int objectCount = 100000;
+        const float takenFraction = 0.2f;
+        TFastRng64 rng(0);
+        TVector<float> gradientNorms(objectCount);
+        for (auto& norm : gradientNorms) {
+            // heavy tail, so that some objects are always taken, and a share of zero gradients
+            norm = rng.GenRandReal1() < 0.1 ? 0.0f : -log(rng.GenRandReal1() + 1e-100) * 2;
+        }
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+        TVector<float> sampleWeights(objectCount);
+        GenerateMvsSampleWeights(gradientNorms, takenFraction, 42, &localExecutor, sampleWeights);
+
+        UNIT_ASSERT_DOUBLES_EQUAL(CountTaken(sampleWeights), takenFraction * objectCount, 0.01 * objectCount);
+
+        double normsSum = 0.0;
+        double sampledNormsSum = 0.0;
+        for (auto i : xrange(objectCount)) {
+            normsSum += gradientNorms[i];
+            sampledNormsSum += gradientNorms[i] * sampleWeights[i];
+        }
+        UNIT_ASSERT_DOUBLES_EQUAL(sampledNormsSum / normsSum, 1.0, 0.02);
+    }
+
+    Y_UNIT_TEST(ZeroGradientsHavePositiveProbability) {
+        const int objectCount = 10000;
+        TVector<float> gradientNorms(objectCount, 0.0f);
+        for (auto i : xrange(objectCount / 2)) {
+            gradientNorms[i] = 1.0f;
+        }
+
+        NPar::TLocalExecutor localExecutor;
+        TVector<float> sampleWeights(objectCount);
+        GenerateMvsSampleWeights(gradientNorms, 0.3f, 42, &localExecutor, sampleWeights);
+
+        int takenWithZeroGradient = 0;
+        for (auto i : xrange(objectCount / 2, objectCount)) {
+            takenWithZeroGradient += sampleWeights[i] != 0.0f;
+        }
+        UNIT_ASSERT(takenWithZeroGradient > 0);
+        UNIT_ASSERT_DOUBLES_EQUAL(CountTaken(sampleWeights), 0.3 * objectCount, 0.03 * objectCount);
+    }
+
+    Y_UNIT_TEST(AllZeroGradientsAreSampledUniformly) {
+        const int objectCount = 10000;
+        const float takenFraction = 0.3f;
+        TVector<float> gradientNorms(objectCount, 0.0f);
+        // objects without derivatives are always taken
+        gradientNorms[0] = gradientNorms[1] = std::numeric_limits<float>::infinity();
+
+        NPar::TLocalExecutor localExecutor;
+        TVector<float> sampleWeights(objectCount);
+        GenerateMvsSampleWeights(gradientNorms, takenFraction, 42, &localExecutor, sampleWeights);
+
+        UNIT_ASSERT_VALUES_EQUAL(sampleWeights[0], 1.0f);
+        UNIT_ASSERT_VALUES_EQUAL(sampleWeights[1], 1.0f);
+        const double expectedWeight = (objectCount - 2) / (takenFraction * objectCount - 2);
+        for (auto i : xrange(2, objectCount)) {
+            if (sampleWeights[i] != 0.0f) {
+                UNIT_ASSERT_DOUBLES_EQUAL(sampleWeights[i], expectedWeight, 1e-4);
+            }
+        }
+        UNIT_ASSERT_DOUBLES_EQUAL(CountTaken(sampleWeights), takenFraction * objectCount, 0.03 * objectCount);
+    }
+}
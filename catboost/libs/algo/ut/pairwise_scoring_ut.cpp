@@ -3,6 +3,8 @@
 #include <catboost/libs/algo/pairwise_leaves_calculation.h>
 #include <catboost/libs/helpers/query_info_helper.h>
 
+#include <util/random/fast.h>
+
 static double CalculateScore(const TVector<double>& avrg, const TVector<double>& sumDer, const TArray2D<double>& sumWeights) {
     double score = 0;
     for (int x = 0; x < sumDer.ysize(); ++x) {
@@ -185,4 +187,37 @@ Y_UNIT_TEST_SUITE(PairwiseScoringTest) {
         UNIT_ASSERT_DOUBLES_EQUAL(scoreBins1[1].DP, scoreBins2[1].DP, 1e-6);
         UNIT_ASSERT_DOUBLES_EQUAL(scoreBins1[2].DP, scoreBins2[2].DP, 1e-6);
     }
+
+    Y_UNIT_TEST(PairwiseScoringTestManyLeavesAndBuckets) {
+        const int leafCount = 8;
+        const int bucketCount = 11;
+        const int docCount = 200;
+        TFastRng64 rand(0);
+        TVector<TIndexType> singleIdx(docCount);
+        TVector<double> ders(docCount);
+        for (int docId = 0; docId < docCount; ++docId) {
+            singleIdx[docId] = rand.Uniform(leafCount * bucketCount);
+            ders[docId] = rand.GenRandReal1() - 0.5;
+        }
+        TVector<TQueryInfo> queriesInfo = {{0, (ui32)docCount}};
+        TVector<TVector<TCompetitor>>& comps = queriesInfo[0].Competitors;
+        comps.resize(docCount);
+        for (int pairId = 0; pairId < 3 * docCount; ++pairId) {
+            comps[rand.Uniform(docCount)].push_back({(ui32)rand.Uniform(docCount), (float)rand.GenRandReal1()});
+        }
+        const ESplitType splitType = ESplitType::FloatFeature;
+        const float l2DiagReg = 0.3;
+        const float pairwiseNonDiagReg = 0.1;
+
+        TVector<TScoreBin> scoreBins1(bucketCount - 1), scoreBins2(bucketCount - 1);
+        {
+            TPairwiseStats pairwiseStats = CalcPairwiseStats(singleIdx, MakeArrayRef(ders.data(), ders.size()), queriesInfo, leafCount, bucketCount);
+            CalculatePairwiseScore(pairwiseStats, bucketCount, splitType, l2DiagReg, pairwiseNonDiagReg, &scoreBins1);
+        }
+        CalculatePairwiseScoreSimple(singleIdx, MakeArrayRef(ders.data(), ders.size()), queriesInfo, leafCount, bucketCount, splitType, l2DiagReg, pairwiseNonDiagReg, &scoreBins2);
+
+        for (int splitId = 0; splitId < bucketCount - 1; ++splitId) {
+            UNIT_ASSERT_DOUBLES_EQUAL(scoreBins1[splitId].DP, scoreBins2[splitId].DP, 1e-6);
+        }
+    }
 }
@@ -0,0 +1,121 @@
+#include <catboost/libs/algo/yetirank_helpers.h>
+
+#include <library/unittest/registar.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+#include <util/random/fast.h>
+
+#include <numeric>
+
+
+// dense pair weights matrix implementation YetiRank pairs generation was optimized from
+static void GenerateYetiRankPairsForQueryReference(
+    const float* relevs,
+    const double* expApproxes,
+    float queryWeight,
+    ui32 querySize,
+    int permutationCount,
+    double decaySpeed,
+    ui64 randomSeed,
+    TVector<TVector<TCompetitor>>* competitors
+) {
+    TFastRng64 rand(randomSeed);
+    TVector<TVector<TCompetitor>>& competitorsRef = *competitors;
+    competitorsRef.clear();
+    competitorsRef.resize(querySize);
+
+    TVector<int> indices(querySize);
+    TVector<TVector<float>> competitorsWeights(querySize, TVector<float>(querySize));
+    for (int permutationIndex = 0; permutationIndex < permutationCount; ++permutationIndex) {
+        std::iota(indices.begin(), indices.end(), 0);
+        TVector<double> bootstrappedApprox(expApproxes, expApproxes + querySize);
+        for (ui32 docId = 0; docId < querySize; ++docId) {
+            const float uniformValue = rand.GenRandReal1();
+            bootstrappedApprox[docId] *= uniformValue / (1.000001f - uniformValue);
+        }
+
+        Sort(indices, [&](int i, int j) {
+            return bootstrappedApprox[i] > bootstrappedApprox[j];
+        });
+
+        double decayCoefficient = 1;
+        for (ui32 docId = 1; docId < querySize; ++docId) {
+            const int firstCandidate = indices[docId - 1];
+            const int secondCandidate = indices[docId];
+            const double magicConst = 0.15;
+
+            const float pairWeight = magicConst * decayCoefficient * Abs(relevs[firstCandidate] - relevs[secondCandidate]);
+            if (relevs[firstCandidate] > relevs[secondCandidate]) {
+                competitorsWeights[firstCandidate][secondCandidate] += pairWeight;
+            } else if (relevs[firstCandidate] < relevs[secondCandidate]) {
+                competitorsWeights[secondCandidate][firstCandidate] += pairWeight;
+            }
+            decayCoefficient *= decaySpeed;
+        }
+    }
+
+    for (ui32 winnerIndex = 0; winnerIndex < querySize; ++winnerIndex) {
+        for (ui32 loserIndex = 0; loserIndex < querySize; ++loserIndex) {
+            const float competitorsWeight = queryWeight * competitorsWeights[winnerIndex][loserIndex] / permutationCount;
+            if (competitorsWeight != 0) {
+                competitorsRef[winnerIndex].push_back({loserIndex, competitorsWeight});
+            }
+        }
+    }
+}
+
+Y_UNIT_TEST_SUITE(YetiRankPairsGenerationTest) {
+    Y_UNIT_TEST(PairsAreSameAsInDenseImplementation) {
+        TFastRng64 rng(0);
+        const int permutationCount = 10;
+        const double decaySpeed = 0.85;
+        // competitors storage is kept between queries as in training
+        TVector<TVector<TCompetitor>> competitors;
+        TVector<TVector<TCompetitor>> expectedCompetitors;
+        for (auto queryIdx : xrange(200)) {
+            const ui32 querySize = 1 + rng.Uniform(queryIdx < 100 ? 8 : 60);
+            TVector<float> relevs(querySize);
+            TVector<double> expApproxes(querySize);
+            for (auto docId : xrange(querySize)) {
+                // few relevance levels and repeated approxes give ties in both
+                relevs[docId] = rng.Uniform(4);
+                expApproxes[docId] = exp(rng.Uniform(5) * 0.5 - 1.0);
+            }
+            const float queryWeight = 0.5f + rng.GenRandReal1();
+            const ui64 randomSeed = rng.GenRand();
+
+            GenerateYetiRankPairsForQueryReference(
+                relevs.data(),
+                expApproxes.data(),
+                queryWeight,
+                querySize,
+                permutationCount,
+                decaySpeed,
+                randomSeed,
+                &expectedCompetitors);
+            GenerateYetiRankPairsForQuery(
+                relevs.data(),
+                expApproxes.data(),
+                queryWeight,
+                querySize,
+                permutationCount,
+                decaySpeed,
+                randomSeed,
+                &competitors);
+
+            UNIT_ASSERT_VALUES_EQUAL(competitors.size(), expectedCompetitors.size());
+            for (auto docId : xrange(querySize)) {
+                UNIT_ASSERT_VALUES_EQUAL(competitors[docId].size(), expectedCompetitors[docId].size());
+                for (auto competitorIdx : xrange(competitors[docId].size())) {
+                    UNIT_ASSERT_VALUES_EQUAL(competitors[docId][competitorIdx].Id, expectedCompetitors[docId][competitorIdx].Id);
+                    UNIT_ASSERT_EQUAL(competitors[docId][competitorIdx].Weight, expectedCompetitors[docId][competitorIdx].Weight);
+                    UNIT_ASSERT_EQUAL(
+                        competitors[docId][competitorIdx].SampleWeight,
+                        expectedCompetitors[docId][competitorIdx].SampleWeight);
+                }
+            }
+        }
+    }
+}
@@ -5,6 +5,28 @@
 
 #include <util/generic/vector.h>
 
+#include <tuple>
+
+namespace {
+    struct TYetiRankPairUpdate {
+        ui32 Winner;
+        ui32 Loser;
+        ui32 Order; // keeps accumulation order of equal pairs the same as in the permutation loop
+        float Weight;
+
+        bool operator<(const TYetiRankPairUpdate& rhs) const {
+            return std::tie(Winner, Loser, Order) < std::tie(rhs.Winner, rhs.Loser, rhs.Order);
+        }
+    };
+
+    // Buffers reused between queries processed by one thread.
+    struct TYetiRankPairsScratch {
+        TVector<double> BootstrapFactors; // [permutationCount * querySize]
+        TVector<std::pair<double, ui32>> BootstrappedApprox; // (approx, docId)
+        TVector<TYetiRankPairUpdate> PairUpdates;
+    };
+}
+
 static void GenerateYetiRankPairsForQuery(
     const float* relevs,
     const double* expApproxes,
@@ -13,55 +35,104 @@ static void GenerateYetiRankPairsForQuery(
     int permutationCount,
     double decaySpeed,
     ui64 randomSeed,
+    TYetiRankPairsScratch* scratch,
     TVector<TVector<TCompetitor>>* competitors
 ) {
-    TFastRng64 rand(randomSeed);
+    // keep allocated competitors storage from previous iterations
     TVector<TVector<TCompetitor>>& competitorsRef = *competitors;
-    competitorsRef.clear();
     competitorsRef.resize(querySize);
+    for (auto& docCompetitors : competitorsRef) {
+        docCompetitors.clear();
+    }
+    if (querySize < 2) {
+        return;
+    }
 
-    TVector<int> indices(querySize);
-    TVector<TVector<float>> competitorsWeights(querySize, TVector<float>(querySize));
+    // all random numbers for the query are generated at once, in the same order as before
+    TFastRng64 rand(randomSeed);
+    TVector<double>& bootstrapFactors = scratch->BootstrapFactors;
+    bootstrapFactors.yresize(permutationCount * querySize);
+    for (auto& factor : bootstrapFactors) {
+        // uniform value and factor are computed in single precision, as before
+        const float uniformValue = rand.GenRandReal1();
+        // TODO(nikitxskv): try to experiment with different bootstraps.
+        factor = uniformValue / (1.000001f - uniformValue);
+    }
+
+    TVector<std::pair<double, ui32>>& bootstrappedApprox = scratch->BootstrappedApprox;
+    bootstrappedApprox.yresize(querySize);
+    TVector<TYetiRankPairUpdate>& pairUpdates = scratch->PairUpdates;
+    pairUpdates.clear();
     for (int permutationIndex = 0; permutationIndex < permutationCount; ++permutationIndex) {
-        std::iota(indices.begin(), indices.end(), 0);
-        TVector<double> bootstrappedApprox(expApproxes, expApproxes + querySize);
+        const double* permutationFactors = bootstrapFactors.data() + permutationIndex * querySize;
         for (ui32 docId = 0; docId < querySize; ++docId) {
-            const float uniformValue = rand.GenRandReal1();
-            // TODO(nikitxskv): try to experiment with different bootstraps.
-            bootstrappedApprox[docId] *= uniformValue / (1.000001f - uniformValue);
+            bootstrappedApprox[docId] = {expApproxes[docId] * permutationFactors[docId], docId};
         }
 
-        Sort(indices, [&](int i, int j) {
-            return bootstrappedApprox[i] > bootstrappedApprox[j];
+        // keys are stored next to doc ids, so small groups are sorted by insertion sort without indirection
+        Sort(bootstrappedApprox.begin(), bootstrappedApprox.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.first > rhs.first;
         });
 
         double decayCoefficient = 1;
         for (ui32 docId = 1; docId < querySize; ++docId) {
-            const int firstCandidate = indices[docId - 1];
-            const int secondCandidate = indices[docId];
+            const ui32 firstCandidate = bootstrappedApprox[docId - 1].second;
+            const ui32 secondCandidate = bootstrappedApprox[docId].second;
             const double magicConst = 0.15; // Like in GPU
 
             const float pairWeight = magicConst * decayCoefficient * Abs(relevs[firstCandidate] - relevs[secondCandidate]);
+            const ui32 order = pairUpdates.size();
             if (relevs[firstCandidate] > relevs[secondCandidate]) {
-                competitorsWeights[firstCandidate][secondCandidate] += pairWeight;
+                pairUpdates.push_back({firstCandidate, secondCandidate, order, pairWeight});
             } else if (relevs[firstCandidate] < relevs[secondCandidate]) {
-                competitorsWeights[secondCandidate][firstCandidate] += pairWeight;
+                pairUpdates.push_back({secondCandidate, firstCandidate, order, pairWeight});
             }
             decayCoefficient *= decaySpeed;
         }
     }
 
-    // TODO(nikitxskv): Can be optimized
-    for (ui32 winnerIndex = 0; winnerIndex < querySize; ++winnerIndex) {
-        for (ui32 loserIndex = 0; loserIndex < querySize; ++loserIndex) {
-            const float competitorsWeight = queryWeight * competitorsWeights[winnerIndex][loserIndex] / permutationCount;
-            if (competitorsWeight != 0) {
-                competitorsRef[winnerIndex].push_back({loserIndex, competitorsWeight});
-            }
+    Sort(pairUpdates.begin(), pairUpdates.end());
+    for (size_t updateIdx = 0; updateIdx < pairUpdates.size();) {
+        const ui32 winnerIndex = pairUpdates[updateIdx].Winner;
+        const ui32 loserIndex = pairUpdates[updateIdx].Loser;
+        float pairWeightSum = 0;
+        for (; updateIdx < pairUpdates.size()
+            && pairUpdates[updateIdx].Winner == winnerIndex
+            && pairUpdates[updateIdx].Loser == loserIndex; ++updateIdx)
+        {
+            pairWeightSum += pairUpdates[updateIdx].Weight;
+        }
+        const float competitorsWeight = queryWeight * pairWeightSum / permutationCount;
+        if (competitorsWeight != 0) {
+            competitorsRef[winnerIndex].push_back({loserIndex, competitorsWeight});
         }
     }
 }
 
+void GenerateYetiRankPairsForQuery(
+    const float* relevs,
+    const double* expApproxes,
+    float queryWeight,
+    ui32 querySize,
+    int permutationCount,
+    double decaySpeed,
+    ui64 randomSeed,
+    TVector<TVector<TCompetitor>>* competitors
+) {
+    TYetiRankPairsScratch scratch;
+    GenerateYetiRankPairsForQuery(
+        relevs,
+        expApproxes,
+        queryWeight,
+        querySize,
+        permutationCount,
+        decaySpeed,
+        randomSeed,
+        &scratch,
+        competitors
+    );
+}
+
 static void UpdatePairsForYetiRank(
     const TVector<double>& approxes,
     const TVector<float>& relevances,
@@ -81,6 +152,7 @@ static void UpdatePairsForYetiRank(
     const TVector<ui64> randomSeeds = GenRandUI64Vector(blockCount, randomSeed);
     NPar::ParallelFor(*localExecutor, 0, blockCount, [&](int blockId) {
         TFastRng64 rand(randomSeeds[blockId]);
+        TYetiRankPairsScratch scratch;
         const int from = blockId * blockSize;
         const int to = Min<int>((blockId + 1) * blockSize, queryInfoSize);
         for (int queryIndex = from; queryIndex < to; ++queryIndex) {
@@ -93,6 +165,7 @@ static void UpdatePairsForYetiRank(
                 permutationCount,
                 decaySpeed,
                 rand.GenRand(),
+                &scratch,
                 &queryInfoRef.Competitors
             );
         }
@@ -108,7 +181,10 @@ void YetiRankRecalculation(
     TVector<TQueryInfo>* recalculatedQueriesInfo,
     TVector<float>* recalculatedPairwiseWeights
 ) {
-    *recalculatedQueriesInfo = ff.LearnQueriesInfo;
+    // for YetiRankPairwise pairs are regenerated in place in the fold's queries info
+    if (recalculatedQueriesInfo != &ff.LearnQueriesInfo) {
+        *recalculatedQueriesInfo = ff.LearnQueriesInfo;
+    }
     UpdatePairsForYetiRank(
         bt.Approx[0],
         ff.LearnTarget,
@@ -2,6 +2,20 @@
 
 #include "learn_context.h"
 
+#include <catboost/libs/data_types/pair.h>
+
+// Generates competitors of one query for YetiRank, competitors allocated by previous calls are reused.
+void GenerateYetiRankPairsForQuery(
+    const float* relevs,
+    const double* expApproxes,
+    float queryWeight,
+    ui32 querySize,
+    int permutationCount,
+    double decaySpeed,
+    ui64 randomSeed,
+    TVector<TVector<TCompetitor>>* competitors
+);
+
 void YetiRankRecalculation(
     const TFold& ff,
     const TFold::TBodyTail& bt,
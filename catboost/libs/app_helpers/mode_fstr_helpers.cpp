@@ -67,7 +67,7 @@ void NCB::PrepareFstrModeParamsParser(
     params.BindParserOpts(parser);
     parser.FindLongOption("output-path")
         ->DefaultValue("feature_strength.tsv");
-    parser.AddLongOption("fstr-type", "Should be one of: FeatureImportance, InternalFeatureImportance, Interaction, InternalInteraction, ShapValues")
+    parser.AddLongOption("fstr-type", "Should be one of: FeatureImportance, InternalFeatureImportance, Interaction, InternalInteraction, ShapValues, LossFunctionChange")
         .RequiredArgument("fstr-type")
         .Handler1T<TString>([&params](const TString& fstrType) {
             CB_ENSURE(TryFromString<EFstrType>(fstrType, params.FstrType), fstrType + " fstr type is not supported");
@@ -119,6 +119,9 @@ void NCB::ModeFstrSingleHost(const NCB::TAnalyticalModeCommonParams& params) {
         case EFstrType::ShapValues:
             CalcAndOutputShapValues(model, *poolLoader(), params.OutputPath.Path, params.Verbose, localExecutor.Get());
             break;
+        case EFstrType::LossFunctionChange:
+            CalcAndOutputLossFunctionChange(model, *poolLoader(), localExecutor.Get(), params.OutputPath.Path);
+            break;
         default:
             Y_ASSERT(false);
     }
@@ -49,7 +49,7 @@ namespace NCB {
         if (!HasHashInRam) {
             Load();
         }
-        FeaturesPerfectHash[*catFeatureIdx] = std::move(perfectHash);
+        FeaturesPerfectHash[*catFeatureIdx] = TCatFeaturePerfectHashMap(perfectHash);
     }
 
     int TCatFeaturesPerfectHash::operator&(IBinSaver& binSaver) {
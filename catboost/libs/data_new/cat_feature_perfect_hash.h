@@ -1,5 +1,6 @@
 #pragma once
 
+#include "cat_feature_perfect_hash_map.h"
 #include "feature_index.h"
 
 #include <catboost/libs/helpers/checksum.h>
@@ -56,7 +57,7 @@ namespace NCB {
 
         bool operator==(const TCatFeaturesPerfectHash& rhs) const;
 
-        const TMap<ui32, ui32>& GetFeaturePerfectHash(const TCatFeatureIdx catFeatureIdx) const {
+        const TCatFeaturePerfectHashMap& GetFeaturePerfectHash(const TCatFeatureIdx catFeatureIdx) const {
             CheckHasFeature(catFeatureIdx);
             if (!HasHashInRam) {
                 Load();
@@ -84,7 +85,7 @@ namespace NCB {
         void FreeRamIfPossible() const {
             if (AllowWriteFiles) {
                 Save();
-                TVector<TMap<ui32, ui32>> empty;
+                TVector<TCatFeaturePerfectHashMap> empty;
                 FeaturesPerfectHash.swap(empty);
                 HasHashInRam = false;
             }
@@ -125,7 +126,7 @@ namespace NCB {
     private:
         TTempFile StorageTempFile;
         TVector<TCatFeatureUniqueValuesCounts> CatFeatureUniqValuesCountsVector; // [catFeatureIdx]
-        mutable TVector<TMap<ui32, ui32>> FeaturesPerfectHash; // [catFeatureIdx]
+        mutable TVector<TCatFeaturePerfectHashMap> FeaturesPerfectHash; // [catFeatureIdx]
         mutable bool HasHashInRam = true;
         bool AllowWriteFiles;
     };
@@ -3,9 +3,9 @@
 #include "util.h"
 
 #include <util/system/guard.h>
-#include <util/generic/map.h>
+#include <util/generic/xrange.h>
 
-#include <util/generic/ylimits.h>
+#include <array>
 
 
 namespace NCB {
@@ -31,47 +31,56 @@ namespace NCB {
             );
         }
 
-        TMap<ui32, ui32> perfectHashMap;
+        TCatFeaturePerfectHashMap perfectHashMap;
         {
             TWriteGuard guard(QuantizedFeaturesInfo->GetRWMutex());
             if (!featuresHash.HasHashInRam) {
                 featuresHash.Load();
             }
-            perfectHashMap.swap(featuresHash.FeaturesPerfectHash[*catFeatureIdx]);
+            perfectHashMap.Swap(featuresHash.FeaturesPerfectHash[*catFeatureIdx]);
         }
 
-        constexpr size_t MAX_UNIQ_CAT_VALUES =
-            static_cast<size_t>(Max<ui32>()) + ((sizeof(size_t) > sizeof(ui32)) ? 1 : 0);
+        // process values in batches so that FindOrInsertBatch can prefetch hash buckets
+        constexpr size_t BATCH_SIZE = 256;
+        std::array<ui32, BATCH_SIZE> batchIndices;
+        std::array<ui32, BATCH_SIZE> batchHashedCatValues;
+        std::array<ui32, BATCH_SIZE> batchBins;
+        size_t batchSize = 0;
+
+        auto processBatch = [&] () {
+            perfectHashMap.FindOrInsertBatch(
+                TConstArrayRef<ui32>(batchHashedCatValues.data(), batchSize),
+                TArrayRef<ui32>(batchBins.data(), batchSize)
+            );
+            if (dstBins) {
+                for (auto i : xrange(batchSize)) {
+                    dstBinsValue[batchIndices[i]] = batchBins[i];
+                }
+            }
+            batchSize = 0;
+        };
 
         hashedCatArraySubset.ForEach(
             [&] (ui32 idx, ui32 hashedCatValue) {
-                auto it = perfectHashMap.find(hashedCatValue);
-                if (it == perfectHashMap.end()) {
-                    CB_ENSURE(
-                        perfectHashMap.size() != MAX_UNIQ_CAT_VALUES,
-                        "Error: categorical feature with id #" << *catFeatureIdx
-                        << " has more than " << MAX_UNIQ_CAT_VALUES
-                        << " unique values, which is currently unsupported"
-                    );
-                    ui32 bin = (ui32)perfectHashMap.size();
-                    if (dstBins) {
-                        dstBinsValue[idx] = bin;
-                    }
-                    perfectHashMap.emplace_hint(it, hashedCatValue, bin);
-                } else if (dstBins) {
-                    dstBinsValue[idx] = it->second;
+                batchIndices[batchSize] = idx;
+                batchHashedCatValues[batchSize] = hashedCatValue;
+                if (++batchSize == BATCH_SIZE) {
+                    processBatch();
                 }
             }
         );
+        if (batchSize) {
+            processBatch();
+        }
 
         {
             TWriteGuard guard(QuantizedFeaturesInfo->GetRWMutex());
             auto& uniqValuesCounts = featuresHash.CatFeatureUniqValuesCountsVector[*catFeatureIdx];
             if (!uniqValuesCounts.OnAll) {
-                uniqValuesCounts.OnLearnOnly = perfectHashMap.size();
+                uniqValuesCounts.OnLearnOnly = perfectHashMap.GetSize();
             }
-            uniqValuesCounts.OnAll = perfectHashMap.size();
-            featuresHash.FeaturesPerfectHash[*catFeatureIdx].swap(perfectHashMap);
+            uniqValuesCounts.OnAll = perfectHashMap.GetSize();
+            featuresHash.FeaturesPerfectHash[*catFeatureIdx].Swap(perfectHashMap);
         }
     }
 
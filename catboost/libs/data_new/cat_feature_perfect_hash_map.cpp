@@ -0,0 +1,85 @@
+#include "cat_feature_perfect_hash_map.h"
+
+#include <util/generic/algorithm.h>
+#include <util/generic/bitops.h>
+#include <util/generic/xrange.h>
+
+
+namespace NCB {
+
+    TCatFeaturePerfectHashMap::TCatFeaturePerfectHashMap(const TMap<ui32, ui32>& perfectHash) {
+        Reserve(perfectHash.size());
+        for (const auto& [hashedCatValue, bin] : perfectHash) {
+            CB_ENSURE_INTERNAL(bin < perfectHash.size(), "perfect hash bin " << bin << " is out of range");
+            size_t bucketIdx = GetBucketIdx(hashedCatValue);
+            while (!IsEmpty(Buckets[bucketIdx])) {
+                bucketIdx = (bucketIdx + 1) & BucketMask;
+            }
+            Buckets[bucketIdx] = MakeBucket(hashedCatValue, bin);
+            ++Size;
+        }
+    }
+
+    bool TCatFeaturePerfectHashMap::operator==(const TCatFeaturePerfectHashMap& rhs) const {
+        if (Size != rhs.Size) {
+            return false;
+        }
+        bool equal = true;
+        ForEach(
+            [&] (ui32 hashedCatValue, ui32 bin) {
+                equal = equal && (rhs.Find(hashedCatValue) == bin);
+            }
+        );
+        return equal;
+    }
+
+    void TCatFeaturePerfectHashMap::FindOrInsertBatch(
+        TConstArrayRef<ui32> hashedCatValues,
+        TArrayRef<ui32> dstBins
+    ) {
+        Y_ASSERT(hashedCatValues.size() == dstBins.size());
+
+        constexpr size_t PREFETCH_DISTANCE = 16;
+
+        const size_t prefetchEnd = Min(PREFETCH_DISTANCE, hashedCatValues.size());
+        for (auto i : xrange(prefetchEnd)) {
+            Prefetch(hashedCatValues[i]);
+        }
+        for (auto i : xrange(hashedCatValues.size())) {
+            if (i + PREFETCH_DISTANCE < hashedCatValues.size()) {
+                Prefetch(hashedCatValues[i + PREFETCH_DISTANCE]);
+            }
+            dstBins[i] = FindOrInsert(hashedCatValues[i]);
+        }
+    }
+
+    TVector<ui32> TCatFeaturePerfectHashMap::GetHashedCatValuesByBins() const {
+        TVector<ui32> result;
+        result.yresize(Size);
+        ForEach(
+            [&] (ui32 hashedCatValue, ui32 bin) {
+                result[bin] = hashedCatValue;
+            }
+        );
+        return result;
+    }
+
+    void TCatFeaturePerfectHashMap::Rehash(size_t bucketCount) {
+        Y_ASSERT(IsPowerOf2(bucketCount));
+
+        TVector<ui64> newBuckets(bucketCount, EMPTY_BUCKET);
+        const size_t newBucketMask = bucketCount - 1;
+        for (ui64 bucket : Buckets) {
+            if (!IsEmpty(bucket)) {
+                size_t bucketIdx = IntHash(GetHashedCatValue(bucket)) & newBucketMask;
+                while (!IsEmpty(newBuckets[bucketIdx])) {
+                    bucketIdx = (bucketIdx + 1) & newBucketMask;
+                }
+                newBuckets[bucketIdx] = bucket;
+            }
+        }
+        Buckets.swap(newBuckets);
+        BucketMask = newBucketMask;
+    }
+
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <catboost/libs/helpers/checksum.h>
+#include <catboost/libs/helpers/exception.h>
+
+#include <library/binsaver/bin_saver.h>
+#include <library/dbg_output/dump.h>
+
+#include <util/digest/numeric.h>
+#include <util/generic/array_ref.h>
+#include <util/generic/map.h>
+#include <util/generic/maybe.h>
+#include <util/generic/vector.h>
+#include <util/generic/ylimits.h>
+#include <util/system/compiler.h>
+#include <util/system/types.h>
+#include <util/ysaveload.h>
+
+
+namespace NCB {
+
+    /* Open-addressing (linear probing) map from hashed categorical feature value to its perfect hash
+     * (bin index in [0, GetSize()) assigned in order of insertion).
+     *
+     * Each bucket is a single ui64 (value in high 32 bits, bin in low 32 bits) and load factor is kept
+     * <= 3/4, so it takes 11-21 bytes per unique value instead of ~48 bytes per node of TMap<ui32, ui32>.
+     */
+    class TCatFeaturePerfectHashMap {
+    public:
+        // bins are in [0, MAX_SIZE), Max<ui32>() is reserved for empty buckets
+        static constexpr size_t MAX_SIZE = Max<ui32>();
+
+    public:
+        TCatFeaturePerfectHashMap() = default;
+
+        // for testing or setting from external sources
+        explicit TCatFeaturePerfectHashMap(const TMap<ui32, ui32>& perfectHash);
+
+        bool operator==(const TCatFeaturePerfectHashMap& rhs) const;
+
+        size_t GetSize() const {
+            return Size;
+        }
+
+        bool Empty() const {
+            return Size == 0;
+        }
+
+        TMaybe<ui32> Find(ui32 hashedCatValue) const {
+            if (Buckets.empty()) {
+                return Nothing();
+            }
+            for (size_t bucketIdx = GetBucketIdx(hashedCatValue); ; bucketIdx = (bucketIdx + 1) & BucketMask) {
+                const ui64 bucket = Buckets[bucketIdx];
+                if (IsEmpty(bucket)) {
+                    return Nothing();
+                }
+                if (GetHashedCatValue(bucket) == hashedCatValue) {
+                    return GetBin(bucket);
+                }
+            }
+        }
+
+        // returns bin of hashedCatValue, new values get bin == GetSize()
+        ui32 FindOrInsert(ui32 hashedCatValue) {
+            if ((Size + 1) * 4 > Buckets.size() * 3) {
+                Rehash(Max<size_t>(Buckets.size() * 2, INITIAL_BUCKET_COUNT));
+            }
+            for (size_t bucketIdx = GetBucketIdx(hashedCatValue); ; bucketIdx = (bucketIdx + 1) & BucketMask) {
+                ui64& bucket = Buckets[bucketIdx];
+                if (IsEmpty(bucket)) {
+                    CB_ENSURE(
+                        Size < MAX_SIZE,
+                        "Error: categorical feature has more than " << MAX_SIZE
+                        << " unique values, which is currently unsupported"
+                    );
+                    const ui32 bin = (ui32)Size++;
+                    bucket = MakeBucket(hashedCatValue, bin);
+                    return bin;
+                }
+                if (GetHashedCatValue(bucket) == hashedCatValue) {
+                    return GetBin(bucket);
+                }
+            }
+        }
+
+        // hint to load bucket for hashedCatValue to cache before Find or FindOrInsert
+        void Prefetch(ui32 hashedCatValue) const {
+            if (!Buckets.empty()) {
+                Y_PREFETCH_READ(Buckets.data() + GetBucketIdx(hashedCatValue), 3);
+            }
+        }
+
+        /* dstBins[i] = bin of hashedCatValues[i], unknown values get bin == GetSize()
+         * bucket loads are prefetched in batches to hide memory latency for large maps
+         */
+        void FindOrInsertBatch(TConstArrayRef<ui32> hashedCatValues, TArrayRef<ui32> dstBins);
+
+        // f(hashedCatValue, bin), order is unspecified
+        template <class F>
+        void ForEach(F&& f) const {
+            for (ui64 bucket : Buckets) {
+                if (!IsEmpty(bucket)) {
+                    f(GetHashedCatValue(bucket), GetBin(bucket));
+                }
+            }
+        }
+
+        // [bin] -> hashedCatValue
+        TVector<ui32> GetHashedCatValuesByBins() const;
+
+        size_t GetAllocatedBytes() const {
+            return Buckets.capacity() * sizeof(ui64);
+        }
+
+        void Reserve(size_t size) {
+            size_t bucketCount = INITIAL_BUCKET_COUNT;
+            while (size * 4 > bucketCount * 3) {
+                bucketCount *= 2;
+            }
+            if (bucketCount > Buckets.size()) {
+                Rehash(bucketCount);
+            }
+        }
+
+        void Swap(TCatFeaturePerfectHashMap& rhs) {
+            Buckets.swap(rhs.Buckets);
+            DoSwap(BucketMask, rhs.BucketMask);
+            DoSwap(Size, rhs.Size);
+        }
+
+        Y_SAVELOAD_DEFINE(Buckets, BucketMask, Size);
+        SAVELOAD(Buckets, BucketMask, Size);
+
+    private:
+        static constexpr size_t INITIAL_BUCKET_COUNT = 16;
+        static constexpr ui64 EMPTY_BUCKET = Max<ui32>();
+
+    private:
+        size_t GetBucketIdx(ui32 hashedCatValue) const {
+            return IntHash(hashedCatValue) & BucketMask;
+        }
+
+        static bool IsEmpty(ui64 bucket) {
+            return (ui32)bucket == Max<ui32>();
+        }
+
+        static ui32 GetHashedCatValue(ui64 bucket) {
+            return (ui32)(bucket >> 32);
+        }
+
+        static ui32 GetBin(ui64 bucket) {
+            return (ui32)bucket;
+        }
+
+        static ui64 MakeBucket(ui32 hashedCatValue, ui32 bin) {
+            return ((ui64)hashedCatValue << 32) | bin;
+        }
+
+        void Rehash(size_t bucketCount);
+
+    private:
+        TVector<ui64> Buckets;
+        size_t BucketMask = 0;
+        size_t Size = 0;
+    };
+
+    // independent of buckets layout
+    inline ui32 UpdateCheckSumImpl(ui32 init, const TCatFeaturePerfectHashMap& perfectHash) {
+        return UpdateCheckSum(init, perfectHash.GetHashedCatValuesByBins());
+    }
+}
+
+
+template <>
+struct TDumper<NCB::TCatFeaturePerfectHashMap> {
+    template <class S>
+    static inline void Dump(S& s, const NCB::TCatFeaturePerfectHashMap& perfectHash) {
+        const TVector<ui32> hashedCatValues = perfectHash.GetHashedCatValuesByBins();
+        s << '{';
+        for (size_t bin = 0; bin < hashedCatValues.size(); ++bin) {
+            s << (bin ? ", " : "") << hashedCatValues[bin] << ':' << bin;
+        }
+        s << '}';
+    }
+};
@@ -80,10 +80,11 @@ namespace NCB {
         const TObjectsDataProvider& objectsData,
         THashMap<ui32, ui32>* columnIndexesReorderMap)
     {
-        // TODO(akhropov): Quantized datasets support. MLTOOLS-2582.
+        // only features layout is checked here, quantized datasets are supported by callers that handle them
         CB_ENSURE(
-            dynamic_cast<const TRawObjectsDataProvider*>(&objectsData),
-            "Non-raw pools are incompatible with models"
+            dynamic_cast<const TRawObjectsDataProvider*>(&objectsData)
+                || dynamic_cast<const TQuantizedObjectsDataProvider*>(&objectsData),
+            "Only raw and quantized pools are compatible with models"
         );
 
         const auto& datasetFeaturesLayout = *objectsData.GetFeaturesLayout();
@@ -13,6 +13,7 @@
 #include <catboost/libs/quantization_schema/quantize.h>
 
 #include <library/grid_creator/binarization.h>
+#include <library/grid_creator/quantile_sketch.h>
 
 #include <util/generic/cast.h>
 #include <util/generic/maybe.h>
@@ -44,6 +45,15 @@ namespace NCB {
     }
 
 
+    // fixed to make results independent of thread count
+    constexpr ui32 QUANTILE_SKETCH_BLOCK_SIZE = 1 << 20;
+
+
+    static ui32 GetSampleSizeForBuildBordersFromQuantileSketch(ui32 objectCount, const TQuantizationOptions& options) {
+        return Min(objectCount, options.MaxSubsetSizeForSlowBuildBordersAlgorithms);
+    }
+
+
     static TMaybe<TArraySubsetIndexing<ui32>> GetSubsetForBuildBorders(
         const TArraySubsetIndexing<ui32>& srcIndexing,
         const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
@@ -51,7 +61,8 @@ namespace NCB {
         const TQuantizationOptions& options,
         TRestorableFastRng64* rand
     ) {
-        if (NeedToCalcBorders(quantizedFeaturesInfo)) {
+        // quantile sketch is built from all values
+        if (NeedToCalcBorders(quantizedFeaturesInfo) && !options.UseQuantileSketchForBuildBorders) {
             const ui32 objectCount = srcIndexing.Size();
             const ui32 sampleSize = GetSampleSizeForBorderSelectionType(
                 objectCount,
@@ -99,11 +110,20 @@ namespace NCB {
             auto borderSelectionType =
                 quantizedFeaturesInfo.GetFloatFeatureBinarization().BorderSelectionType;
 
-            const ui32 sampleSize = GetSampleSizeForBorderSelectionType(
-                objectCount,
-                borderSelectionType,
-                options.MaxSubsetSizeForSlowBuildBordersAlgorithms
-            );
+            ui32 sampleSize;
+            if (options.UseQuantileSketchForBuildBorders) {
+                sampleSize = GetSampleSizeForBuildBordersFromQuantileSketch(objectCount, options);
+
+                // per-block sketches, retained size is less than 4 * capacity
+                const ui64 blockCount = CeilDiv<ui64>(objectCount, QUANTILE_SKETCH_BLOCK_SIZE);
+                result += (blockCount + 1) * 4 * NSplitSelection::TQuantileSketch::DEFAULT_CAPACITY * sizeof(float);
+            } else {
+                sampleSize = GetSampleSizeForBorderSelectionType(
+                    objectCount,
+                    borderSelectionType,
+                    options.MaxSubsetSizeForSlowBuildBordersAlgorithms
+                );
+            }
 
             result += sizeof(float) * sampleSize; // for copying to srcFeatureValuesForBuildBorders
 
@@ -124,10 +144,59 @@ namespace NCB {
     }
 
 
+    // sketches for blocks are built in parallel and merged in block order
+    static NSplitSelection::TQuantileSketch BuildQuantileSketch(
+        const TMaybeOwningConstArraySubset<float, ui32>& srcData,
+        NPar::TLocalExecutor* localExecutor,
+        bool* hasNans
+    ) {
+        const auto& subsetIndexing = *srcData.GetSubsetIndexing();
+        const auto& src = *srcData.GetSrc();
+
+        const auto parallelUnitRanges = subsetIndexing.GetParallelUnitRanges(QUANTILE_SKETCH_BLOCK_SIZE);
+        const int blockCount = SafeIntegerCast<int>(parallelUnitRanges.RangesCount());
+
+        TVector<NSplitSelection::TQuantileSketch> blockSketches(blockCount);
+        TVector<bool> blockHasNans(blockCount, false);
+
+        localExecutor->ExecRangeWithThrow(
+            [&] (int blockIdx) {
+                auto& blockSketch = blockSketches[blockIdx];
+                bool blockHasNan = false;
+                subsetIndexing.ForEachInSubRange(
+                    parallelUnitRanges.GetRange(blockIdx),
+                    [&] (ui32 /*idx*/, ui32 srcIdx) {
+                        const float value = src[srcIdx];
+                        if (IsNan(value)) {
+                            blockHasNan = true;
+                        } else {
+                            blockSketch.Add(value);
+                        }
+                    }
+                );
+                blockHasNans[blockIdx] = blockHasNan;
+            },
+            0,
+            blockCount,
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+
+        NSplitSelection::TQuantileSketch sketch;
+        *hasNans = false;
+        for (auto blockIdx : xrange(blockCount)) {
+            sketch.Merge(blockSketches[blockIdx]);
+            *hasNans = *hasNans || blockHasNans[blockIdx];
+        }
+        return sketch;
+    }
+
+
     static void CalcBordersAndNanMode(
         const TFloatValuesHolder& srcFeature,
         const TFeaturesArraySubsetIndexing* subsetForBuildBorders,
         const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
+        const TQuantizationOptions& options,
+        NPar::TLocalExecutor* localExecutor,
         ENanMode* nanMode,
         TVector<float>* borders
     ) {
@@ -144,19 +213,25 @@ namespace NCB {
 
         // does not contain nans
         TVector<float> srcFeatureValuesForBuildBorders;
-        srcFeatureValuesForBuildBorders.reserve(srcDataForBuildBorders.Size());
+        TMaybe<NSplitSelection::TQuantileSketch> quantileSketch;
 
         bool hasNans = false;
 
-        srcDataForBuildBorders.ForEach(
-            [&] (ui32 /*idx*/, float value) {
-                if (IsNan(value)) {
-                    hasNans = true;
-                } else {
-                    srcFeatureValuesForBuildBorders.push_back(value);
+        if (options.UseQuantileSketchForBuildBorders) {
+            quantileSketch = BuildQuantileSketch(srcDataForBuildBorders, localExecutor, &hasNans);
+        } else {
+            srcFeatureValuesForBuildBorders.reserve(srcDataForBuildBorders.Size());
+
+            srcDataForBuildBorders.ForEach(
+                [&] (ui32 /*idx*/, float value) {
+                    if (IsNan(value)) {
+                        hasNans = true;
+                    } else {
+                        srcFeatureValuesForBuildBorders.push_back(value);
+                    }
                 }
-            }
-        );
+            );
+        }
 
         CB_ENSURE(
             (binarizationOptions.NanMode != ENanMode::Forbidden) ||
@@ -176,11 +251,20 @@ namespace NCB {
         THashSet<float> borderSet;
 
         if (nonNanValuesBorderCount > 0) {
-            borderSet = BestSplit(
-                srcFeatureValuesForBuildBorders,
-                nonNanValuesBorderCount,
-                binarizationOptions.BorderSelectionType
-            );
+            if (quantileSketch) {
+                borderSet = BestSplit(
+                    *quantileSketch,
+                    nonNanValuesBorderCount,
+                    binarizationOptions.BorderSelectionType,
+                    GetSampleSizeForBuildBordersFromQuantileSketch(srcDataForBuildBorders.Size(), options)
+                );
+            } else {
+                borderSet = BestSplit(
+                    srcFeatureValuesForBuildBorders,
+                    nonNanValuesBorderCount,
+                    binarizationOptions.BorderSelectionType
+                );
+            }
 
             if (borderSet.contains(-0.0f)) { // BestSplit might add negative zeros
                 borderSet.erase(-0.0f);
@@ -246,6 +330,8 @@ namespace NCB {
                 srcFeature,
                 subsetForBuildBorders,
                 *quantizedFeaturesInfo,
+                options,
+                localExecutor,
                 &nanMode,
                 &calculatedBorders
             );
@@ -19,6 +19,11 @@ namespace NCB {
         ui32 MaxSubsetSizeForSlowBuildBordersAlgorithms = 200000;
         bool AllowWriteFiles = true;
 
+        /* build borders from quantile sketch of all feature values instead of full sort of
+         * all (or subsampled for slow border selection algorithms) values
+         */
+        bool UseQuantileSketchForBuildBorders = false;
+
         // TODO(akhropov): remove after checking global tests consistency
         bool CpuCompatibilityShuffleOverFullData = true;
     };
@@ -135,11 +135,7 @@ namespace NCB {
                 const auto& catFeaturePerfectHash = GetCategoricalFeaturesPerfectHash(
                     TCatFeatureIdx((ui32)catFeatureIdx)
                 );
-                auto& perFeatureResult = result[catFeatureIdx];
-                perFeatureResult.yresize(catFeaturePerfectHash.size());
-                for (const auto [hashedCatValue, perfectHash] : catFeaturePerfectHash) {
-                    perFeatureResult[perfectHash] = hashedCatValue;
-                }
+                result[catFeatureIdx] = catFeaturePerfectHash.GetHashedCatValuesByBins();
             },
             0,
             SafeIntegerCast<int>(featuresLayout.GetCatFeatureCount()),
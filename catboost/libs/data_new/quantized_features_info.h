@@ -130,7 +130,7 @@ namespace NCB {
 
         ui32 CalcMaxCategoricalFeaturesUniqueValuesCountOnLearn() const;
 
-        const TMap<ui32, ui32>& GetCategoricalFeaturesPerfectHash(const TCatFeatureIdx catFeatureIdx) const {
+        const TCatFeaturePerfectHashMap& GetCategoricalFeaturesPerfectHash(const TCatFeatureIdx catFeatureIdx) const {
             CheckCorrectPerTypeFeatureIdx(catFeatureIdx);
             return CatFeaturesPerfectHash.GetFeaturePerfectHash(catFeatureIdx);
         };
@@ -0,0 +1,448 @@
+#include "raw_columnar_pool.h"
+
+#include "loader.h"
+
+#include <catboost/libs/column_description/column.h>
+#include <catboost/libs/data_util/exists_checker.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/helpers/resource_holder.h>
+
+#include <library/object_factory/object_factory.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/memory/blob.h>
+#include <util/stream/file.h>
+#include <util/stream/mem.h>
+#include <util/stream/str.h>
+#include <util/system/align.h>
+#include <util/system/types.h>
+#include <util/ysaveload.h>
+
+#include <cstring>
+
+
+/* File layout (all integers are in native byte order):
+ *
+ *  - header: magic (16 bytes), version (ui32), zero padding up to RawColumnarPoolAlignment
+ *  - columns data, each array starts at offset aligned to RawColumnarPoolAlignment
+ *  - metainfo serialized with util/ysaveload (TRawColumnarPoolMetaInfo)
+ *  - trailer: metainfo offset (ui64), metainfo size (ui64)
+ */
+
+namespace NCB {
+
+    static const char RawColumnarPoolMagic[16] = "CBRawColumnPool";
+    static constexpr ui32 RawColumnarPoolVersion = 1;
+    static constexpr ui64 RawColumnarPoolAlignment = 16;
+
+    namespace {
+        struct TDataRegion {
+            ui64 Offset = 0;
+            ui64 Size = 0; // in bytes
+
+        public:
+            Y_SAVELOAD_DEFINE(Offset, Size);
+        };
+
+        struct TRawColumnarPoolMetaInfo {
+            ui32 ObjectCount = 0;
+            TVector<TColumn> Columns;
+            TVector<TString> FeatureIds;
+
+            /* [columnIdx]
+             * empty for columns without data (ignored features, DocId, Auxiliary, ...),
+             * [offsets, chars] for Label, single array for others
+             */
+            TVector<TVector<TDataRegion>> ColumnsData;
+
+        public:
+            Y_SAVELOAD_DEFINE(ObjectCount, Columns, FeatureIds, ColumnsData);
+        };
+
+        struct TBlobHolder : public IResourceHolder {
+            TBlob Blob;
+
+        public:
+            explicit TBlobHolder(TBlob&& blob)
+                : Blob(std::move(blob))
+            {}
+        };
+
+
+        class TRawColumnarPoolWriter {
+        public:
+            explicit TRawColumnarPoolWriter(const TString& outputPath)
+                : Output(outputPath)
+                , Position(0)
+            {
+                Write(RawColumnarPoolMagic, sizeof(RawColumnarPoolMagic));
+                Write(&RawColumnarPoolVersion, sizeof(RawColumnarPoolVersion));
+            }
+
+            template <class T>
+            TDataRegion WriteArray(TConstArrayRef<T> data) {
+                AddPadding();
+                TDataRegion region{Position, data.size() * sizeof(T)};
+                Write(data.data(), region.Size);
+                return region;
+            }
+
+            void Finish(const TRawColumnarPoolMetaInfo& metaInfo) {
+                AddPadding();
+                const ui64 metaInfoOffset = Position;
+                TString serializedMetaInfo;
+                {
+                    TStringOutput metaInfoOutput(serializedMetaInfo);
+                    ::Save(&metaInfoOutput, metaInfo);
+                }
+                const ui64 metaInfoSize = serializedMetaInfo.size();
+                Write(serializedMetaInfo.data(), metaInfoSize);
+                Write(&metaInfoOffset, sizeof(metaInfoOffset));
+                Write(&metaInfoSize, sizeof(metaInfoSize));
+                Output.Finish();
+            }
+
+        private:
+            void Write(const void* data, size_t size) {
+                Output.Write(data, size);
+                Position += size;
+            }
+
+            void AddPadding() {
+                static const char zeros[RawColumnarPoolAlignment] = {};
+                Write(zeros, AlignUpSpace(Position, RawColumnarPoolAlignment));
+            }
+
+        private:
+            TFileOutput Output;
+            ui64 Position;
+        };
+    }
+
+
+    template <class T, class TArrayLike>
+    static TVector<T> GatherValues(const TArrayLike& arraySubset, ui32 objectCount) {
+        TVector<T> result;
+        result.yresize(objectCount);
+        arraySubset.ForEach([&result] (ui32 idx, T value) { result[idx] = value; });
+        return result;
+    }
+
+    template <class T>
+    static TVector<T> GatherValues(const TWeights<T>& weights, ui32 objectCount) {
+        TVector<T> result;
+        result.yresize(objectCount);
+        for (auto objectIdx : xrange(objectCount)) {
+            result[objectIdx] = weights[objectIdx];
+        }
+        return result;
+    }
+
+    void SaveRawColumnarPool(const TRawDataProvider& dataProvider, const TString& outputPath) {
+        CB_ENSURE(
+            dataProvider.MetaInfo.ColumnsInfo.Defined(),
+            "Raw columnar pool can be saved only for datasets with columns description"
+        );
+
+        const auto& objectsData = *dataProvider.ObjectsData;
+        const auto& targetData = dataProvider.RawTargetData;
+        const auto& featuresLayout = *dataProvider.MetaInfo.FeaturesLayout;
+        const ui32 objectCount = dataProvider.GetObjectCount();
+
+        TRawColumnarPoolMetaInfo metaInfo;
+        metaInfo.ObjectCount = objectCount;
+        metaInfo.Columns = dataProvider.MetaInfo.ColumnsInfo->Columns;
+        for (const auto& featureMetaInfo : featuresLayout.GetExternalFeaturesMetaInfo()) {
+            metaInfo.FeatureIds.push_back(featureMetaInfo.Name);
+        }
+        metaInfo.ColumnsData.resize(metaInfo.Columns.size());
+
+        TRawColumnarPoolWriter writer(outputPath);
+
+        ui32 flatFeatureIdx = 0;
+        ui32 baselineIdx = 0;
+        for (auto columnIdx : xrange(metaInfo.Columns.size())) {
+            auto& columnData = metaInfo.ColumnsData[columnIdx];
+            const EColumn columnType = metaInfo.Columns[columnIdx].Type;
+
+            if (IsFactorColumn(columnType)) {
+                const ui32 internalFeatureIdx = featuresLayout.GetInternalFeatureIdx(flatFeatureIdx);
+                if (columnType == EColumn::Categ) {
+                    auto catFeature = objectsData.GetCatFeature(internalFeatureIdx);
+                    if (catFeature) {
+                        const auto values = GatherValues<ui32>((*catFeature)->GetArrayData(), objectCount);
+                        columnData.push_back(writer.WriteArray<ui32>(values));
+                    }
+                } else {
+                    auto floatFeature = objectsData.GetFloatFeature(internalFeatureIdx);
+                    if (floatFeature) {
+                        const auto values = GatherValues<float>((*floatFeature)->GetArrayData(), objectCount);
+                        columnData.push_back(writer.WriteArray<float>(values));
+                    }
+                }
+                ++flatFeatureIdx;
+                continue;
+            }
+
+            switch (columnType) {
+                case EColumn::Label: {
+                    const auto target = *targetData.GetTarget();
+                    TVector<ui64> offsets;
+                    offsets.reserve(target.size() + 1);
+                    TString chars;
+                    offsets.push_back(0);
+                    for (const auto& value : target) {
+                        chars += value;
+                        offsets.push_back(chars.size());
+                    }
+                    columnData.push_back(writer.WriteArray<ui64>(offsets));
+                    columnData.push_back(writer.WriteArray<char>(chars));
+                    break;
+                }
+                case EColumn::Baseline:
+                    columnData.push_back(writer.WriteArray<float>((*targetData.GetBaseline())[baselineIdx++]));
+                    break;
+                case EColumn::Weight:
+                    columnData.push_back(
+                        writer.WriteArray<float>(GatherValues(targetData.GetWeights(), objectCount))
+                    );
+                    break;
+                case EColumn::GroupWeight:
+                    columnData.push_back(
+                        writer.WriteArray<float>(GatherValues(targetData.GetGroupWeights(), objectCount))
+                    );
+                    break;
+                case EColumn::GroupId:
+                    columnData.push_back(writer.WriteArray<TGroupId>(*objectsData.GetGroupIds()));
+                    break;
+                case EColumn::SubgroupId:
+                    columnData.push_back(writer.WriteArray<TSubgroupId>(*objectsData.GetSubgroupIds()));
+                    break;
+                case EColumn::Timestamp:
+                    columnData.push_back(writer.WriteArray<ui64>(*objectsData.GetTimestamp()));
+                    break;
+                default:
+                    // DocId, Auxiliary and Prediction columns are not kept in data providers
+                    break;
+            }
+        }
+
+        writer.Finish(metaInfo);
+    }
+
+
+    namespace {
+        class TRawColumnarDataLoader : public IRawFeaturesOrderDatasetLoader {
+        public:
+            explicit TRawColumnarDataLoader(TDatasetLoaderPullArgs&& args);
+
+            void Do(IRawFeaturesOrderDataVisitor* visitor) override;
+
+        private:
+            template <class T>
+            TConstArrayRef<T> GetColumnData(ui32 columnIdx, ui32 regionIdx = 0) const;
+
+            template <class T>
+            TConstArrayRef<T> GetObjectsColumnData(ui32 columnIdx) const {
+                const auto data = GetColumnData<T>(columnIdx);
+                CheckDataSize(data.size(), (size_t)PoolMetaInfo.ObjectCount, "raw columnar pool column");
+                return data;
+            }
+
+        private:
+            TDatasetLoaderCommonArgs Args;
+            TIntrusivePtr<TBlobHolder> PoolBlob;
+            TRawColumnarPoolMetaInfo PoolMetaInfo;
+            TDataMetaInfo DataMetaInfo;
+            TVector<bool> FeatureIgnored; // [flatFeatureIdx]
+        };
+    }
+
+    TRawColumnarDataLoader::TRawColumnarDataLoader(TDatasetLoaderPullArgs&& args)
+        : Args(std::move(args.CommonArgs))
+        , PoolBlob(MakeIntrusive<TBlobHolder>(TBlob::FromFile(args.PoolPath.Path)))
+    {
+        CB_ENSURE(!Args.PairsFilePath.Inited() || CheckExists(Args.PairsFilePath),
+                  "TRawColumnarDataLoader:PairsFilePath does not exist");
+        CB_ENSURE(!Args.GroupWeightsFilePath.Inited() || CheckExists(Args.GroupWeightsFilePath),
+                  "TRawColumnarDataLoader:GroupWeightsFilePath does not exist");
+
+        const TBlob& blob = PoolBlob->Blob;
+        constexpr size_t trailerSize = 2 * sizeof(ui64);
+        CB_ENSURE(
+            blob.Size() >= RawColumnarPoolAlignment + trailerSize
+                && !memcmp(blob.AsCharPtr(), RawColumnarPoolMagic, sizeof(RawColumnarPoolMagic)),
+            args.PoolPath.Path << " is not a raw columnar pool"
+        );
+
+        ui32 version = 0;
+        memcpy(&version, blob.AsCharPtr() + sizeof(RawColumnarPoolMagic), sizeof(version));
+        CB_ENSURE(
+            version == RawColumnarPoolVersion,
+            "Unsupported raw columnar pool version " << version << ", expected " << RawColumnarPoolVersion
+        );
+
+        ui64 metaInfoOffset = 0;
+        ui64 metaInfoSize = 0;
+        memcpy(&metaInfoOffset, blob.AsCharPtr() + blob.Size() - trailerSize, sizeof(ui64));
+        memcpy(&metaInfoSize, blob.AsCharPtr() + blob.Size() - sizeof(ui64), sizeof(ui64));
+        CB_ENSURE(
+            metaInfoOffset + metaInfoSize + trailerSize == blob.Size(),
+            "Raw columnar pool " << args.PoolPath.Path << " is corrupted"
+        );
+
+        TMemoryInput metaInfoInput(blob.AsCharPtr() + metaInfoOffset, metaInfoSize);
+        ::Load(&metaInfoInput, PoolMetaInfo);
+        CB_ENSURE(PoolMetaInfo.ObjectCount > 0, "Pool is empty");
+        CB_ENSURE(
+            PoolMetaInfo.ColumnsData.size() == PoolMetaInfo.Columns.size(),
+            "Raw columnar pool " << args.PoolPath.Path << " is corrupted"
+        );
+        for (const auto& columnData : PoolMetaInfo.ColumnsData) {
+            for (const auto& region : columnData) {
+                CB_ENSURE(
+                    (region.Offset % RawColumnarPoolAlignment == 0)
+                        && (region.Offset + region.Size <= metaInfoOffset),
+                    "Raw columnar pool " << args.PoolPath.Path << " is corrupted"
+                );
+            }
+        }
+
+        DataMetaInfo = TDataMetaInfo(
+            TDataColumnsMetaInfo{PoolMetaInfo.Columns},
+            Args.GroupWeightsFilePath.Inited(),
+            Args.PairsFilePath.Inited(),
+            &PoolMetaInfo.FeatureIds
+        );
+
+        // features without data have been ignored when the pool was saved
+        TVector<ui32> ignoredFeatures = Args.IgnoredFeatures;
+        ui32 flatFeatureIdx = 0;
+        for (auto columnIdx : xrange(PoolMetaInfo.Columns.size())) {
+            if (IsFactorColumn(PoolMetaInfo.Columns[columnIdx].Type)) {
+                if (PoolMetaInfo.ColumnsData[columnIdx].empty()) {
+                    ignoredFeatures.push_back(flatFeatureIdx);
+                }
+                ++flatFeatureIdx;
+            }
+        }
+        ProcessIgnoredFeaturesList(ignoredFeatures, &DataMetaInfo, &FeatureIgnored);
+    }
+
+    template <class T>
+    TConstArrayRef<T> TRawColumnarDataLoader::GetColumnData(ui32 columnIdx, ui32 regionIdx) const {
+        const auto& columnData = PoolMetaInfo.ColumnsData[columnIdx];
+        CB_ENSURE(
+            regionIdx < columnData.size(),
+            "Raw columnar pool has no data for column #" << columnIdx
+        );
+        const TDataRegion& region = columnData[regionIdx];
+        CB_ENSURE(region.Size % sizeof(T) == 0, "Raw columnar pool column #" << columnIdx << " is corrupted");
+        return TConstArrayRef<T>(
+            reinterpret_cast<const T*>(PoolBlob->Blob.AsCharPtr() + region.Offset),
+            region.Size / sizeof(T)
+        );
+    }
+
+    void TRawColumnarDataLoader::Do(IRawFeaturesOrderDataVisitor* visitor) {
+        const ui32 objectCount = PoolMetaInfo.ObjectCount;
+
+        visitor->Start(DataMetaInfo, objectCount, Args.ObjectsOrder, {PoolBlob});
+
+        ui32 flatFeatureIdx = 0;
+        ui32 baselineIdx = 0;
+        for (auto columnIdx : xrange<ui32>(PoolMetaInfo.Columns.size())) {
+            const EColumn columnType = PoolMetaInfo.Columns[columnIdx].Type;
+
+            if (IsFactorColumn(columnType)) {
+                if (!FeatureIgnored[flatFeatureIdx]) {
+                    // data is used in place, PoolBlob passed to Start keeps it mapped
+                    if (columnType == EColumn::Categ) {
+                        visitor->AddCatFeature(
+                            flatFeatureIdx,
+                            TMaybeOwningConstArrayHolder<ui32>::CreateNonOwning(
+                                GetObjectsColumnData<ui32>(columnIdx)
+                            )
+                        );
+                    } else {
+                        visitor->AddFloatFeature(
+                            flatFeatureIdx,
+                            TMaybeOwningConstArrayHolder<float>::CreateNonOwning(
+                                GetObjectsColumnData<float>(columnIdx)
+                            )
+                        );
+                    }
+                }
+                ++flatFeatureIdx;
+                continue;
+            }
+
+            switch (columnType) {
+                case EColumn::Label: {
+                    const auto offsets = GetColumnData<ui64>(columnIdx, 0);
+                    const auto chars = GetColumnData<char>(columnIdx, 1);
+                    CheckDataSize(offsets.size(), (size_t)objectCount + 1, "raw columnar pool target offsets");
+                    CB_ENSURE(offsets.back() == chars.size(), "Raw columnar pool target data is corrupted");
+
+                    TVector<TString> target;
+                    target.reserve(objectCount);
+                    for (auto objectIdx : xrange(objectCount)) {
+                        CB_ENSURE(
+                            offsets[objectIdx] <= offsets[objectIdx + 1],
+                            "Raw columnar pool target data is corrupted"
+                        );
+                        target.emplace_back(
+                            chars.data() + offsets[objectIdx],
+                            offsets[objectIdx + 1] - offsets[objectIdx]
+                        );
+                    }
+                    visitor->AddTarget(target);
+                    break;
+                }
+                case EColumn::Baseline:
+                    visitor->AddBaseline(baselineIdx++, GetObjectsColumnData<float>(columnIdx));
+                    break;
+                case EColumn::Weight:
+                    visitor->AddWeights(GetObjectsColumnData<float>(columnIdx));
+                    break;
+                case EColumn::GroupWeight:
+                    visitor->AddGroupWeights(GetObjectsColumnData<float>(columnIdx));
+                    break;
+                case EColumn::GroupId: {
+                    const auto groupIds = GetObjectsColumnData<TGroupId>(columnIdx);
+                    for (auto objectIdx : xrange(objectCount)) {
+                        visitor->AddGroupId(objectIdx, groupIds[objectIdx]);
+                    }
+                    break;
+                }
+                case EColumn::SubgroupId: {
+                    const auto subgroupIds = GetObjectsColumnData<TSubgroupId>(columnIdx);
+                    for (auto objectIdx : xrange(objectCount)) {
+                        visitor->AddSubgroupId(objectIdx, subgroupIds[objectIdx]);
+                    }
+                    break;
+                }
+                case EColumn::Timestamp: {
+                    const auto timestamps = GetObjectsColumnData<ui64>(columnIdx);
+                    for (auto objectIdx : xrange(objectCount)) {
+                        visitor->AddTimestamp(objectIdx, timestamps[objectIdx]);
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+
+        SetGroupWeights(Args.GroupWeightsFilePath, objectCount, visitor);
+        SetPairs(Args.PairsFilePath, objectCount, visitor);
+        visitor->Finish();
+    }
+
+    namespace {
+        TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSRawColumnarExistsCheckerReg("raw-columnar");
+        TDatasetLoaderFactory::TRegistrator<TRawColumnarDataLoader> RawColumnarDataLoaderReg("raw-columnar");
+    }
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "data_provider.h"
+
+#include <util/generic/string.h>
+
+
+namespace NCB {
+
+    /* Columnar binary format for raw (not quantized) datasets.
+     *
+     * Each float feature, hashed categorical feature and auxiliary data column (target, weights, baseline,
+     * group ids etc.) is stored as a contiguous aligned array, so the file can be memory-mapped and its
+     * columns used in place without parsing. Load such pools with "raw-columnar://" path scheme.
+     *
+     * Only hashed values of categorical features are stored (string values are not needed
+     * for training or applying models).
+     * Pairs and group weights from separate files are not stored, specify them when loading the pool.
+     */
+    void SaveRawColumnarPool(const TRawDataProvider& dataProvider, const TString& outputPath);
+
+}
@@ -0,0 +1,66 @@
+#include <catboost/libs/data_new/cat_feature_perfect_hash_map.h>
+
+#include <util/generic/map.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/stream/buffer.h>
+
+#include <library/unittest/registar.h>
+
+
+using namespace NCB;
+
+
+Y_UNIT_TEST_SUITE(TCatFeaturePerfectHashMap) {
+    Y_UNIT_TEST(FindOrInsert) {
+        TCatFeaturePerfectHashMap perfectHash;
+        TMap<ui32, ui32> expectedPerfectHash;
+
+        TReallyFastRng32 rng(0);
+        for (auto i : xrange(100000)) {
+            Y_UNUSED(i);
+            // small range to get both new and existing values, 0 and Max<ui32>() are valid values too
+            const ui32 hashedCatValue = (rng.GenRand() % 3) ? rng.Uniform(50000) : Max<ui32>() - rng.Uniform(3);
+            const auto it = expectedPerfectHash.find(hashedCatValue);
+            const ui32 expectedBin = (it == expectedPerfectHash.end()) ?
+                expectedPerfectHash.emplace(hashedCatValue, (ui32)expectedPerfectHash.size()).first->second
+                : it->second;
+            UNIT_ASSERT_VALUES_EQUAL(perfectHash.FindOrInsert(hashedCatValue), expectedBin);
+        }
+        UNIT_ASSERT_VALUES_EQUAL(perfectHash.GetSize(), expectedPerfectHash.size());
+
+        for (const auto& [hashedCatValue, bin] : expectedPerfectHash) {
+            UNIT_ASSERT_VALUES_EQUAL(*perfectHash.Find(hashedCatValue), bin);
+        }
+        UNIT_ASSERT(!perfectHash.Find(60000));
+
+        UNIT_ASSERT_EQUAL(perfectHash, TCatFeaturePerfectHashMap(expectedPerfectHash));
+    }
+
+    Y_UNIT_TEST(FindOrInsertBatch) {
+        const TVector<ui32> hashedCatValues = {12, 0, 25, 12, 10, 0, 8, 165, 25, 1};
+        const TVector<ui32> expectedBins = {0, 1, 2, 0, 3, 1, 4, 5, 2, 6};
+
+        TCatFeaturePerfectHashMap perfectHash;
+        TVector<ui32> bins(hashedCatValues.size());
+        perfectHash.FindOrInsertBatch(hashedCatValues, bins);
+
+        UNIT_ASSERT_VALUES_EQUAL(bins, expectedBins);
+        UNIT_ASSERT_VALUES_EQUAL(perfectHash.GetSize(), 7);
+        UNIT_ASSERT_VALUES_EQUAL(perfectHash.GetHashedCatValuesByBins(), (TVector<ui32>{12, 0, 25, 10, 8, 165, 1}));
+    }
+
+    Y_UNIT_TEST(SaveLoad) {
+        TCatFeaturePerfectHashMap perfectHash(TMap<ui32, ui32>{{256, 0}, {45, 1}, {9, 2}, {0, 3}});
+
+        TBufferStream stream;
+        ::Save(&stream, perfectHash);
+
+        TCatFeaturePerfectHashMap loadedPerfectHash;
+        ::Load(&stream, loadedPerfectHash);
+
+        UNIT_ASSERT_EQUAL(loadedPerfectHash, perfectHash);
+        UNIT_ASSERT_VALUES_EQUAL(loadedPerfectHash.FindOrInsert(7), 4);
+    }
+}
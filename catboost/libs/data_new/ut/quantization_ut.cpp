@@ -20,14 +20,20 @@ Y_UNIT_TEST_SUITE(Quantization) {
         TExpectedQuantizedData ExpectedData;
     };
 
-    void Test(std::function<TTestCase()>&& generateTestCase) {
+    void Test(
+        const std::function<TTestCase()>& generateTestCase,
+        bool useQuantileSketchForBuildBorders = false
+    ) {
         for (auto quantizationOptions : {
                 TQuantizationOptions{true, false},
                 TQuantizationOptions{false, true},
                 TQuantizationOptions{true, true}
              })
         {
-            quantizationOptions.MaxSubsetSizeForSlowBuildBordersAlgorithms = 7;
+            // sketch is exact for small data, sample from it is the full sorted data if it is not truncated
+            quantizationOptions.MaxSubsetSizeForSlowBuildBordersAlgorithms
+                = useQuantileSketchForBuildBorders ? 1000 : 7;
+            quantizationOptions.UseQuantileSketchForBuildBorders = useQuantileSketchForBuildBorders;
 
             for (auto clearSrcData : {false, true}) {
                 TTestCase testCase = generateTestCase();
@@ -168,7 +174,8 @@ Y_UNIT_TEST_SUITE(Quantization) {
             return testCase;
         };
 
-        Test(std::move(generateTestCase));
+        Test(generateTestCase);
+        Test(generateTestCase, /*useQuantileSketchForBuildBorders*/ true);
     }
 
     Y_UNIT_TEST(TestFloatFeaturesWithCalcBordersOverSubset) {
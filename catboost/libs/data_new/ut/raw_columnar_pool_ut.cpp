@@ -0,0 +1,146 @@
+#include <catboost/libs/data_new/ut/lib/for_loader.h>
+
+#include <catboost/libs/data_new/data_provider.h>
+#include <catboost/libs/data_new/load_data.h>
+#include <catboost/libs/data_new/raw_columnar_pool.h>
+#include <catboost/libs/helpers/vector_helpers.h>
+
+#include <util/generic/strbuf.h>
+#include <util/generic/xrange.h>
+#include <util/system/mktemp.h>
+#include <util/system/tempfile.h>
+
+#include <library/unittest/registar.h>
+
+
+using namespace NCB;
+using namespace NCB::NDataNewUT;
+
+
+Y_UNIT_TEST_SUITE(RawColumnarPool) {
+    TRawDataProviderPtr ReadRawDataset(
+        const TPathWithScheme& poolPath,
+        const NCatboostOptions::TDsvPoolFormatParams& dsvPoolFormatParams,
+        const TVector<ui32>& ignoredFeatures,
+        NPar::TLocalExecutor* localExecutor
+    ) {
+        TDataProviderPtr dataProvider = ReadDataset(
+            poolPath,
+            /*pairsFilePath*/ TPathWithScheme(),
+            /*groupWeightsFilePath*/ TPathWithScheme(),
+            dsvPoolFormatParams,
+            ignoredFeatures,
+            EObjectsOrder::Undefined,
+            localExecutor
+        );
+        TRawDataProviderPtr rawDataProvider = dataProvider->CastMoveTo<TRawObjectsDataProvider>();
+        UNIT_ASSERT(rawDataProvider);
+        return rawDataProvider;
+    }
+
+    void Test(const TSrcData& srcData) {
+        TReadDatasetMainParams readDatasetMainParams;
+
+        TVector<THolder<TTempFile>> srcDataFiles;
+
+        SaveSrcData(srcData, &readDatasetMainParams, &srcDataFiles);
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        TRawDataProviderPtr dsvDataProvider = ReadRawDataset(
+            readDatasetMainParams.PoolPath,
+            readDatasetMainParams.DsvPoolFormatParams,
+            srcData.IgnoredFeatures,
+            &localExecutor
+        );
+
+        const TString columnarPoolFileName = MakeTempName();
+        TTempFile columnarPoolFile(columnarPoolFileName);
+        SaveRawColumnarPool(*dsvDataProvider, columnarPoolFileName);
+
+        TRawDataProviderPtr columnarDataProvider = ReadRawDataset(
+            TPathWithScheme("raw-columnar://" + columnarPoolFileName),
+            NCatboostOptions::TDsvPoolFormatParams(),
+            /*ignoredFeatures*/ {},
+            &localExecutor
+        );
+
+        UNIT_ASSERT_EQUAL(columnarDataProvider->MetaInfo, dsvDataProvider->MetaInfo);
+        UNIT_ASSERT_EQUAL(*columnarDataProvider->ObjectsGrouping, *dsvDataProvider->ObjectsGrouping);
+        UNIT_ASSERT_EQUAL(columnarDataProvider->RawTargetData, dsvDataProvider->RawTargetData);
+
+        const auto& expectedObjects = *dsvDataProvider->ObjectsData;
+        const auto& objects = *columnarDataProvider->ObjectsData;
+        UNIT_ASSERT_EQUAL(objects.GetGroupIds(), expectedObjects.GetGroupIds());
+        UNIT_ASSERT_EQUAL(objects.GetSubgroupIds(), expectedObjects.GetSubgroupIds());
+        UNIT_ASSERT_EQUAL(objects.GetTimestamp(), expectedObjects.GetTimestamp());
+
+        const auto& featuresLayout = *objects.GetFeaturesLayout();
+        for (auto floatFeatureIdx : xrange(featuresLayout.GetFloatFeatureCount())) {
+            auto expectedFeature = expectedObjects.GetFloatFeature(floatFeatureIdx);
+            auto feature = objects.GetFloatFeature(floatFeatureIdx);
+            UNIT_ASSERT_VALUES_EQUAL(feature.Defined(), expectedFeature.Defined());
+            if (feature) {
+                UNIT_ASSERT(
+                    EqualWithNans<float>(
+                        **(*expectedFeature)->GetArrayData().GetSrc(),
+                        (*feature)->GetArrayData()
+                    )
+                );
+            }
+        }
+        for (auto catFeatureIdx : xrange(featuresLayout.GetCatFeatureCount())) {
+            auto expectedFeature = expectedObjects.GetCatFeature(catFeatureIdx);
+            auto feature = objects.GetCatFeature(catFeatureIdx);
+            UNIT_ASSERT_VALUES_EQUAL(feature.Defined(), expectedFeature.Defined());
+            if (feature) {
+                UNIT_ASSERT(
+                    Equal<ui32>(**(*expectedFeature)->GetArrayData().GetSrc(), (*feature)->GetArrayData())
+                );
+            }
+        }
+    }
+
+
+    Y_UNIT_TEST(FloatFeatures) {
+        TSrcData srcData;
+        srcData.CdFileData = AsStringBuf("0\tTarget");
+        srcData.DsvFileData = AsStringBuf(
+            "Target\tFeat0\tFeat1\n"
+            "0\t0.1\t0.2\n"
+            "1\t0.97\tnan\n"
+            "0\t0.13\t0.22\n"
+        );
+        srcData.DsvFileHasHeader = true;
+        Test(srcData);
+    }
+
+    Y_UNIT_TEST(AllColumnTypes) {
+        TSrcData srcData;
+        srcData.CdFileData = AsStringBuf(
+            "0\tTarget\n"
+            "1\tGroupId\n"
+            "2\tSubgroupId\n"
+            "3\tWeight\n"
+            "4\tGroupWeight\n"
+            "5\tBaseline\n"
+            "6\tTimestamp\n"
+            "7\tNum\tf0\n"
+            "8\tCateg\tc0\n"
+            "9\tNum\tf1\n"
+            "10\tAuxiliary\n"
+            "11\tCateg\tc1\n"
+        );
+        srcData.DsvFileData = AsStringBuf(
+            "good\tquery0\tsite1\t0.12\t1.0\t0.1\t10\t0.1\tm\t0.2\taux\ta\n"
+            "bad\tquery0\tsite22\t0.18\t1.0\t0.2\t11\t0.97\tf\t0.82\taux\tb\n"
+            "good\tquery1\tSite9\t1.0\t0.0\t-0.3\t12\t0.13\tm\t0.22\taux\tc\n"
+            "bad\tQuery 2\tsite12\t0.45\t0.5\t0.4\t13\t0.14\tf\t0.18\taux\td\n"
+            "good\tQuery 2\tsite22\t1.0\t0.5\t0.5\t14\t0.9\tm\t0.67\taux\te\n"
+        );
+        srcData.DsvFileHasHeader = false;
+        srcData.IgnoredFeatures = {2};
+        Test(srcData);
+    }
+}
@@ -68,7 +68,8 @@ namespace NCatboostDistributed {
             { plainFold },
             isPairwiseScoring,
             defaultCalcStatsObjBlockSize,
-            GetBernoulliSampleRate(localData.Params.ObliviousTreeOptions->BootstrapConfig));
+            GetSampleRate(localData.Params.ObliviousTreeOptions->BootstrapConfig),
+            IsSampledBySampleWeights(localData.Params.ObliviousTreeOptions->BootstrapConfig));
         if (localData.UseTreeLevelCaching) {
             localData.SmallestSplitSideDocs.Create(
                 { plainFold },
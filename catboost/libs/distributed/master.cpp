@@ -392,6 +392,7 @@ public:
             l2Regularizer,
             sumAllWeights,
             allDocCount,
+            ctx.LocalExecutor,
             &leafValues);
         } else {
             Y_ASSERT(estimationMethod == ELeavesEstimation::Gradient);
@@ -401,6 +402,7 @@ public:
                 l2Regularizer,
                 sumAllWeights,
                 allDocCount,
+                ctx.LocalExecutor,
                 &leafValues);
         }
         return leafValues;
@@ -8,6 +8,9 @@
 #include <catboost/libs/logging/logging.h>
 #include <catboost/libs/target/data_providers.h>
 
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/algorithm.h>
 #include <util/generic/cast.h>
 #include <util/generic/maybe.h>
 #include <util/generic/ptr.h>
@@ -40,71 +43,113 @@ static TUpdateMethod ParseUpdateMethod(const TString& updateMethod) {
     return TUpdateMethod(updateType, topSize);
 }
 
-static TDStrResult GetFinalDocumentImportances(
-    const TVector<TVector<double>>& rawImportances,
+static std::function<bool(double)> GetImportanceValuesSignPredicate(EImportanceValuesSign importanceValuesSign) {
+    if (importanceValuesSign == EImportanceValuesSign::Positive) {
+        return [](double v){return v > 0;};
+    } else if (importanceValuesSign == EImportanceValuesSign::Negative) {
+        return [](double v){return v < 0;};
+    } else {
+        Y_ASSERT(importanceValuesSign == EImportanceValuesSign::All);
+        return [](double){return true;};
+    }
+}
+
+// Top is selected by absolute value first, then values with other sign are dropped from it.
+static void FilterBySign(EImportanceValuesSign importanceValuesSign, TVector<ui32>* indices, TVector<double>* scores) {
+    const auto predicate = GetImportanceValuesSignPredicate(importanceValuesSign);
+    size_t filteredSize = 0;
+    for (size_t i = 0; i < scores->size(); ++i) {
+        if (predicate((*scores)[i])) {
+            (*indices)[filteredSize] = (*indices)[i];
+            (*scores)[filteredSize] = (*scores)[i];
+            ++filteredSize;
+        }
+    }
+    indices->resize(filteredSize);
+    scores->resize(filteredSize);
+}
+
+/* Importances are aggregated while train objects are evaluated, so the whole train x test matrix is never
+ * materialized:
+ *   PerObject - bounded top of train objects for each test object,
+ *   Average - sum over test objects for each train object, top is selected at the end,
+ *   Raw - only the first topSize train objects are evaluated.
+ */
+static TDStrResult CalcFinalDocumentImportances(
+    TDocumentImportancesEvaluator* evaluator,
+    const TProcessedDataProvider& testProcessedData,
     EDocumentStrengthType docImpMethod,
-    int topSize,
-    EImportanceValuesSign importanceValuesSign
+    ui32 topSize,
+    EImportanceValuesSign importanceValuesSign,
+    NPar::TLocalExecutor* localExecutor,
+    int logPeriod
 ) {
-    const ui32 trainDocCount = rawImportances.size();
-    Y_ASSERT(rawImportances.size() != 0);
-    const ui32 testDocCount = rawImportances[0].size();
-    TVector<TVector<double>> preprocessedImportances;
+    const ui32 trainDocCount = evaluator->GetTrainDocCount();
+    const ui32 testDocCount = testProcessedData.GetObjectCount();
+    Y_ASSERT(trainDocCount != 0);
+
+    TDStrResult result;
     if (docImpMethod == EDocumentStrengthType::Average) {
-        preprocessedImportances = TVector<TVector<double>>(1, TVector<double>(trainDocCount));
+        TVector<double> importancesSum(trainDocCount);
+        evaluator->GetDocumentImportances(
+            testProcessedData,
+            trainDocCount,
+            [&] (ui32 blockStart, TConstArrayRef<TVector<double>> blockImportances) {
+                localExecutor->ExecRange([&] (int i) {
+                    const auto& importances = blockImportances[i];
+                    importancesSum[blockStart + i] = Accumulate(importances.begin(), importances.end(), 0.0);
+                }, 0, blockImportances.size(), NPar::TLocalExecutor::WAIT_COMPLETE);
+            },
+            logPeriod);
+
+        TTopImportances top(topSize);
         for (ui32 trainDocId = 0; trainDocId < trainDocCount; ++trainDocId) {
-            for (ui32 testDocId = 0; testDocId < testDocCount; ++testDocId) {
-                preprocessedImportances[0][trainDocId] += rawImportances[trainDocId][testDocId];
-            }
+            top.Add(trainDocId, importancesSum[trainDocId] / testDocCount);
         }
-        for (ui32 trainDocId = 0; trainDocId < trainDocCount; ++trainDocId) {
-            preprocessedImportances[0][trainDocId] /= testDocCount;
+        result = TDStrResult(1);
+        top.Finish(&result.Indices[0], &result.Scores[0]);
+    } else if (docImpMethod == EDocumentStrengthType::PerObject) {
+        TVector<TTopImportances> tops(testDocCount, TTopImportances(topSize));
+        evaluator->GetDocumentImportances(
+            testProcessedData,
+            trainDocCount,
+            [&] (ui32 blockStart, TConstArrayRef<TVector<double>> blockImportances) {
+                NPar::ParallelFor(*localExecutor, 0, testDocCount, [&] (int testDocId) {
+                    for (ui32 i = 0; i < blockImportances.size(); ++i) {
+                        tops[testDocId].Add(blockStart + i, blockImportances[i][testDocId]);
+                    }
+                });
+            },
+            logPeriod);
+
+        result = TDStrResult(testDocCount);
+        for (ui32 testDocId = 0; testDocId < testDocCount; ++testDocId) {
+            tops[testDocId].Finish(&result.Indices[testDocId], &result.Scores[testDocId]);
         }
-
     } else {
-        Y_ASSERT(docImpMethod == EDocumentStrengthType::PerObject || docImpMethod == EDocumentStrengthType::Raw);
-        preprocessedImportances = TVector<TVector<double>>(testDocCount, TVector<double>(trainDocCount));
-        for (ui32 trainDocId = 0; trainDocId < trainDocCount; ++trainDocId) {
-            for (ui32 testDocId = 0; testDocId < testDocCount; ++testDocId) {
-                preprocessedImportances[testDocId][trainDocId] = rawImportances[trainDocId][testDocId];
-            }
+        Y_ASSERT(docImpMethod == EDocumentStrengthType::Raw);
+        const ui32 evaluatedTrainDocCount = Min(topSize, trainDocCount);
+        result = TDStrResult(testDocCount);
+        for (ui32 testDocId = 0; testDocId < testDocCount; ++testDocId) {
+            result.Indices[testDocId].resize(evaluatedTrainDocCount);
+            std::iota(result.Indices[testDocId].begin(), result.Indices[testDocId].end(), 0);
+            result.Scores[testDocId].yresize(evaluatedTrainDocCount);
         }
+        evaluator->GetDocumentImportances(
+            testProcessedData,
+            evaluatedTrainDocCount,
+            [&] (ui32 blockStart, TConstArrayRef<TVector<double>> blockImportances) {
+                NPar::ParallelFor(*localExecutor, 0, testDocCount, [&] (int testDocId) {
+                    for (ui32 i = 0; i < blockImportances.size(); ++i) {
+                        result.Scores[testDocId][blockStart + i] = blockImportances[i][testDocId];
+                    }
+                });
+            },
+            logPeriod);
     }
 
-    TDStrResult result(preprocessedImportances.size());
-    for (ui32 testDocId = 0; testDocId < preprocessedImportances.size(); ++testDocId) {
-        TVector<double>& preprocessedImportancesRef = preprocessedImportances[testDocId];
-
-        const ui32 docCount = preprocessedImportancesRef.size();
-        TVector<ui32> indices(docCount);
-        std::iota(indices.begin(), indices.end(), 0);
-        if (docImpMethod != EDocumentStrengthType::Raw) {
-            Sort(indices.begin(), indices.end(), [&](ui32 first, ui32 second) {
-                return Abs(preprocessedImportancesRef[first]) > Abs(preprocessedImportancesRef[second]);
-            });
-        }
-
-        std::function<bool(double)> predicate;
-        if (importanceValuesSign == EImportanceValuesSign::Positive) {
-            predicate = [](double v){return v > 0;};
-        } else if (importanceValuesSign == EImportanceValuesSign::Negative) {
-            predicate = [](double v){return v < 0;};
-        } else {
-            Y_ASSERT(importanceValuesSign == EImportanceValuesSign::All);
-            predicate = [](double){return true;};
-        }
-
-        int currentSize = 0;
-        for (ui32 i = 0; i < docCount; ++i) {
-            if (currentSize == topSize) {
-                break;
-            }
-            if (predicate(preprocessedImportancesRef[indices[i]])) {
-                result.Scores[testDocId].push_back(preprocessedImportancesRef[indices[i]]);
-                result.Indices[testDocId].push_back(indices[i]);
-            }
-            ++currentSize;
-        }
+    for (ui32 resultIdx = 0; resultIdx < result.Scores.size(); ++resultIdx) {
+        FilterBySign(importanceValuesSign, &result.Indices[resultIdx], &result.Scores[resultIdx]);
     }
     return result;
 }
@@ -159,8 +204,13 @@ TDStrResult GetDocumentImportances(
     ExecuteTasksInParallel(&tasks, localExecutor.Get());
 
     TDocumentImportancesEvaluator leafInfluenceEvaluator(model, *trainProcessedData, updateMethod, localExecutor, logPeriod);
-    const TVector<TVector<double>> documentImportances
-        = leafInfluenceEvaluator.GetDocumentImportances(*testProcessedData, logPeriod);
-    return GetFinalDocumentImportances(documentImportances, dstrType, topSize, importanceValuesSign);
+    return CalcFinalDocumentImportances(
+        &leafInfluenceEvaluator,
+        *testProcessedData,
+        dstrType,
+        SafeIntegerCast<ui32>(topSize),
+        importanceValuesSign,
+        localExecutor.Get(),
+        logPeriod);
 }
 
@@ -18,49 +18,108 @@
 using namespace NCB;
 
 
-TVector<TVector<double>> TDocumentImportancesEvaluator::GetDocumentImportances(
-    const TProcessedDataProvider& processedData, int logPeriod
-) {
-    const auto* rawObjectsData = dynamic_cast<TRawObjectsDataProvider*>(processedData.ObjectsData.Get());
-    CB_ENSURE(rawObjectsData, "Quantized datasets are not supported yet");
+static bool IsMoreImportant(const std::pair<double, ui32>& lhs, const std::pair<double, ui32>& rhs) {
+    const double lhsAbs = Abs(lhs.first);
+    const double rhsAbs = Abs(rhs.first);
+    return lhsAbs > rhsAbs || (lhsAbs == rhsAbs && lhs.second < rhs.second);
+}
+
+void TTopImportances::Add(ui32 trainDocId, double importance) {
+    const auto candidate = std::make_pair(importance, trainDocId);
+    if (Heap.size() < TopSize) {
+        Heap.push_back(candidate);
+        PushHeap(Heap.begin(), Heap.end(), IsMoreImportant);
+    } else if (TopSize > 0 && IsMoreImportant(candidate, Heap.front())) {
+        PopHeap(Heap.begin(), Heap.end(), IsMoreImportant);
+        Heap.back() = candidate;
+        PushHeap(Heap.begin(), Heap.end(), IsMoreImportant);
+    }
+}
 
-    TVector<TVector<ui32>> leafIndices(TreeCount);
-    const TVector<ui8> binarizedFeatures = BinarizeFeatures(Model, *rawObjectsData);
-    LocalExecutor->ExecRange([&] (int treeId) {
-        leafIndices[treeId] = BuildIndicesForBinTree(Model, binarizedFeatures, treeId);
-    }, NPar::TLocalExecutor::TExecRangeParams(0, TreeCount), NPar::TLocalExecutor::WAIT_COMPLETE);
+void TTopImportances::Finish(TVector<ui32>* trainDocIds, TVector<double>* importances) {
+    Sort(Heap.begin(), Heap.end(), IsMoreImportant);
+    trainDocIds->clear();
+    importances->clear();
+    trainDocIds->reserve(Heap.size());
+    importances->reserve(Heap.size());
+    for (const auto& [importance, trainDocId] : Heap) {
+        trainDocIds->push_back(trainDocId);
+        importances->push_back(importance);
+    }
+    Heap.clear();
+    Heap.shrink_to_fit();
+}
 
+void TDocumentImportancesEvaluator::GetDocumentImportances(
+    const TProcessedDataProvider& processedData,
+    ui32 trainDocCount,
+    const TDocumentImportancesBlockProcessor& processBlock,
+    int logPeriod
+) {
+    CB_ENSURE(trainDocCount <= DocCount, "Requested more train objects than there are in train dataset");
 
+    if (GetMaxTreeDepth(Model) <= 8) {
+        TVector<TVector<ui8>> leafIndices;
+        BuildLeafIndicesForAllTrees(Model, *processedData.ObjectsData, LocalExecutor.Get(), &leafIndices);
+        GetDocumentImportancesImpl(processedData, leafIndices, trainDocCount, processBlock, logPeriod);
+    } else {
+        TVector<TVector<ui32>> leafIndices;
+        BuildLeafIndicesForAllTrees(Model, *processedData.ObjectsData, LocalExecutor.Get(), &leafIndices);
+        GetDocumentImportancesImpl(processedData, leafIndices, trainDocCount, processBlock, logPeriod);
+    }
+}
+
+template <class TLeafIndexType>
+void TDocumentImportancesEvaluator::GetDocumentImportancesImpl(
+    const TProcessedDataProvider& processedData,
+    const TVector<TVector<TLeafIndexType>>& leafIndices,
+    ui32 trainDocCount,
+    const TDocumentImportancesBlockProcessor& processBlock,
+    int logPeriod
+) {
     UpdateFinalFirstDerivatives(leafIndices, GetTarget(processedData.TargetData));
-    TVector<TVector<double>> documentImportances(DocCount, TVector<double>(processedData.GetObjectCount()));
-    const size_t docBlockSize = 1000;
-    TImportanceLogger documentsLogger(DocCount, "documents processed", "Processing documents...", logPeriod);
-    TProfileInfo processDocumentsProfile(DocCount);
 
-    for (size_t start = 0; start < DocCount; start += docBlockSize) {
-        const size_t end = Min<size_t>(start + docBlockSize, DocCount);
+    // Importances of one block are kept in memory, so limit them by 2^25 values (256 MB).
+    const size_t testDocCount = processedData.GetObjectCount();
+    const size_t threadCount = LocalExecutor->GetThreadCount() + 1;
+    const size_t docBlockSize = Max<size_t>(threadCount, Min<size_t>(1000, (1 << 25) / Max<size_t>(testDocCount, 1)));
+    TVector<TVector<double>> blockImportances(Min<size_t>(docBlockSize, trainDocCount), TVector<double>(testDocCount));
+    TVector<TTrainDocScratch> scratches(threadCount);
+
+    TImportanceLogger documentsLogger(trainDocCount, "documents processed", "Processing documents...", logPeriod);
+    TProfileInfo processDocumentsProfile(trainDocCount);
+
+    for (size_t start = 0; start < trainDocCount; start += docBlockSize) {
+        const size_t end = Min<size_t>(start + docBlockSize, trainDocCount);
         processDocumentsProfile.StartIterationBlock();
 
-        LocalExecutor->ExecRange([&] (int docId) {
-            // The derivative of leaf values with respect to train doc weight.
-            TVector<TVector<TVector<double>>> leafDerivatives(TreeCount, TVector<TVector<double>>(LeavesEstimationIterations)); // [treeCount][LeavesEstimationIterationsCount][leafCount]
-            UpdateLeavesDerivatives(docId, &leafDerivatives);
-            GetDocumentImportancesForOneTrainDoc(leafDerivatives, leafIndices, &documentImportances[docId]);
-        }, NPar::TLocalExecutor::TExecRangeParams(start, end), NPar::TLocalExecutor::WAIT_COMPLETE);
+        NPar::TLocalExecutor::TExecRangeParams blockParams(start, end);
+        blockParams.SetBlockCount(threadCount);
+        LocalExecutor->ExecRange([&] (int blockId) {
+            const int blockFirstId = blockParams.FirstId + blockId * blockParams.GetBlockSize();
+            const int blockLastId = Min(blockParams.LastId, blockFirstId + blockParams.GetBlockSize());
+            TTrainDocScratch* scratch = &scratches[blockId];
+            for (int docId = blockFirstId; docId < blockLastId; ++docId) {
+                UpdateLeavesDerivatives(docId, scratch);
+                GetDocumentImportancesForOneTrainDoc(leafIndices, scratch, &blockImportances[docId - start]);
+            }
+        }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
+
+        processBlock(start, MakeArrayRef(blockImportances.data(), end - start));
 
         processDocumentsProfile.FinishIterationBlock(end - start);
         auto profileResults = processDocumentsProfile.GetProfileResults();
         documentsLogger.Log(profileResults);
-        }
-    return documentImportances;
+    }
 }
 
-void TDocumentImportancesEvaluator::UpdateFinalFirstDerivatives(const TVector<TVector<ui32>>& leafIndices, TConstArrayRef<float> target) {
+template <class TLeafIndexType>
+void TDocumentImportancesEvaluator::UpdateFinalFirstDerivatives(const TVector<TVector<TLeafIndexType>>& leafIndices, TConstArrayRef<float> target) {
     const ui32 docCount = SafeIntegerCast<ui32>(target.size());
     TVector<double> finalApproxes(docCount);
 
     for (ui32 treeId = 0; treeId < TreeCount; ++treeId) {
-        const TVector<ui32>& leafIndicesRef = leafIndices[treeId];
+        const TVector<TLeafIndexType>& leafIndicesRef = leafIndices[treeId];
         for (ui32 it = 0; it < LeavesEstimationIterations; ++it) {
             const TVector<double>& leafValues = TreesStatistics[treeId].LeafValues[it];
             for (ui32 docId = 0; docId < docCount; ++docId) {
@@ -73,42 +132,51 @@ void TDocumentImportancesEvaluator::UpdateFinalFirstDerivatives(const TVector<TV
     EvaluateDerivatives(LossFunction, LeafEstimationMethod, finalApproxes, target, &FinalFirstDerivatives, nullptr, nullptr);
 }
 
-TVector<ui32> TDocumentImportancesEvaluator::GetLeafIdToUpdate(ui32 treeId, const TVector<double>& jacobian) {
-    TVector<ui32> leafIdToUpdate;
+void TDocumentImportancesEvaluator::GetLeafIdToUpdate(ui32 treeId, TTrainDocScratch* scratch) {
+    TVector<ui32>& leafIdToUpdate = scratch->LeafIdToUpdate;
     const ui32 leafCount = 1 << Model.ObliviousTrees.TreeSizes[treeId];
 
     if (UpdateMethod.UpdateType == EUpdateType::AllPoints) {
-        leafIdToUpdate.resize(leafCount);
+        leafIdToUpdate.yresize(leafCount);
         std::iota(leafIdToUpdate.begin(), leafIdToUpdate.end(), 0);
     } else if (UpdateMethod.UpdateType == EUpdateType::TopKLeaves) {
         const TVector<ui32>& leafIndices = TreesStatistics[treeId].LeafIndices;
-        TVector<double> leafJacobians(leafCount);
+        const TVector<double>& jacobian = scratch->Jacobian;
+        TVector<double>& leafJacobians = scratch->LeafJacobians;
+        leafJacobians.assign(leafCount, 0.0);
         for (ui32 docId = 0; docId < DocCount; ++docId) {
             leafJacobians[leafIndices[docId]] += Abs(jacobian[docId]);
         }
 
-        TVector<ui32> orderedLeafIndices(leafCount);
+        TVector<ui32>& orderedLeafIndices = scratch->OrderedLeafIndices;
+        orderedLeafIndices.yresize(leafCount);
         std::iota(orderedLeafIndices.begin(), orderedLeafIndices.end(), 0);
         Sort(orderedLeafIndices.begin(), orderedLeafIndices.end(), [&](ui32 firstDocId, ui32 secondDocId) {
             return leafJacobians[firstDocId] > leafJacobians[secondDocId];
         });
 
-        leafIdToUpdate = TVector<ui32>(
+        leafIdToUpdate.assign(
             orderedLeafIndices.begin(),
             orderedLeafIndices.begin() + Min<ui32>(UpdateMethod.TopSize, leafCount)
         );
+    } else {
+        leafIdToUpdate.clear();
     }
-
-    return leafIdToUpdate;
 }
 
-void TDocumentImportancesEvaluator::UpdateLeavesDerivatives(ui32 removedDocId, TVector<TVector<TVector<double>>>* leafDerivatives) {
-    TVector<double> jacobian(DocCount);
+void TDocumentImportancesEvaluator::UpdateLeavesDerivatives(ui32 removedDocId, TTrainDocScratch* scratch) {
+    // The derivative of leaf values with respect to train doc weight.
+    auto& leafDerivatives = scratch->LeafDerivatives;
+    leafDerivatives.resize(TreeCount);
+    TVector<double>& jacobian = scratch->Jacobian;
+    jacobian.assign(DocCount, 0.0);
+    const TVector<ui32>& leafIdToUpdate = scratch->LeafIdToUpdate;
     for (ui32 treeId = 0; treeId < TreeCount; ++treeId) {
         auto& treeStatistics = TreesStatistics[treeId];
+        leafDerivatives[treeId].resize(LeavesEstimationIterations);
         for (ui32 it = 0; it < LeavesEstimationIterations; ++it) {
-            const TVector<ui32> leafIdToUpdate = GetLeafIdToUpdate(treeId, jacobian);
-            TVector<double>& leafDerivativesRef = (*leafDerivatives)[treeId][it];
+            GetLeafIdToUpdate(treeId, scratch);
+            TVector<double>& leafDerivativesRef = leafDerivatives[treeId][it];
 
             // Updating Leaves Derivatives
             UpdateLeavesDerivativesForTree(
@@ -136,16 +204,19 @@ void TDocumentImportancesEvaluator::UpdateLeavesDerivatives(ui32 removedDocId, T
     }
 }
 
+template <class TLeafIndexType>
 void TDocumentImportancesEvaluator::GetDocumentImportancesForOneTrainDoc(
-    const TVector<TVector<TVector<double>>>& leafDerivatives,
-    const TVector<TVector<ui32>>& leafIndices,
+    const TVector<TVector<TLeafIndexType>>& leafIndices,
+    TTrainDocScratch* scratch,
     TVector<double>* documentImportance
 ) {
+    const auto& leafDerivatives = scratch->LeafDerivatives;
     const ui32 docCount = documentImportance->size();
-    TVector<double> predictedDerivatives(docCount);
+    TVector<double>& predictedDerivatives = scratch->PredictedDerivatives;
+    predictedDerivatives.assign(docCount, 0.0);
 
     for (ui32 treeId = 0; treeId < TreeCount; ++treeId) {
-        const TVector<ui32>& leafIndicesRef = leafIndices[treeId];
+        const TVector<TLeafIndexType>& leafIndicesRef = leafIndices[treeId];
         for (ui32 it = 0; it < LeavesEstimationIterations; ++it) {
             const TVector<double>& leafDerivativesRef = leafDerivatives[treeId][it];
             for (ui32 docId = 0; docId < docCount; ++docId) {
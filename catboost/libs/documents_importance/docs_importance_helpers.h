@@ -11,11 +11,14 @@
 
 #include <library/threading/local_executor/local_executor.h>
 
+#include <util/generic/array_ref.h>
 #include <util/generic/fwd.h>
 #include <util/generic/ptr.h>
 #include <util/system/types.h>
 #include <util/system/yassert.h>
 
+#include <functional>
+
 
 /*
  * This is the implementation of the LeafInfluence algorithm from the following paper:
@@ -37,6 +40,30 @@ struct TUpdateMethod {
     int TopSize;
 };
 
+// Keeps train objects with the largest absolute importances, ties are resolved in favor of smaller indices.
+class TTopImportances {
+public:
+    explicit TTopImportances(ui32 topSize = 0)
+        : TopSize(topSize)
+    {
+    }
+
+    void Add(ui32 trainDocId, double importance);
+
+    // Objects are ordered by decreasing absolute importance. Collected objects are cleared.
+    void Finish(TVector<ui32>* trainDocIds, TVector<double>* importances);
+
+private:
+    ui32 TopSize;
+    TVector<std::pair<double, ui32>> Heap; // worst collected object is at the top
+};
+
+// Called for each evaluated block of train objects. blockImportances[i][testDocId] is the importance
+// of train object blockStart + i for test object testDocId. The data is valid only during the call.
+using TDocumentImportancesBlockProcessor = std::function<void(
+    ui32 blockStart,
+    TConstArrayRef<TVector<double>> blockImportances)>;
+
 // The class for document importances evaluation.
 class TDocumentImportancesEvaluator {
 public:
@@ -67,23 +94,55 @@ public:
         Y_ASSERT(leavesEstimationMethod == ELeavesEstimation::Newton);
             treeStatisticsEvaluator = MakeHolder<TNewtonTreeStatisticsEvaluator>(DocCount);
         }
-        TreesStatistics = treeStatisticsEvaluator->EvaluateTreeStatistics(model, processedData, logPeriod);
+        TreesStatistics = treeStatisticsEvaluator->EvaluateTreeStatistics(model, processedData, LocalExecutor.Get(), logPeriod);
+    }
+
+    // Getting the importance of first trainDocCount train objects for all objects from pool.
+    // Train objects are evaluated in blocks, so only the importances of one block are kept in memory.
+    void GetDocumentImportances(
+        const NCB::TProcessedDataProvider& processedData,
+        ui32 trainDocCount,
+        const TDocumentImportancesBlockProcessor& processBlock,
+        int logPeriod = 0
+    );
+
+    ui32 GetTrainDocCount() const {
+        return DocCount;
     }
 
-    // Getting the importance of all train objects for all objects from pool.
-    TVector<TVector<double>> GetDocumentImportances(const NCB::TProcessedDataProvider& processedData, int logPeriod = 0);
+private:
+    // Buffers reused by one thread between train objects.
+    struct TTrainDocScratch {
+        TVector<TVector<TVector<double>>> LeafDerivatives; // [treeCount][LeavesEstimationIterationsCount][leafCount]
+        TVector<double> Jacobian; // [docCount]
+        TVector<ui32> LeafIdToUpdate;
+        TVector<double> LeafJacobians; // [leafCount]
+        TVector<ui32> OrderedLeafIndices; // [leafCount]
+        TVector<double> PredictedDerivatives; // [testDocCount]
+    };
 
 private:
+    // Leaf indices of pool objects are ui8 if all trees have depth up to 8, ui32 otherwise.
+    template <class TLeafIndexType>
+    void GetDocumentImportancesImpl(
+        const NCB::TProcessedDataProvider& processedData,
+        const TVector<TVector<TLeafIndexType>>& leafIndices,
+        ui32 trainDocCount,
+        const TDocumentImportancesBlockProcessor& processBlock,
+        int logPeriod
+    );
     // Evaluate first derivatives at the final approxes
-    void UpdateFinalFirstDerivatives(const TVector<TVector<ui32>>& leafIndices, TConstArrayRef<float> target);
+    template <class TLeafIndexType>
+    void UpdateFinalFirstDerivatives(const TVector<TVector<TLeafIndexType>>& leafIndices, TConstArrayRef<float> target);
     // Leaves derivatives will be updated based on objects from these leaves.
-    TVector<ui32> GetLeafIdToUpdate(ui32 treeId, const TVector<double>& jacobian);
+    void GetLeafIdToUpdate(ui32 treeId, TTrainDocScratch* scratch);
     // Algorithm 4 from paper.
-    void UpdateLeavesDerivatives(ui32 removedDocId, TVector<TVector<TVector<double>>>* leafDerivatives);
+    void UpdateLeavesDerivatives(ui32 removedDocId, TTrainDocScratch* scratch);
     // Getting the importance of one train object for all objects from pool.
+    template <class TLeafIndexType>
     void GetDocumentImportancesForOneTrainDoc(
-        const TVector<TVector<TVector<double>>>& leafDerivatives,
-        const TVector<TVector<ui32>>& leafIndices,
+        const TVector<TVector<TLeafIndexType>>& leafIndices,
+        TTrainDocScratch* scratch,
         TVector<double>* documentImportance
     );
     // Evaluate leaf derivatives at a given removedDocId weight (Equation (6) from paper).
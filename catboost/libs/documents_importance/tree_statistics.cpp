@@ -6,20 +6,41 @@
 #include <catboost/libs/loggers/logger.h>
 #include <catboost/libs/logging/profile_info.h>
 
+#include <util/generic/xrange.h>
+
 
 using namespace NCB;
 
 
+// Compact leaf indices are used when possible because they are calculated faster.
+static TVector<TVector<ui32>> CalcLeafIndices(
+    const TFullModel& model,
+    const TObjectsDataProvider& objectsData,
+    NPar::TLocalExecutor* localExecutor
+) {
+    TVector<TVector<ui32>> leafIndices;
+    if (GetMaxTreeDepth(model) <= 8) {
+        TVector<TVector<ui8>> compactLeafIndices;
+        BuildLeafIndicesForAllTrees(model, objectsData, localExecutor, &compactLeafIndices);
+        leafIndices.resize(compactLeafIndices.size());
+        for (auto treeId : xrange(compactLeafIndices.size())) {
+            leafIndices[treeId].assign(compactLeafIndices[treeId].begin(), compactLeafIndices[treeId].end());
+            TVector<ui8>().swap(compactLeafIndices[treeId]);
+        }
+    } else {
+        BuildLeafIndicesForAllTrees(model, objectsData, localExecutor, &leafIndices);
+    }
+    return leafIndices;
+}
+
 // ITreeStatisticsEvaluator
 
 TVector<TTreeStatistics> ITreeStatisticsEvaluator::EvaluateTreeStatistics(
     const TFullModel& model,
     const NCB::TProcessedDataProvider& processedData,
+    NPar::TLocalExecutor* localExecutor,
     int logPeriod
 ) {
-    const auto* rawObjectsData = dynamic_cast<TRawObjectsDataProvider*>(processedData.ObjectsData.Get());
-    CB_ENSURE(rawObjectsData, "Quantized datasets are not supported yet");
-
     NJson::TJsonValue paramsJson = ReadTJsonValue(model.ModelInfo.at("params"));
     const ELossFunction lossFunction = FromString<ELossFunction>(paramsJson["loss_function"]["type"].GetString());
     const ELeavesEstimation leafEstimationMethod = FromString<ELeavesEstimation>(paramsJson["tree_learner_options"]["leaf_estimation_method"].GetString());
@@ -28,7 +49,7 @@ TVector<TTreeStatistics> ITreeStatisticsEvaluator::EvaluateTreeStatistics(
     const float l2LeafReg = paramsJson["tree_learner_options"]["l2_leaf_reg"].GetDouble();
     const ui32 treeCount = model.ObliviousTrees.GetTreeCount();
 
-    const TVector<ui8> binarizedFeatures = BinarizeFeatures(model, *rawObjectsData);
+    TVector<TVector<ui32>> leafIndices = CalcLeafIndices(model, *processedData.ObjectsData, localExecutor);
     TVector<TTreeStatistics> treeStatistics;
     treeStatistics.reserve(treeCount);
     TVector<double> approxes(DocCount);
@@ -40,7 +61,7 @@ TVector<TTreeStatistics> ITreeStatisticsEvaluator::EvaluateTreeStatistics(
         processTreesProfile.StartIterationBlock();
 
         LeafCount = 1 << model.ObliviousTrees.TreeSizes[treeId];
-        LeafIndices = BuildIndicesForBinTree(model, binarizedFeatures, treeId);
+        LeafIndices = std::move(leafIndices[treeId]);
 
         TVector<TVector<ui32>> leavesDocId(LeafCount);
         for (ui32 docId = 0; docId < DocCount; ++docId) {
@@ -3,6 +3,8 @@
 #include <catboost/libs/data_new/data_provider.h>
 #include <catboost/libs/model/model.h>
 
+#include <library/threading/local_executor/local_executor.h>
+
 #include <util/generic/fwd.h>
 #include <util/generic/vector.h>
 #include <util/system/types.h>
@@ -35,6 +37,7 @@ public:
     TVector<TTreeStatistics> EvaluateTreeStatistics(
         const TFullModel& model,
         const NCB::TProcessedDataProvider& processedData,
+        NPar::TLocalExecutor* localExecutor,
         int logPeriod = 0
     );
 
@@ -0,0 +1,82 @@
+#include <catboost/libs/documents_importance/docs_importance_helpers.h>
+
+#include <library/unittest/registar.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+#include <util/random/fast.h>
+
+#include <numeric>
+
+
+// full sort of all train objects as it was done before importances were collected into bounded tops,
+// ties in absolute importance are resolved in favor of smaller indices
+static void GetTopByFullSort(
+    const TVector<double>& importances,
+    ui32 topSize,
+    TVector<ui32>* trainDocIds,
+    TVector<double>* topImportances
+) {
+    TVector<ui32> indices(importances.size());
+    std::iota(indices.begin(), indices.end(), 0);
+    StableSort(indices.begin(), indices.end(), [&](ui32 first, ui32 second) {
+        return Abs(importances[first]) > Abs(importances[second]);
+    });
+    indices.resize(Min<size_t>(topSize, indices.size()));
+    trainDocIds->clear();
+    topImportances->clear();
+    for (ui32 trainDocId : indices) {
+        trainDocIds->push_back(trainDocId);
+        topImportances->push_back(importances[trainDocId]);
+    }
+}
+
+Y_UNIT_TEST_SUITE(TopImportancesTest) {
+    Y_UNIT_TEST(SameAsFullSortWithTies) {
+        TFastRng64 rng(0);
+        for (ui32 trainDocCount : {1, 2, 7, 100, 1000}) {
+            TVector<double> importances(trainDocCount);
+            for (auto& importance : importances) {
+                // few distinct values, opposite signs of the same absolute value are ties too
+                importance = (double)rng.Uniform(5) - 2.0;
+            }
+            for (ui32 topSize : {0u, 1u, 3u, trainDocCount / 2, trainDocCount, trainDocCount + 5}) {
+                TTopImportances top(topSize);
+                for (auto trainDocId : xrange(trainDocCount)) {
+                    top.Add(trainDocId, importances[trainDocId]);
+                }
+                TVector<ui32> trainDocIds;
+                TVector<double> topImportances;
+                top.Finish(&trainDocIds, &topImportances);
+
+                TVector<ui32> expectedTrainDocIds;
+                TVector<double> expectedTopImportances;
+                GetTopByFullSort(importances, topSize, &expectedTrainDocIds, &expectedTopImportances);
+
+                UNIT_ASSERT_VALUES_EQUAL(trainDocIds, expectedTrainDocIds);
+                UNIT_ASSERT_VALUES_EQUAL(topImportances, expectedTopImportances);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(BottomObjectsAreDropped) {
+        // objects with smaller absolute importances are dropped, ties go to smaller indices
+        const TVector<double> importances = {0.5, -3.0, 0.0, 3.0, -0.5, 1.0, -1.0, 0.0};
+        TTopImportances top(4);
+        for (auto trainDocId : xrange(importances.size())) {
+            top.Add(trainDocId, importances[trainDocId]);
+        }
+        TVector<ui32> trainDocIds;
+        TVector<double> topImportances;
+        top.Finish(&trainDocIds, &topImportances);
+        UNIT_ASSERT_VALUES_EQUAL(trainDocIds, (TVector<ui32>{1, 3, 5, 6}));
+        UNIT_ASSERT_VALUES_EQUAL(topImportances, (TVector<double>{-3.0, 3.0, 1.0, -1.0}));
+
+        // collected objects are cleared by Finish
+        top.Add(2, 0.0);
+        top.Finish(&trainDocIds, &topImportances);
+        UNIT_ASSERT_VALUES_EQUAL(trainDocIds, (TVector<ui32>{2}));
+        UNIT_ASSERT_VALUES_EQUAL(topImportances, (TVector<double>{0.0}));
+    }
+}
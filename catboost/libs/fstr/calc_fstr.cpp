@@ -1,6 +1,7 @@
 #include "calc_fstr.h"
 
 #include "feature_str.h"
+#include "loss_change_fstr.h"
 #include "shap_values.h"
 #include "util.h"
 
@@ -393,6 +394,14 @@ TVector<TVector<double>> GetFeatureImportances(
 
             return CalcShapValues(model, *dataset, logPeriod, &localExecutor);
         }
+        case EFstrType::LossFunctionChange: {
+            CB_ENSURE(dataset, "dataset is not provided");
+
+            NPar::TLocalExecutor localExecutor;
+            localExecutor.RunAdditionalThreads(threadCount - 1);
+
+            return CalcLossFunctionChange(model, *dataset, &localExecutor);
+        }
         default:
             Y_UNREACHABLE();
     }
@@ -0,0 +1,271 @@
+#include "loss_change_fstr.h"
+
+#include <catboost/libs/algo/index_calcer.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/metrics/metric.h>
+#include <catboost/libs/options/json_helper.h>
+#include <catboost/libs/options/loss_description.h>
+#include <catboost/libs/target/data_providers.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/array_ref.h>
+#include <util/generic/cast.h>
+#include <util/generic/mapfindptr.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+
+using namespace NCB;
+
+
+namespace {
+    struct TTreeFeatureUsage {
+        ui32 TreeIdx = 0;
+        TIndexType SplitsMask = 0; // bits of leaf index corresponding to splits that use the feature
+    };
+}
+
+
+static NCatboostOptions::TLossDescription GetModelLossDescription(const TFullModel& model) {
+    const auto* modelInfoParams = MapFindPtr(model.ModelInfo, "params");
+    CB_ENSURE(modelInfoParams, "LossFunctionChange requires model with saved training params");
+    NJson::TJsonValue paramsJson = ReadTJsonValue(*modelInfoParams);
+    CB_ENSURE(paramsJson.Has("loss_function"), "LossFunctionChange requires loss_function in model params");
+    NCatboostOptions::TLossDescription lossDescription;
+    lossDescription.Load(paramsJson["loss_function"]);
+    return lossDescription;
+}
+
+static void AddExternalFeatureIndices(
+    const TModelSplit& split,
+    const TFeaturesLayout& layout,
+    TVector<ui32>* externalFeatureIndices)
+{
+    switch (split.Type) {
+        case ESplitType::FloatFeature:
+            externalFeatureIndices->push_back(
+                layout.GetExternalFeatureIdx(split.FloatFeature.FloatFeature, EFeatureType::Float));
+            break;
+        case ESplitType::OneHotFeature:
+            externalFeatureIndices->push_back(
+                layout.GetExternalFeatureIdx(split.OneHotFeature.CatFeatureIdx, EFeatureType::Categorical));
+            break;
+        case ESplitType::OnlineCtr: {
+            const auto& projection = split.OnlineCtr.Ctr.Base.Projection;
+            for (int catFeatureIdx : projection.CatFeatures) {
+                externalFeatureIndices->push_back(
+                    layout.GetExternalFeatureIdx(catFeatureIdx, EFeatureType::Categorical));
+            }
+            for (const auto& floatSplit : projection.BinFeatures) {
+                externalFeatureIndices->push_back(
+                    layout.GetExternalFeatureIdx(floatSplit.FloatFeature, EFeatureType::Float));
+            }
+            for (const auto& oneHotSplit : projection.OneHotFeatures) {
+                externalFeatureIndices->push_back(
+                    layout.GetExternalFeatureIdx(oneHotSplit.CatFeatureIdx, EFeatureType::Categorical));
+            }
+            break;
+        }
+    }
+}
+
+// [externalFeatureIdx] -> trees that use the feature
+static TVector<TVector<TTreeFeatureUsage>> GetFeatureUsageInTrees(const TObliviousTrees& forest) {
+    const TFeaturesLayout layout(forest.FloatFeatures, forest.CatFeatures);
+    const auto& binFeatures = forest.GetBinFeatures();
+
+    TVector<TVector<TTreeFeatureUsage>> featureUsage(layout.GetExternalFeatureCount());
+    TVector<ui32> externalFeatureIndices;
+    for (auto treeIdx : xrange(forest.GetTreeCount())) {
+        TVector<TIndexType> splitsMasks(featureUsage.size(), 0);
+        for (auto depth : xrange(forest.TreeSizes[treeIdx])) {
+            const int splitIdx = forest.TreeSplits[forest.TreeStartOffsets[treeIdx] + depth];
+            externalFeatureIndices.clear();
+            AddExternalFeatureIndices(binFeatures[splitIdx], layout, &externalFeatureIndices);
+            for (ui32 externalFeatureIdx : externalFeatureIndices) {
+                splitsMasks[externalFeatureIdx] |= (TIndexType(1) << depth);
+            }
+        }
+        for (auto externalFeatureIdx : xrange(featureUsage.size())) {
+            if (splitsMasks[externalFeatureIdx]) {
+                featureUsage[externalFeatureIdx].push_back({(ui32)treeIdx, splitsMasks[externalFeatureIdx]});
+            }
+        }
+    }
+    return featureUsage;
+}
+
+/* [leafIdx * approxDimension + dim]
+ * difference between leaf values averaged over all leaves that differ from leafIdx only in splitsMask bits
+ * and the original leaf values
+ * Leaves are weighted by LeafWeights if the model has them and the averaged leaves are not all empty.
+ */
+static TVector<double> CalcAblatedLeafValueDeltas(
+    const TObliviousTrees& forest,
+    const TTreeFeatureUsage& treeFeatureUsage)
+{
+    const int approxDimension = forest.ApproxDimension;
+    const size_t leafCount = size_t(1) << forest.TreeSizes[treeFeatureUsage.TreeIdx];
+    const double* leafValues = forest.GetFirstLeafPtrForTree(treeFeatureUsage.TreeIdx);
+    const TConstArrayRef<double> leafWeights = forest.LeafWeights.empty()
+        ? TConstArrayRef<double>()
+        : TConstArrayRef<double>(forest.LeafWeights[treeFeatureUsage.TreeIdx]);
+    const TIndexType splitsMask = treeFeatureUsage.SplitsMask;
+
+    // accumulate sums in leaves with zero splitsMask bits
+    TVector<double> leafValueSums(leafCount * approxDimension, 0.0);
+    TVector<double> weightedLeafValueSums(leafCount * approxDimension, 0.0);
+    TVector<double> leafWeightSums(leafCount, 0.0);
+    for (auto leafIdx : xrange(leafCount)) {
+        const size_t dstLeafIdx = leafIdx & ~splitsMask;
+        const double leafWeight = leafWeights.empty() ? 0.0 : leafWeights[leafIdx];
+        leafWeightSums[dstLeafIdx] += leafWeight;
+        for (auto dim : xrange(approxDimension)) {
+            const double leafValue = leafValues[leafIdx * approxDimension + dim];
+            leafValueSums[dstLeafIdx * approxDimension + dim] += leafValue;
+            weightedLeafValueSums[dstLeafIdx * approxDimension + dim] += leafWeight * leafValue;
+        }
+    }
+    double averagedLeafCount = 1.0;
+    for (auto depth : xrange(forest.TreeSizes[treeFeatureUsage.TreeIdx])) {
+        if (splitsMask & (TIndexType(1) << depth)) {
+            averagedLeafCount *= 2.0;
+        }
+    }
+
+    // store difference with original leaf values to update approx in one pass
+    TVector<double> ablatedLeafValueDeltas(leafCount * approxDimension);
+    for (auto leafIdx : xrange(leafCount)) {
+        const size_t srcLeafIdx = leafIdx & ~splitsMask;
+        for (auto dim : xrange(approxDimension)) {
+            const double ablatedLeafValue = leafWeightSums[srcLeafIdx] > 0.0
+                ? weightedLeafValueSums[srcLeafIdx * approxDimension + dim] / leafWeightSums[srcLeafIdx]
+                : leafValueSums[srcLeafIdx * approxDimension + dim] / averagedLeafCount;
+            ablatedLeafValueDeltas[leafIdx * approxDimension + dim]
+                = ablatedLeafValue - leafValues[leafIdx * approxDimension + dim];
+        }
+    }
+    return ablatedLeafValueDeltas;
+}
+
+TVector<TVector<double>> CalcLossFunctionChange(
+    const TFullModel& model,
+    const TDataProvider& dataset,
+    NPar::TLocalExecutor* localExecutor)
+{
+    const auto& forest = model.ObliviousTrees;
+    const auto* rawObjectsData = dynamic_cast<const TRawObjectsDataProvider*>(dataset.ObjectsData.Get());
+    CB_ENSURE(rawObjectsData, "Quantized datasets are not supported yet");
+
+    const NCatboostOptions::TLossDescription lossDescription = GetModelLossDescription(model);
+    const int approxDimension = forest.ApproxDimension;
+    TVector<THolder<IMetric>> metrics = CreateMetricFromDescription(lossDescription, approxDimension);
+    CB_ENSURE_INTERNAL(metrics.size() == 1, "loss_function should be a single metric");
+    const THolder<IMetric>& metric = metrics[0];
+
+    TRestorableFastRng64 rand(0);
+    const TProcessedDataProvider processedData = CreateModelCompatibleProcessedDataProvider(
+        dataset,
+        {lossDescription},
+        model,
+        &rand,
+        localExecutor);
+    const TMaybeData<TConstArrayRef<float>> maybeTarget = GetMaybeTarget(processedData.TargetData);
+    CB_ENSURE(maybeTarget || !metric->NeedTarget(), "LossFunctionChange requires dataset with target");
+    const TConstArrayRef<float> target = maybeTarget.GetOrElse(TConstArrayRef<float>());
+    const TConstArrayRef<float> weights = GetWeights(processedData.TargetData);
+    const TConstArrayRef<TQueryInfo> queriesInfo = GetGroupInfo(processedData.TargetData);
+
+    const size_t documentCount = dataset.GetObjectCount();
+    CB_ENSURE(documentCount > 0, "LossFunctionChange requires non-empty dataset");
+    const size_t treeCount = forest.GetTreeCount();
+
+    const TVector<ui8> binFeatures = BinarizeFeatures(model, *rawObjectsData);
+
+    NPar::TLocalExecutor::TExecRangeParams documentBlockParams(0, SafeIntegerCast<int>(documentCount));
+    documentBlockParams.SetBlockCount(localExecutor->GetThreadCount() + 1);
+
+    TVector<TVector<double>> approx(approxDimension, TVector<double>(documentCount, 0.0));
+    const TVector<TConstArrayRef<float>> baseline = GetBaseline(processedData.TargetData);
+    for (auto dim : xrange(baseline.size())) {
+        Copy(baseline[dim].begin(), baseline[dim].end(), approx[dim].begin());
+    }
+
+    // leaf indices are not kept for all trees, they are calculated for a block of trees at a time
+    const size_t treeBlockSize = localExecutor->GetThreadCount() + 1;
+    TVector<TVector<TIndexType>> leafIndices(treeBlockSize);
+    for (size_t treeBlockStart = 0; treeBlockStart < treeCount; treeBlockStart += treeBlockSize) {
+        const size_t treeBlockEnd = Min(treeBlockStart + treeBlockSize, treeCount);
+        localExecutor->ExecRange(
+            [&] (int treeIdx) {
+                leafIndices[treeIdx - treeBlockStart] = BuildIndicesForBinTree(model, binFeatures, treeIdx);
+            },
+            SafeIntegerCast<int>(treeBlockStart),
+            SafeIntegerCast<int>(treeBlockEnd),
+            NPar::TLocalExecutor::WAIT_COMPLETE);
+        localExecutor->ExecRange(
+            [&] (int blockIdx) {
+                const int blockStart = documentBlockParams.FirstId + blockIdx * documentBlockParams.GetBlockSize();
+                const int blockEnd = Min(blockStart + documentBlockParams.GetBlockSize(), documentBlockParams.LastId);
+                for (auto treeIdx : xrange(treeBlockStart, treeBlockEnd)) {
+                    const double* leafValues = forest.GetFirstLeafPtrForTree(treeIdx);
+                    const TIndexType* treeLeafIndices = leafIndices[treeIdx - treeBlockStart].data();
+                    for (auto dim : xrange(approxDimension)) {
+                        for (auto doc : xrange(blockStart, blockEnd)) {
+                            approx[dim][doc] += leafValues[treeLeafIndices[doc] * approxDimension + dim];
+                        }
+                    }
+                }
+            },
+            0,
+            documentBlockParams.GetBlockCount(),
+            NPar::TLocalExecutor::WAIT_COMPLETE);
+    }
+    leafIndices = TVector<TVector<TIndexType>>();
+
+    const double baseLoss = metric->GetFinalError(
+        EvalErrors(approx, target, weights, queriesInfo, metric, localExecutor));
+    const double lossSign = IsMaxOptimal(*metric) ? -1.0 : 1.0;
+
+    const TVector<TVector<TTreeFeatureUsage>> featureUsage = GetFeatureUsageInTrees(forest);
+    TVector<TVector<double>> result(featureUsage.size(), TVector<double>(1, 0.0));
+
+    // features are processed in parallel, documents of each feature - in nested parallel loops
+    localExecutor->ExecRange(
+        [&] (int featureIdx) {
+            const auto& treesWithFeature = featureUsage[featureIdx];
+            if (treesWithFeature.empty()) {
+                return;
+            }
+            TVector<TVector<double>> ablatedApprox = approx;
+            // leaf indices are recalculated for trees that use the feature, one tree at a time
+            for (const auto& treeFeatureUsage : treesWithFeature) {
+                const TVector<double> ablatedLeafValueDeltas = CalcAblatedLeafValueDeltas(forest, treeFeatureUsage);
+                const TVector<TIndexType> treeLeafIndices
+                    = BuildIndicesForBinTree(model, binFeatures, treeFeatureUsage.TreeIdx);
+                localExecutor->ExecRange(
+                    [&] (int blockIdx) {
+                        const int blockStart = documentBlockParams.FirstId + blockIdx * documentBlockParams.GetBlockSize();
+                        const int blockEnd = Min(blockStart + documentBlockParams.GetBlockSize(), documentBlockParams.LastId);
+                        for (auto dim : xrange(approxDimension)) {
+                            for (auto doc : xrange(blockStart, blockEnd)) {
+                                ablatedApprox[dim][doc]
+                                    += ablatedLeafValueDeltas[treeLeafIndices[doc] * approxDimension + dim];
+                            }
+                        }
+                    },
+                    0,
+                    documentBlockParams.GetBlockCount(),
+                    NPar::TLocalExecutor::WAIT_COMPLETE);
+            }
+
+            const double ablatedLoss = metric->GetFinalError(
+                EvalErrors(ablatedApprox, target, weights, queriesInfo, metric, localExecutor));
+            result[featureIdx][0] = lossSign * (ablatedLoss - baseLoss);
+        },
+        0,
+        SafeIntegerCast<int>(featureUsage.size()),
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+
+    return result;
+}
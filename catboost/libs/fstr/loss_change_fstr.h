@@ -0,0 +1,23 @@
+#pragma once
+
+#include <catboost/libs/data_new/data_provider.h>
+#include <catboost/libs/model/model.h>
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/vector.h>
+
+
+/* Loss-based feature importance on dataset: for each feature the increase of model loss_function
+ * when the feature is removed from the model.
+ * Feature is removed by replacing the value of each leaf of each tree that uses the feature
+ * by the average of leaf values over both branches of splits by this feature, weighted by leaf weights
+ * if the model has them.
+ * Only trees that use a feature are reevaluated for it, their leaf indices are calculated one tree at a time.
+ *
+ * returns [externalFeatureIdx][0] in the same format as FeatureImportance
+ */
+TVector<TVector<double>> CalcLossFunctionChange(
+    const TFullModel& model,
+    const NCB::TDataProvider& dataset,
+    NPar::TLocalExecutor* localExecutor);
@@ -1,9 +1,12 @@
 #pragma once
 
 #include "calc_fstr.h"
+#include "loss_change_fstr.h"
 
 #include <catboost/libs/algo/tree_print.h>
 
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
 #include <util/stream/file.h>
 #include <util/system/yassert.h>
 
@@ -118,3 +121,28 @@ inline void CalcAndOutputInteraction(
         OutputRegularInteraction(layout, interaction, *regularFstrPath);
     }
 }
+
+inline void CalcAndOutputLossFunctionChange(
+    const TFullModel& model,
+    const NCB::TDataProvider& dataset,
+    NPar::TLocalExecutor* localExecutor,
+    const TString& regularFstrPath)
+{
+    NCB::TFeaturesLayout layout(model.ObliviousTrees.FloatFeatures, model.ObliviousTrees.CatFeatures);
+
+    const TVector<TVector<double>> lossFunctionChange = CalcLossFunctionChange(model, dataset, localExecutor);
+    TVector<TFeatureEffect> regularEffect;
+    for (auto externalFeatureIdx : xrange(lossFunctionChange.size())) {
+        regularEffect.emplace_back(
+            lossFunctionChange[externalFeatureIdx][0],
+            layout.GetExternalFeatureType(externalFeatureIdx),
+            layout.GetInternalFeatureIdx(externalFeatureIdx));
+    }
+    StableSort(
+        regularEffect.begin(),
+        regularEffect.end(),
+        [](const TFeatureEffect& left, const TFeatureEffect& right) {
+            return left.Score > right.Score;
+        });
+    OutputRegularFstr(layout, regularEffect, regularFstrPath);
+}
@@ -3,6 +3,7 @@
 #include <util/digest/numeric.h>
 #include <util/generic/array_ref.h>
 #include <util/generic/algorithm.h>
+#include <util/system/compiler.h>
 
 namespace NCatboost {
 
@@ -44,6 +45,17 @@ namespace NCatboost {
             return NotFoundIndex;
         }
 
+        // indexes[i] = GetIndex(hashes[i]), first bucket of every hash is prefetched before lookups
+        void GetIndexes(TConstArrayRef<ui64> hashes, TArrayRef<ui32> indexes) const {
+            Y_ASSERT(hashes.size() == indexes.size());
+            for (ui64 hash : hashes) {
+                Y_PREFETCH_READ(&Buckets[hash & HashMask], 3);
+            }
+            for (size_t i = 0; i < hashes.size(); ++i) {
+                indexes[i] = GetIndex(hashes[i]);
+            }
+        }
+
         size_t CountNonEmptyBuckets() const {
             return CountIf(Buckets, [](const TBucket& bucket) { return bucket.Hash != TBucket::InvalidHashValue; });
         }
@@ -0,0 +1,69 @@
+#include "memory_budget.h"
+
+#include <util/generic/xrange.h>
+#include <util/stream/format.h>
+#include <util/stream/str.h>
+#include <util/system/mem_info.h>
+
+
+namespace NCB {
+
+    TMemoryBudget::TMemoryBudget(ui64 limit, bool accountProcessRss)
+        : Limit(limit)
+        , AccountProcessRss(accountProcessRss)
+    {
+        for (auto& usage : Usage) {
+            AtomicSet(usage, 0);
+        }
+    }
+
+    void TMemoryBudget::SetUsage(EMemoryConsumer consumer, ui64 bytes) {
+        AtomicSet(Usage[static_cast<size_t>(consumer)], static_cast<TAtomicBase>(bytes));
+    }
+
+    ui64 TMemoryBudget::GetUsage(EMemoryConsumer consumer) const {
+        return static_cast<ui64>(AtomicGet(Usage[static_cast<size_t>(consumer)]));
+    }
+
+    ui64 TMemoryBudget::GetReportedUsage() const {
+        ui64 result = 0;
+        for (const auto& usage : Usage) {
+            result += static_cast<ui64>(AtomicGet(usage));
+        }
+        return result;
+    }
+
+    ui64 TMemoryBudget::GetTotalUsage() const {
+        const ui64 reportedUsage = GetReportedUsage();
+        return AccountProcessRss ? Max<ui64>(reportedUsage, NMemInfo::GetMemInfo().RSS) : reportedUsage;
+    }
+
+    ui64 TMemoryBudget::GetAvailable() const {
+        const ui64 totalUsage = GetTotalUsage();
+        return totalUsage < Limit ? Limit - totalUsage : 0;
+    }
+
+    int TMemoryBudget::GetParallelism(ui64 memoryPerTask, int maxParallelism) const {
+        if (!memoryPerTask || !IsLimited()) {
+            return Max(maxParallelism, 1);
+        }
+        const ui64 fittingTaskCount = GetAvailable() / memoryPerTask;
+        return static_cast<int>(Max<ui64>(1, Min<ui64>(fittingTaskCount, Max(maxParallelism, 1))));
+    }
+
+    TString TMemoryBudget::GetBreakdown() const {
+        TStringStream out;
+        for (auto consumerIdx : xrange(MemoryConsumerCount)) {
+            const auto consumer = static_cast<EMemoryConsumer>(consumerIdx);
+            out << consumer << ": " << HumanReadableSize(GetUsage(consumer), SF_BYTES) << ", ";
+        }
+        const ui64 reportedUsage = GetReportedUsage();
+        const ui64 totalUsage = GetTotalUsage();
+        out << "Other: " << HumanReadableSize(totalUsage - reportedUsage, SF_BYTES);
+        out << "; Total: " << HumanReadableSize(totalUsage, SF_BYTES);
+        if (IsLimited()) {
+            out << " of " << HumanReadableSize(Limit, SF_BYTES);
+        }
+        return out.Str();
+    }
+}
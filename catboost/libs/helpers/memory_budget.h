@@ -0,0 +1,90 @@
+#pragma once
+
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/generic/ylimits.h>
+#include <util/system/atomic.h>
+#include <util/system/types.h>
+
+#include <array>
+
+
+namespace NCB {
+
+    // major consumers of memory in CPU training
+    enum class EMemoryConsumer {
+        QuantizedData,  // quantized features of learn and test datasets
+        Folds,          // approxes, derivatives, targets and weights of learning and averaging folds
+        OnlineCtrs,     // online CTR values cached in folds
+        ScoreCalcCache, // sampled folds and bucket statistics cache used in tree structure search
+        Approxes        // averaged learn approxes and test approxes used for metrics evaluation
+    };
+
+    constexpr size_t MemoryConsumerCount = static_cast<size_t>(EMemoryConsumer::Approxes) + 1;
+
+
+    /* Central accounting of memory used by CPU training against `used_ram_limit`.
+     *
+     * Subsystems report their current usage with SetUsage after (re)allocations. Subsystems that
+     * can adapt (caches that can be dropped, tasks that can be run with lower parallelism) ask
+     * for GetAvailable before large allocations.
+     * Memory not reported by any subsystem is taken into account through process RSS, so
+     * GetTotalUsage is never less than RSS.
+     *
+     * Thread-safe.
+     */
+    class TMemoryBudget {
+    public:
+        explicit TMemoryBudget(ui64 limit = Max<ui64>(), bool accountProcessRss = true);
+
+        void SetUsage(EMemoryConsumer consumer, ui64 bytes);
+        ui64 GetUsage(EMemoryConsumer consumer) const;
+
+        // sum of usages reported by subsystems
+        ui64 GetReportedUsage() const;
+
+        // max of reported usage and process RSS
+        ui64 GetTotalUsage() const;
+
+        ui64 GetLimit() const {
+            return Limit;
+        }
+
+        bool IsLimited() const {
+            return Limit != Max<ui64>();
+        }
+
+        // 0 if limit is already exceeded
+        ui64 GetAvailable() const;
+
+        bool IsExceeded() const {
+            return GetTotalUsage() > Limit;
+        }
+
+        // number of tasks with `memoryPerTask` usage each that fit into available memory, in [1, maxParallelism]
+        int GetParallelism(ui64 memoryPerTask, int maxParallelism) const;
+
+        // human readable usage per subsystem
+        TString GetBreakdown() const;
+
+    private:
+        ui64 Limit;
+        bool AccountProcessRss;
+        std::array<TAtomic, MemoryConsumerCount> Usage;
+    };
+
+
+    template <class T>
+    inline ui64 GetVectorMemoryUsage(const TVector<T>& data) {
+        return data.capacity() * sizeof(T);
+    }
+
+    template <class T>
+    inline ui64 GetVectorMemoryUsage(const TVector<TVector<T>>& data) {
+        ui64 result = data.capacity() * sizeof(TVector<T>);
+        for (const auto& subData : data) {
+            result += GetVectorMemoryUsage(subData);
+        }
+        return result;
+    }
+}
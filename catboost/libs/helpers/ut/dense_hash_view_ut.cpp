@@ -0,0 +1,43 @@
+#include <catboost/libs/helpers/dense_hash_view.h>
+
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/system/types.h>
+
+#include <library/unittest/registar.h>
+
+
+using namespace NCatboost;
+
+
+Y_UNIT_TEST_SUITE(DenseIndexHashView) {
+    Y_UNIT_TEST(GetIndexes) {
+        const size_t uniqueHashCount = 1000;
+        TVector<TBucket> buckets(TDenseIndexHashBuilder::GetProperBucketsCount(uniqueHashCount));
+        TDenseIndexHashBuilder builder(buckets);
+
+        TReallyFastRng32 rng(0);
+        TVector<ui64> hashes;
+        for (auto i : xrange(uniqueHashCount)) {
+            Y_UNUSED(i);
+            hashes.push_back(rng.GenRand64());
+            builder.AddIndex(hashes.back());
+        }
+        // not present in the view
+        for (auto i : xrange(100)) {
+            Y_UNUSED(i);
+            hashes.push_back(rng.GenRand64());
+        }
+
+        TDenseIndexHashView view(buckets);
+        TVector<ui32> indexes(hashes.size());
+        view.GetIndexes(hashes, indexes);
+        for (auto i : xrange(hashes.size())) {
+            UNIT_ASSERT_VALUES_EQUAL(indexes[i], view.GetIndex(hashes[i]));
+            if (i < uniqueHashCount) {
+                UNIT_ASSERT_VALUES_EQUAL(indexes[i], i);
+            }
+        }
+    }
+}
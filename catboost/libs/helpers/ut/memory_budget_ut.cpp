@@ -0,0 +1,61 @@
+#include <catboost/libs/helpers/memory_budget.h>
+
+#include <util/generic/vector.h>
+
+#include <library/unittest/registar.h>
+
+
+using namespace NCB;
+
+
+Y_UNIT_TEST_SUITE(TMemoryBudget) {
+    Y_UNIT_TEST(TestUsage) {
+        TMemoryBudget budget(1000, /*accountProcessRss*/ false);
+        UNIT_ASSERT(budget.IsLimited());
+        UNIT_ASSERT_VALUES_EQUAL(budget.GetTotalUsage(), 0);
+        UNIT_ASSERT_VALUES_EQUAL(budget.GetAvailable(), 1000);
+
+        budget.SetUsage(EMemoryConsumer::Folds, 300);
+        budget.SetUsage(EMemoryConsumer::OnlineCtrs, 200);
+        UNIT_ASSERT_VALUES_EQUAL(budget.GetUsage(EMemoryConsumer::Folds), 300);
+        UNIT_ASSERT_VALUES_EQUAL(budget.GetUsage(EMemoryConsumer::QuantizedData), 0);
+        UNIT_ASSERT_VALUES_EQUAL(budget.GetReportedUsage(), 500);
+        UNIT_ASSERT_VALUES_EQUAL(budget.GetAvailable(), 500);
+        UNIT_ASSERT(!budget.IsExceeded());
+
+        // usage is replaced, not accumulated
+        budget.SetUsage(EMemoryConsumer::OnlineCtrs, 800);
+        UNIT_ASSERT_VALUES_EQUAL(budget.GetTotalUsage(), 1100);
+        UNIT_ASSERT_VALUES_EQUAL(budget.GetAvailable(), 0);
+        UNIT_ASSERT(budget.IsExceeded());
+    }
+
+    Y_UNIT_TEST(TestParallelism) {
+        TMemoryBudget budget(1000, /*accountProcessRss*/ false);
+        budget.SetUsage(EMemoryConsumer::Folds, 400);
+        UNIT_ASSERT_VALUES_EQUAL(budget.GetParallelism(100, 16), 6);
+        UNIT_ASSERT_VALUES_EQUAL(budget.GetParallelism(100, 4), 4);
+        UNIT_ASSERT_VALUES_EQUAL(budget.GetParallelism(0, 4), 4);
+        // at least one task is always run
+        UNIT_ASSERT_VALUES_EQUAL(budget.GetParallelism(1000, 4), 1);
+
+        TMemoryBudget unlimitedBudget;
+        UNIT_ASSERT(!unlimitedBudget.IsLimited());
+        UNIT_ASSERT(!unlimitedBudget.IsExceeded());
+        UNIT_ASSERT_VALUES_EQUAL(unlimitedBudget.GetParallelism(Max<ui64>(), 8), 8);
+    }
+
+    Y_UNIT_TEST(TestProcessRss) {
+        TMemoryBudget budget;
+        UNIT_ASSERT(budget.GetTotalUsage() > 0);
+        UNIT_ASSERT(budget.GetTotalUsage() >= budget.GetReportedUsage());
+    }
+
+    Y_UNIT_TEST(TestVectorMemoryUsage) {
+        TVector<TVector<double>> data(2, TVector<double>(10));
+        data[0].shrink_to_fit();
+        data[1].shrink_to_fit();
+        data.shrink_to_fit();
+        UNIT_ASSERT_VALUES_EQUAL(GetVectorMemoryUsage(data), 2 * sizeof(TVector<double>) + 20 * sizeof(double));
+    }
+}
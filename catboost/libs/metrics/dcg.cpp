@@ -94,3 +94,15 @@ double CalcNdcg(TConstArrayRef<TSample> samples, ENdcgMetricType type, ui32 topS
     double idcg = CalcIDcg(samples, type, Nothing(), topSize);
     return idcg > 0 ? dcg / idcg : 0;
 }
+
+double CalcNdcgSorted(TConstArrayRef<TSample> samples, TConstArrayRef<ui32> docOrder, ENdcgMetricType type, ui32 topSize) {
+    Y_ASSERT(samples.size() == docOrder.size());
+    TStackVec<double> sortedTargets;
+    sortedTargets.yresize(Min<ui32>(topSize, samples.size()));
+    for (size_t i = 0; i < sortedTargets.size(); ++i) {
+        sortedTargets[i] = samples[docOrder[i]].Target;
+    }
+    double dcg = CalcDcgSorted(sortedTargets, type, Nothing());
+    double idcg = CalcIDcg(samples, type, Nothing(), topSize);
+    return idcg > 0 ? dcg / idcg : 0;
+}
@@ -16,6 +16,13 @@ double CalcNdcg(
     ENdcgMetricType type = ENdcgMetricType::Base,
     ui32 topSize = Max<ui32>());
 
+// same as CalcNdcg, but takes offsets of samples sorted with CompareDocs instead of sorting them
+double CalcNdcgSorted(
+    TConstArrayRef<NMetrics::TSample> samples,
+    TConstArrayRef<ui32> docOrder,
+    ENdcgMetricType type = ENdcgMetricType::Base,
+    ui32 topSize = Max<ui32>());
+
 double CalcDcg(
     TConstArrayRef<NMetrics::TSample> samples,
     ENdcgMetricType type = ENdcgMetricType::Base,
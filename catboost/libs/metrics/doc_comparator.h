@@ -1,5 +1,18 @@
 #pragma once
 
+#include <util/generic/algorithm.h>
+#include <util/generic/array_ref.h>
+#include <util/system/types.h>
+
 inline bool CompareDocs(double approxLeft, float targetLeft, double approxRight, float targetRight) {
     return approxLeft != approxRight ? approxLeft > approxRight : targetLeft < targetRight;
 }
+
+// offsets of query documents sorted with CompareDocs
+template <class TApproxType, class TTargetType>
+inline void CalcQueryDocOrder(const TApproxType* approxes, const TTargetType* targets, TArrayRef<ui32> docOrder) {
+    Iota(docOrder.begin(), docOrder.end(), static_cast<ui32>(0));
+    Sort(docOrder.begin(), docOrder.end(), [&](ui32 left, ui32 right) -> bool {
+        return CompareDocs(approxes[left], targets[left], approxes[right], targets[right]);
+    });
+}
@@ -16,9 +16,11 @@
 #include <catboost/libs/options/enum_helpers.h>
 #include <catboost/libs/options/loss_description.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/hash.h>
 #include <util/generic/maybe.h>
 #include <util/generic/string.h>
+#include <util/generic/xrange.h>
 #include <util/generic/ymath.h>
 #include <util/string/builder.h>
 #include <util/string/cast.h>
@@ -94,6 +96,23 @@ static inline TMetricParam<double> MakeBorderParam(double border) {
     return {"border", border, border != GetDefaultClassificationBorder()};
 }
 
+TMetricHolder TMetric::EvalWithSharedData(
+    const TVector<TVector<double>>& approx,
+    TConstArrayRef<float> target,
+    TConstArrayRef<float> weight,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    int begin,
+    int end,
+    const TSharedMetricData& /*sharedData*/,
+    NPar::TLocalExecutor& executor
+) const {
+    return Eval(approx, target, weight, queriesInfo, begin, end, executor);
+}
+
+bool TMetric::NeedQueryDocOrder() const {
+    return false;
+}
+
 EErrorType TMetric::GetErrorType() const {
     return EErrorType::PerObjectError;
 }
@@ -1222,6 +1241,18 @@ namespace {
             int queryStartIndex,
             int queryEndIndex
         ) const;
+        TMetricHolder EvalSingleThreadWithSharedData(
+            const TVector<TVector<double>>& approx,
+            TConstArrayRef<float> target,
+            TConstArrayRef<float> weight,
+            TConstArrayRef<TQueryInfo> queriesInfo,
+            int queryStartIndex,
+            int queryEndIndex,
+            const TSharedMetricData& sharedData
+        ) const;
+        bool NeedQueryDocOrder() const override {
+            return true;
+        }
         EErrorType GetErrorType() const override;
         double GetFinalError(const TMetricHolder& error) const override;
         TString GetDescription() const override;
@@ -1264,6 +1295,32 @@ TMetricHolder TPFoundMetric::EvalSingleThread(
     return calcer.GetMetric();
 }
 
+TMetricHolder TPFoundMetric::EvalSingleThreadWithSharedData(
+    const TVector<TVector<double>>& approx,
+    TConstArrayRef<float> target,
+    TConstArrayRef<float> weight,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    int queryStartIndex,
+    int queryEndIndex,
+    const TSharedMetricData& sharedData
+) const {
+    if (sharedData.QueryDocOrder.empty()) {
+        return EvalSingleThread(approx, target, weight, queriesInfo, queryStartIndex, queryEndIndex);
+    }
+    TPFoundCalcer calcer(TopSize, Decay);
+    for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
+        int queryBegin = queriesInfo[queryIndex].Begin;
+        int queryEnd = queriesInfo[queryIndex].End;
+        const ui32* subgroupIdData = nullptr;
+        const float queryWeight = UseWeights ? queriesInfo[queryIndex].Weight : 1.0;
+        if (!queriesInfo[queryIndex].SubgroupId.empty()) {
+            subgroupIdData = queriesInfo[queryIndex].SubgroupId.data();
+        }
+        calcer.AddSortedQuery(target.data() + queryBegin, queryWeight, subgroupIdData, sharedData.QueryDocOrder.data() + queryBegin, queryEnd - queryBegin);
+    }
+    return calcer.GetMetric();
+}
+
 EErrorType TPFoundMetric::GetErrorType() const {
     return EErrorType::QuerywiseError;
 }
@@ -1295,6 +1352,18 @@ namespace {
                 int queryStartIndex,
                 int queryEndIndex
         ) const;
+        TMetricHolder EvalSingleThreadWithSharedData(
+                const TVector<TVector<double>>& approx,
+                TConstArrayRef<float> target,
+                TConstArrayRef<float> weight,
+                TConstArrayRef<TQueryInfo> queriesInfo,
+                int queryStartIndex,
+                int queryEndIndex,
+                const TSharedMetricData& sharedData
+        ) const;
+        bool NeedQueryDocOrder() const override {
+            return true;
+        }
         EErrorType GetErrorType() const override;
         double GetFinalError(const TMetricHolder& error) const override;
         TString GetDescription() const override;
@@ -1340,6 +1409,36 @@ TMetricHolder TNdcgMetric::EvalSingleThread(
     return error;
 }
 
+TMetricHolder TNdcgMetric::EvalSingleThreadWithSharedData(
+    const TVector<TVector<double>>& approx,
+    TConstArrayRef<float> target,
+    TConstArrayRef<float> weight,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    int queryStartIndex,
+    int queryEndIndex,
+    const TSharedMetricData& sharedData
+) const {
+    if (sharedData.QueryDocOrder.empty()) {
+        return EvalSingleThread(approx, target, weight, queriesInfo, queryStartIndex, queryEndIndex);
+    }
+    TMetricHolder error(2);
+    TVector<NMetrics::TSample> samples;
+    for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
+        const auto queryBegin = queriesInfo[queryIndex].Begin;
+        const auto queryEnd = queriesInfo[queryIndex].End;
+        const auto querySize = queryEnd - queryBegin;
+        const float queryWeight = UseWeights ? queriesInfo[queryIndex].Weight : 1.f;
+        NMetrics::TSample::FromVectors(
+            MakeArrayRef(target.data() + queryBegin, querySize),
+            MakeArrayRef(approx.front().data() + queryBegin, querySize),
+            &samples);
+        const auto queryDocOrder = MakeArrayRef(sharedData.QueryDocOrder.data() + queryBegin, querySize);
+        error.Stats[0] += queryWeight * CalcNdcgSorted(samples, queryDocOrder, MetricType, TopSize);
+        error.Stats[1] += queryWeight;
+    }
+    return error;
+}
+
 TString TNdcgMetric::GetDescription() const {
     const TMetricParam<int> topSize("top", TopSize, TopSize != -1);
     const TMetricParam<ENdcgMetricType> type("type", MetricType, true);
@@ -2666,6 +2765,18 @@ namespace {
                 int queryStartIndex,
                 int queryEndIndex
         ) const;
+        TMetricHolder EvalSingleThreadWithSharedData(
+                const TVector<TVector<double>>& approx,
+                TConstArrayRef<float> target,
+                TConstArrayRef<float> weight,
+                TConstArrayRef<TQueryInfo> queriesInfo,
+                int queryStartIndex,
+                int queryEndIndex,
+                const TSharedMetricData& sharedData
+        ) const;
+        bool NeedQueryDocOrder() const override {
+            return true;
+        }
         EErrorType GetErrorType() const override;
         double GetFinalError(const TMetricHolder& error) const override;
         TString GetDescription() const override;
@@ -2708,6 +2819,33 @@ TMetricHolder TPrecisionAtKMetric::EvalSingleThread(
     return error;
 }
 
+TMetricHolder TPrecisionAtKMetric::EvalSingleThreadWithSharedData(
+        const TVector<TVector<double>>& approx,
+        TConstArrayRef<float> target,
+        TConstArrayRef<float> weight,
+        TConstArrayRef<TQueryInfo> queriesInfo,
+        int queryStartIndex,
+        int queryEndIndex,
+        const TSharedMetricData& sharedData
+) const {
+    if (sharedData.QueryDocOrder.empty()) {
+        return EvalSingleThread(approx, target, weight, queriesInfo, queryStartIndex, queryEndIndex);
+    }
+    TMetricHolder error(2);
+    for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
+        int queryBegin = queriesInfo[queryIndex].Begin;
+        int queryEnd = queriesInfo[queryIndex].End;
+
+        error.Stats[0] += CalcPrecisionAtKSorted(
+            MakeArrayRef(sharedData.QueryDocOrder.data() + queryBegin, queryEnd - queryBegin),
+            MakeArrayRef(target.data() + queryBegin, queryEnd - queryBegin),
+            TopSize,
+            Border);
+        error.Stats[1]++;
+    }
+    return error;
+}
+
 EErrorType TPrecisionAtKMetric::GetErrorType() const {
     return EErrorType::QuerywiseError;
 }
@@ -2738,6 +2876,18 @@ namespace {
                 int queryStartIndex,
                 int queryEndIndex
         ) const;
+        TMetricHolder EvalSingleThreadWithSharedData(
+                const TVector<TVector<double>>& approx,
+                TConstArrayRef<float> target,
+                TConstArrayRef<float> weight,
+                TConstArrayRef<TQueryInfo> queriesInfo,
+                int queryStartIndex,
+                int queryEndIndex,
+                const TSharedMetricData& sharedData
+        ) const;
+        bool NeedQueryDocOrder() const override {
+            return true;
+        }
         EErrorType GetErrorType() const override;
         double GetFinalError(const TMetricHolder& error) const override;
         TString GetDescription() const override;
@@ -2781,6 +2931,33 @@ TMetricHolder TRecallAtKMetric::EvalSingleThread(
     return error;
 }
 
+TMetricHolder TRecallAtKMetric::EvalSingleThreadWithSharedData(
+        const TVector<TVector<double>>& approx,
+        TConstArrayRef<float> target,
+        TConstArrayRef<float> weight,
+        TConstArrayRef<TQueryInfo> queriesInfo,
+        int queryStartIndex,
+        int queryEndIndex,
+        const TSharedMetricData& sharedData
+) const {
+    if (sharedData.QueryDocOrder.empty()) {
+        return EvalSingleThread(approx, target, weight, queriesInfo, queryStartIndex, queryEndIndex);
+    }
+    TMetricHolder error(2);
+    for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
+        int queryBegin = queriesInfo[queryIndex].Begin;
+        int queryEnd = queriesInfo[queryIndex].End;
+
+        error.Stats[0] += CalcRecallAtKSorted(
+            MakeArrayRef(sharedData.QueryDocOrder.data() + queryBegin, queryEnd - queryBegin),
+            MakeArrayRef(target.data() + queryBegin, queryEnd - queryBegin),
+            TopSize,
+            Border);
+        error.Stats[1]++;
+    }
+    return error;
+}
+
 EErrorType TRecallAtKMetric::GetErrorType() const {
     return EErrorType::QuerywiseError;
 }
@@ -2811,6 +2988,18 @@ namespace {
                 int queryStartIndex,
                 int queryEndIndex
         ) const;
+        TMetricHolder EvalSingleThreadWithSharedData(
+                const TVector<TVector<double>>& approx,
+                TConstArrayRef<float> target,
+                TConstArrayRef<float> weight,
+                TConstArrayRef<TQueryInfo> queriesInfo,
+                int queryStartIndex,
+                int queryEndIndex,
+                const TSharedMetricData& sharedData
+        ) const;
+        bool NeedQueryDocOrder() const override {
+            return true;
+        }
         EErrorType GetErrorType() const override;
         double GetFinalError(const TMetricHolder& error) const override;
         TString GetDescription() const override;
@@ -2855,6 +3044,33 @@ TMetricHolder TMAPKMetric::EvalSingleThread(
     return error;
 }
 
+TMetricHolder TMAPKMetric::EvalSingleThreadWithSharedData(
+        const TVector<TVector<double>>& approx,
+        TConstArrayRef<float> target,
+        TConstArrayRef<float> weight,
+        TConstArrayRef<TQueryInfo> queriesInfo,
+        int queryStartIndex,
+        int queryEndIndex,
+        const TSharedMetricData& sharedData
+) const {
+    if (sharedData.QueryDocOrder.empty()) {
+        return EvalSingleThread(approx, target, weight, queriesInfo, queryStartIndex, queryEndIndex);
+    }
+    TMetricHolder error(2);
+    for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
+        int queryBegin = queriesInfo[queryIndex].Begin;
+        int queryEnd = queriesInfo[queryIndex].End;
+
+        error.Stats[0] += CalcAveragePrecisionKSorted(
+            MakeArrayRef(sharedData.QueryDocOrder.data() + queryBegin, queryEnd - queryBegin),
+            MakeArrayRef(target.data() + queryBegin, queryEnd - queryBegin),
+            TopSize,
+            Border);
+        error.Stats[1]++;
+    }
+    return error;
+}
+
 TString TMAPKMetric::GetDescription() const {
     const TMetricParam<int> topSize("top", TopSize, TopSize != -1);
     return BuildDescription(ELossFunction::MAP, UseWeights, topSize, "%.3g", MakeBorderParam(Border));
@@ -2888,6 +3104,21 @@ namespace {
             int end,
             NPar::TLocalExecutor& executor
         ) const override;
+        TMetricHolder EvalWithSharedData(
+            const TVector<TVector<double>>& approx,
+            TConstArrayRef<float> target,
+            TConstArrayRef<float> weight,
+            TConstArrayRef<TQueryInfo> queriesInfo,
+            int begin,
+            int end,
+            const TSharedMetricData& /*sharedData*/,
+            NPar::TLocalExecutor& executor
+        ) const override {
+            return Eval(approx, target, weight, queriesInfo, begin, end, executor);
+        }
+        bool NeedQueryDocOrder() const override {
+            return false;
+        }
         TString GetDescription() const override;
         void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
         EErrorType GetErrorType() const override;
@@ -3703,6 +3934,26 @@ TVector<bool> GetSkipMetricOnTest(bool testHasTarget, const TVector<const IMetri
 }
 
 
+static TMetricHolder EvalErrorsWithSharedData(
+    const TVector<TVector<double>>& approx,
+    TConstArrayRef<float> target,
+    TConstArrayRef<float> weight,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    const IMetric& error,
+    const TSharedMetricData& sharedData,
+    NPar::TLocalExecutor* localExecutor
+) {
+    if (error.GetErrorType() == EErrorType::PerObjectError) {
+        int begin = 0, end = target.size();
+        Y_VERIFY(approx[0].ysize() == end - begin);
+        return error.EvalWithSharedData(approx, target, weight, queriesInfo, begin, end, sharedData, *localExecutor);
+    } else {
+        Y_VERIFY(error.GetErrorType() == EErrorType::QuerywiseError || error.GetErrorType() == EErrorType::PairwiseError);
+        int queryStartIndex = 0, queryEndIndex = queriesInfo.size();
+        return error.EvalWithSharedData(approx, target, weight, queriesInfo, queryStartIndex, queryEndIndex, sharedData, *localExecutor);
+    }
+}
+
 TMetricHolder EvalErrors(
         const TVector<TVector<double>>& approx,
         TConstArrayRef<float> target,
@@ -3711,15 +3962,60 @@ TMetricHolder EvalErrors(
         const THolder<IMetric>& error,
         NPar::TLocalExecutor* localExecutor
 ) {
-    if (error->GetErrorType() == EErrorType::PerObjectError) {
-        int begin = 0, end = target.size();
-        Y_VERIFY(approx[0].ysize() == end - begin);
-        return error->Eval(approx, target, weight, queriesInfo, begin, end, *localExecutor);
-    } else {
-        Y_VERIFY(error->GetErrorType() == EErrorType::QuerywiseError || error->GetErrorType() == EErrorType::PairwiseError);
-        int queryStartIndex = 0, queryEndIndex = queriesInfo.size();
-        return error->Eval(approx, target, weight, queriesInfo, queryStartIndex, queryEndIndex, *localExecutor);
+    return EvalErrorsWithSharedData(approx, target, weight, queriesInfo, *error, TSharedMetricData(), localExecutor);
+}
+
+static TVector<ui32> CalcSharedQueryDocOrder(
+    TConstArrayRef<double> approx,
+    TConstArrayRef<float> target,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    NPar::TLocalExecutor* localExecutor
+) {
+    TVector<ui32> queryDocOrder;
+    queryDocOrder.yresize(approx.size());
+    NPar::ParallelFor(*localExecutor, 0, queriesInfo.size(), [&](int queryIndex) {
+        const auto queryBegin = queriesInfo[queryIndex].Begin;
+        const auto queryEnd = queriesInfo[queryIndex].End;
+        CalcQueryDocOrder(
+            approx.data() + queryBegin,
+            target.data() + queryBegin,
+            MakeArrayRef(queryDocOrder.data() + queryBegin, queryEnd - queryBegin));
+    });
+    return queryDocOrder;
+}
+
+TVector<TMetricHolder> EvalErrors(
+    const TVector<TVector<double>>& approx,
+    TConstArrayRef<float> target,
+    TConstArrayRef<float> weight,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    TConstArrayRef<const IMetric*> errors,
+    NPar::TLocalExecutor* localExecutor
+) {
+    TSharedMetricData sharedData;
+    const auto queryDocOrderUserCount = CountIf(errors, [](const IMetric* error) {
+        return error->NeedQueryDocOrder();
+    });
+    // a single metric sorts only top documents, which is cheaper than sorting all of them
+    if (queryDocOrderUserCount > 1 && !target.empty()) {
+        sharedData.QueryDocOrder = CalcSharedQueryDocOrder(approx[0], target, queriesInfo, localExecutor);
+    }
+
+    TVector<TMetricHolder> results(errors.size());
+    TVector<ui32> concurrentErrorIndices;
+    for (auto errorIdx : xrange(errors.size())) {
+        // custom metrics may call back into user code, which can be not thread-safe
+        if (dynamic_cast<const TMetric*>(errors[errorIdx])) {
+            concurrentErrorIndices.push_back(errorIdx);
+        } else {
+            results[errorIdx] = EvalErrorsWithSharedData(approx, target, weight, queriesInfo, *errors[errorIdx], sharedData, localExecutor);
+        }
     }
+    NPar::ParallelFor(*localExecutor, 0, concurrentErrorIndices.size(), [&](int i) {
+        const auto errorIdx = concurrentErrorIndices[i];
+        results[errorIdx] = EvalErrorsWithSharedData(approx, target, weight, queriesInfo, *errors[errorIdx], sharedData, localExecutor);
+    });
+    return results;
 }
 
 
@@ -94,6 +94,15 @@ struct TCustomMetricDescriptor {
     TGetFinalErrorFuncPtr GetFinalErrorFunc = nullptr;
 };
 
+/* Data derived from approx and target that is needed by several metrics.
+ * It is computed once by EvalErrors for all metrics being evaluated, empty fields are not computed.
+ */
+struct TSharedMetricData {
+    // for every query offsets of its objects (relative to query begin) in the order of CompareDocs
+    // on approx[0] and target, stored in [query.Begin, query.End)
+    TVector<ui32> QueryDocOrder;
+};
+
 struct IMetric {
     virtual TMetricHolder Eval(
         const TVector<TVector<double>>& approx,
@@ -104,6 +113,18 @@ struct IMetric {
         int end,
         NPar::TLocalExecutor& executor
     ) const = 0;
+    // same as Eval, but may take data from sharedData instead of computing it
+    virtual TMetricHolder EvalWithSharedData(
+        const TVector<TVector<double>>& approx,
+        TConstArrayRef<float> target,
+        TConstArrayRef<float> weight,
+        TConstArrayRef<TQueryInfo> queriesInfo,
+        int begin,
+        int end,
+        const TSharedMetricData& sharedData,
+        NPar::TLocalExecutor& executor
+    ) const = 0;
+    virtual bool NeedQueryDocOrder() const = 0;
     virtual TString GetDescription() const = 0;
     virtual void GetBestValue(EMetricBestValue* valueType, float* bestValue) const = 0;
     virtual EErrorType GetErrorType() const = 0;
@@ -120,6 +141,17 @@ public:
 };
 
 struct TMetric: public IMetric {
+    virtual TMetricHolder EvalWithSharedData(
+        const TVector<TVector<double>>& approx,
+        TConstArrayRef<float> target,
+        TConstArrayRef<float> weight,
+        TConstArrayRef<TQueryInfo> queriesInfo,
+        int begin,
+        int end,
+        const TSharedMetricData& sharedData,
+        NPar::TLocalExecutor& executor
+    ) const override;
+    virtual bool NeedQueryDocOrder() const override;
     virtual EErrorType GetErrorType() const override;
     virtual double GetFinalError(const TMetricHolder& error) const override;
     virtual TVector<TString> GetStatDescriptions() const override;
@@ -140,6 +172,19 @@ struct TAdditiveMetric: public TMetric {
         int begin,
         int end,
         NPar::TLocalExecutor& executor
+    ) const final {
+        return EvalWithSharedData(approx, target, weight, queriesInfo, begin, end, TSharedMetricData(), executor);
+    }
+
+    TMetricHolder EvalWithSharedData(
+        const TVector<TVector<double>>& approx,
+        TConstArrayRef<float> target,
+        TConstArrayRef<float> weight,
+        TConstArrayRef<TQueryInfo> queriesInfo,
+        int begin,
+        int end,
+        const TSharedMetricData& sharedData,
+        NPar::TLocalExecutor& executor
     ) const final {
         NPar::TLocalExecutor::TExecRangeParams blockParams(begin, end);
 
@@ -158,9 +203,9 @@ struct TAdditiveMetric: public TMetric {
             const int to = Min<int>(begin + (blockId + 1) * blockSize, end);
             Y_ASSERT(from < to);
             if (UseWeights.IsIgnored() || UseWeights)
-                results[blockId] = static_cast<const TImpl*>(this)->EvalSingleThread(approx, target, weight, queriesInfo, from, to);
+                results[blockId] = static_cast<const TImpl*>(this)->EvalSingleThreadWithSharedData(approx, target, weight, queriesInfo, from, to, sharedData);
             else
-                results[blockId] = static_cast<const TImpl*>(this)->EvalSingleThread(approx, target, {}, queriesInfo, from, to);
+                results[blockId] = static_cast<const TImpl*>(this)->EvalSingleThreadWithSharedData(approx, target, {}, queriesInfo, from, to, sharedData);
         });
 
         TMetricHolder result;
@@ -170,6 +215,19 @@ struct TAdditiveMetric: public TMetric {
         return result;
     }
 
+    // metrics that use sharedData hide this with their own implementation
+    TMetricHolder EvalSingleThreadWithSharedData(
+        const TVector<TVector<double>>& approx,
+        TConstArrayRef<float> target,
+        TConstArrayRef<float> weight,
+        TConstArrayRef<TQueryInfo> queriesInfo,
+        int begin,
+        int end,
+        const TSharedMetricData& /*sharedData*/
+    ) const {
+        return static_cast<const TImpl*>(this)->EvalSingleThread(approx, target, weight, queriesInfo, begin, end);
+    }
+
     bool IsAdditiveMetric() const final {
         return true;
     }
@@ -323,6 +381,18 @@ TMetricHolder EvalErrors(
     NPar::TLocalExecutor* localExecutor
 );
 
+/* Evaluates several metrics on the same approx concurrently. Data needed by more than one metric
+ * (see TSharedMetricData) is computed once and shared between them.
+ */
+TVector<TMetricHolder> EvalErrors(
+    const TVector<TVector<double>>& approx,
+    TConstArrayRef<float> target,
+    TConstArrayRef<float> weight,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    TConstArrayRef<const IMetric*> errors,
+    NPar::TLocalExecutor* localExecutor
+);
+
 inline bool IsMaxOptimal(const IMetric& metric) {
     EMetricBestValue bestValueType;
     float bestPossibleValue;
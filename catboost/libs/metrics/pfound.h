@@ -21,18 +21,21 @@ public:
 
     template <class TRelevsType, class TApproxType>
     void AddQuery(const TRelevsType* relevs, const TApproxType* approxes, float queryWeight, const ui32* subgroupData, ui32 querySize) {
-        TVector<int> qurls(querySize);
-        std::iota(qurls.begin(), qurls.end(), 0);
-        Sort(qurls.begin(), qurls.end(), [&](int left, int right) -> bool {
-            return CompareDocs(approxes[left], relevs[left], approxes[right], relevs[right]);
-        });
+        TVector<ui32> qurls;
+        qurls.yresize(querySize);
+        CalcQueryDocOrder(approxes, relevs, MakeArrayRef(qurls));
+        AddSortedQuery(relevs, queryWeight, subgroupData, qurls.data(), querySize);
+    }
 
+    // docOrder are offsets of query documents sorted with CompareDocs
+    template <class TRelevsType>
+    void AddSortedQuery(const TRelevsType* relevs, float queryWeight, const ui32* subgroupData, const ui32* docOrder, ui32 querySize) {
         double pLook = 1, pFound = 0;
         const ui32 depth = Min<ui32>(querySize, Depth);
 
         TSet<ui32> subgroupIds;
         for (ui32 position = 0; position < depth; position++) {
-            const int docId = qurls[position];
+            const ui32 docId = docOrder[position];
             if (subgroupData != nullptr) {
                 const ui32 subgroupId = subgroupData[docId];
                 if (subgroupIds.contains(subgroupId)) {
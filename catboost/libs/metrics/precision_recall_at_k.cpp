@@ -81,3 +81,39 @@ double CalcAveragePrecisionK(TConstArrayRef<double> approx, TConstArrayRef<float
     }
     return hits > 0 ? score / Min<double>(hits, static_cast<size_t>(size)) : 0;
 }
+
+static int CalcRelevantSorted(TConstArrayRef<ui32> docOrder, TConstArrayRef<float> target, double border, size_t size) {
+    int relevant = 0;
+    for (size_t i = 0; i < size; i++) {
+        if (target[docOrder[i]] > border)
+            relevant++;
+    }
+    return relevant;
+}
+
+double CalcPrecisionAtKSorted(TConstArrayRef<ui32> docOrder, TConstArrayRef<float> target, int top, double border) {
+    size_t size = CalcSampleSize(target.size(), top);
+    return CalcRelevantSorted(docOrder, target, border, size) / static_cast<double>(size);
+}
+
+double CalcRecallAtKSorted(TConstArrayRef<ui32> docOrder, TConstArrayRef<float> target, int top, double border) {
+    size_t size = CalcSampleSize(target.size(), top);
+    int relevant = CalcRelevantSorted(docOrder, target, border, target.size());
+    return relevant != 0 ? CalcRelevantSorted(docOrder, target, border, size) / static_cast<double>(relevant) : 1;
+}
+
+double CalcAveragePrecisionKSorted(TConstArrayRef<ui32> docOrder, TConstArrayRef<float> target, int top, double border) {
+    double score = 0;
+    double hits = 0;
+
+    size_t size = CalcSampleSize(target.size(), top);
+    for (size_t index = 0; index < docOrder.size(); ++index) {
+        if (target[docOrder[index]] > border) {
+            hits += 1;
+            if (index < size) {
+                score += hits / (index + 1);
+            }
+        }
+    }
+    return hits > 0 ? score / Min<double>(hits, static_cast<size_t>(size)) : 0;
+}
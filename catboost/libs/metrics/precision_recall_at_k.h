@@ -1,9 +1,18 @@
 #pragma once
 
 #include <util/generic/fwd.h>
+#include <util/system/types.h>
 
 double CalcPrecisionAtK(TConstArrayRef<double> approx, TConstArrayRef<float> target, int top, double border);
 
 double CalcRecallAtK(TConstArrayRef<double> approx, TConstArrayRef<float> target, int top, double border);
 
 double CalcAveragePrecisionK(TConstArrayRef<double> approx, TConstArrayRef<float> target, int top, double border);
+
+// same as above, but take offsets of objects sorted with CompareDocs instead of approx
+
+double CalcPrecisionAtKSorted(TConstArrayRef<ui32> docOrder, TConstArrayRef<float> target, int top, double border);
+
+double CalcRecallAtKSorted(TConstArrayRef<ui32> docOrder, TConstArrayRef<float> target, int top, double border);
+
+double CalcAveragePrecisionKSorted(TConstArrayRef<ui32> docOrder, TConstArrayRef<float> target, int top, double border);
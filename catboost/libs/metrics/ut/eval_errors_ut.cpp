@@ -0,0 +1,51 @@
+#include <library/unittest/registar.h>
+#include <catboost/libs/metrics/metric.h>
+#include <catboost/libs/metrics/metric_holder.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+Y_UNIT_TEST_SUITE(EvalErrorsTest) {
+    Y_UNIT_TEST(SharedQueryDocOrderGivesSameResults) {
+        TFastRng64 rng(0);
+        TVector<TVector<double>> approx(1);
+        TVector<float> target;
+        TVector<float> weight;
+        TVector<TQueryInfo> queries;
+        for (ui32 queryIdx = 0; queryIdx < 100; ++queryIdx) {
+            const ui32 begin = target.size();
+            const ui32 querySize = 1 + rng.Uniform(20);
+            for (ui32 i = 0; i < querySize; ++i) {
+                // few distinct values to have ties in approx and target
+                approx[0].push_back(rng.Uniform(5) * 0.5);
+                target.push_back(rng.Uniform(3) * 0.5f);
+                weight.push_back(1.0f);
+            }
+            queries.emplace_back(begin, begin + querySize);
+            queries.back().Weight = 1.0f + rng.Uniform(3);
+        }
+
+        TVector<THolder<IMetric>> metrics;
+        metrics.push_back(MakePFoundMetric(5));
+        metrics.push_back(MakeNdcgMetric(3, ENdcgMetricType::Exp));
+        metrics.push_back(MakeNdcgMetric());
+        metrics.push_back(MakePrecisionAtKMetric(3, 0.4));
+        metrics.push_back(MakeRecallAtKMetric(3, 0.4));
+        metrics.push_back(MakeMAPKMetric(4, 0.4));
+        metrics.push_back(MakeBinClassAucMetric(0.4));
+        metrics.push_back(MakeRMSEMetric());
+
+        NPar::TLocalExecutor executor;
+        executor.RunAdditionalThreads(3);
+        const auto results = EvalErrors(approx, target, weight, queries, GetConstPointers(metrics), &executor);
+        UNIT_ASSERT_VALUES_EQUAL(results.size(), metrics.size());
+        for (auto i : xrange(metrics.size())) {
+            const auto expected = EvalErrors(approx, target, weight, queries, metrics[i], &executor);
+            UNIT_ASSERT_DOUBLES_EQUAL_C(
+                metrics[i]->GetFinalError(results[i]),
+                metrics[i]->GetFinalError(expected),
+                1e-9,
+                metrics[i]->GetDescription());
+        }
+    }
+}
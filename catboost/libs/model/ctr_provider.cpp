@@ -3,8 +3,10 @@
 
 #include <catboost/libs/helpers/exception.h>
 
+#include <util/generic/hash_set.h>
 
-TIntrusivePtr<ICtrProvider> MergeCtrProvidersData(const TVector<TIntrusivePtr<ICtrProvider>>& providers, ECtrTableMergePolicy mergePolicy) {
+
+static TVector<const TStaticCtrProvider*> GetNonEmptyStaticProviders(const TVector<TIntrusivePtr<ICtrProvider>>& providers) {
     TVector<const TStaticCtrProvider*> nonEmptyStaticProviders;
     for (const auto& provider : providers) {
         if (provider) {
@@ -13,11 +15,62 @@ TIntrusivePtr<ICtrProvider> MergeCtrProvidersData(const TVector<TIntrusivePtr<IC
             nonEmptyStaticProviders.emplace_back(staticCtr);
         }
     }
+    return nonEmptyStaticProviders;
+}
+
+TIntrusivePtr<ICtrProvider> MergeCtrProvidersData(
+    const TVector<TIntrusivePtr<ICtrProvider>>& providers,
+    ECtrTableMergePolicy mergePolicy,
+    int threadCount
+) {
+    const TVector<const TStaticCtrProvider*> nonEmptyStaticProviders = GetNonEmptyStaticProviders(providers);
     if (nonEmptyStaticProviders.empty()) {
         return TIntrusivePtr<ICtrProvider>();
     }
     if (nonEmptyStaticProviders.size() == 1) {
         return nonEmptyStaticProviders.back()->Clone();
     }
-    return MergeStaticCtrProvidersData(nonEmptyStaticProviders, mergePolicy);
+    return MergeStaticCtrProvidersData(nonEmptyStaticProviders, mergePolicy, threadCount);
+}
+
+TIntrusivePtr<ICtrProvider> MergeCtrProvidersDataForSerialization(
+    const TVector<TIntrusivePtr<ICtrProvider>>& providers,
+    ECtrTableMergePolicy mergePolicy,
+    int threadCount
+) {
+    const TVector<const TStaticCtrProvider*> nonEmptyStaticProviders = GetNonEmptyStaticProviders(providers);
+    if (nonEmptyStaticProviders.empty()) {
+        return TIntrusivePtr<ICtrProvider>();
+    }
+    TVector<TModelCtrBase> ctrBases;
+    THashSet<TModelCtrBase> uniqueCtrBases;
+    size_t ctrTableCount = 0;
+    for (const auto* provider : nonEmptyStaticProviders) {
+        for (const auto& [ctrBase, ctrValueTable] : provider->CtrData.LearnCtrs) {
+            if (uniqueCtrBases.insert(ctrBase).second) {
+                ctrBases.push_back(ctrBase);
+            }
+            ++ctrTableCount;
+        }
+    }
+    CB_ENSURE(
+        mergePolicy != ECtrTableMergePolicy::FailIfCtrsIntersects || ctrTableCount == ctrBases.size(),
+        "FailIfCtrsIntersects policy forbids model ctr tables intersection"
+    );
+    return new TStaticCtrOnFlightSerializationProvider(
+        std::move(ctrBases),
+        [providers, nonEmptyStaticProviders, mergePolicy, threadCount] (
+            const TVector<TModelCtrBase>& /*ctrBases*/,
+            TCtrDataStreamWriter* streamWriter
+        ) {
+            MergeStaticCtrProvidersData(
+                nonEmptyStaticProviders,
+                mergePolicy,
+                threadCount,
+                [streamWriter](const TCtrValueTable& table) {
+                    streamWriter->SaveOneCtr(table);
+                }
+            );
+        }
+    );
 }
@@ -129,4 +129,14 @@ enum class ECtrTableMergePolicy {
 
 TIntrusivePtr<ICtrProvider> MergeCtrProvidersData(
     const TVector<TIntrusivePtr<ICtrProvider>>& providers,
-    ECtrTableMergePolicy mergePolicy);
+    ECtrTableMergePolicy mergePolicy,
+    int threadCount = 1);
+
+/**
+ * Same as MergeCtrProvidersData, but tables are merged only when the returned provider is saved, one group at a time.
+ * The returned provider can only be saved and keeps merged providers alive.
+ */
+TIntrusivePtr<ICtrProvider> MergeCtrProvidersDataForSerialization(
+    const TVector<TIntrusivePtr<ICtrProvider>>& providers,
+    ECtrTableMergePolicy mergePolicy,
+    int threadCount = 1);
@@ -1,6 +1,7 @@
 #include "formula_evaluator.h"
 
 #include <util/generic/algorithm.h>
+#include <util/generic/map.h>
 #include <util/stream/format.h>
 #include <util/system/compiler.h>
 
@@ -33,6 +34,129 @@ void TFeatureCachedTreeEvaluator::Calc(size_t treeStart, size_t treeEnd, TArrayR
     }
 }
 
+static bool IsNanAsTrue(const TFloatFeature& floatFeature) {
+    return floatFeature.HasNans && floatFeature.NanValueTreatment == NCatBoostFbs::ENanValueTreatment_AsTrue;
+}
+
+TMultiModelEvaluator::TMultiModelEvaluator(TConstArrayRef<const TFullModel*> models) {
+    CB_ENSURE(!models.empty(), "Empty model list");
+    TMap<int, TFloatFeature> unionFeatures;
+    for (const auto* model : models) {
+        CB_ENSURE(
+            !model->HasCategoricalFeatures(),
+            "Shared binarization is supported only for models without categorical features"
+        );
+        for (const auto& floatFeature : model->ObliviousTrees.FloatFeatures) {
+            if (!floatFeature.UsedInModel()) {
+                continue;
+            }
+            auto [iter, inserted] = unionFeatures.try_emplace(floatFeature.FeatureIndex, floatFeature);
+            if (inserted) {
+                continue;
+            }
+            auto& unionFeature = iter->second;
+            CB_ENSURE(
+                unionFeature.FlatFeatureIndex == floatFeature.FlatFeatureIndex,
+                "Flat feature index mismatch for float feature " << floatFeature.FeatureIndex << ": "
+                << unionFeature.FlatFeatureIndex << " != " << floatFeature.FlatFeatureIndex
+            );
+            // AsIs and AsFalse both put nans to the lowest bin, only AsTrue differs
+            CB_ENSURE(
+                IsNanAsTrue(unionFeature) == IsNanAsTrue(floatFeature),
+                "Nan value treatment mismatch for float feature " << floatFeature.FeatureIndex
+            );
+            unionFeature.Borders.insert(
+                unionFeature.Borders.end(),
+                floatFeature.Borders.begin(),
+                floatFeature.Borders.end()
+            );
+        }
+    }
+    TVector<TFloatFeature> unionFloatFeatures;
+    THashMap<int, size_t> unionBinFeatureOffsets;
+    size_t binFeatureCount = 0;
+    for (auto& [featureIndex, floatFeature] : unionFeatures) {
+        SortUnique(floatFeature.Borders);
+        unionBinFeatureOffsets[featureIndex] = binFeatureCount;
+        binFeatureCount += floatFeature.Borders.size();
+        unionFloatFeatures.push_back(floatFeature);
+    }
+
+    for (const auto* model : models) {
+        const auto& binFeatures = model->ObliviousTrees.GetBinFeatures();
+        auto& sharedModel = Models.emplace_back();
+        sharedModel.ObliviousTrees = model->ObliviousTrees;
+        sharedModel.ObliviousTrees.FloatFeatures = unionFloatFeatures;
+        for (auto& split : sharedModel.ObliviousTrees.TreeSplits) {
+            const auto& floatSplit = binFeatures[split].FloatFeature;
+            const auto& unionBorders = unionFeatures.at(floatSplit.FloatFeature).Borders;
+            split = unionBinFeatureOffsets.at(floatSplit.FloatFeature)
+                + (LowerBound(unionBorders.begin(), unionBorders.end(), floatSplit.Split) - unionBorders.begin());
+        }
+        sharedModel.UpdateDynamicData();
+    }
+}
+
+TVector<TVector<double>> TMultiModelEvaluator::CalcFlat(TConstArrayRef<TConstArrayRef<float>> features) const {
+    const TFullModel& binarizationModel = Models[0];
+    const auto expectedFlatVecSize = binarizationModel.ObliviousTrees.GetFlatFeatureVectorExpectedSize();
+    for (const auto& flatFeaturesVec : features) {
+        CB_ENSURE(
+            flatFeaturesVec.size() >= expectedFlatVecSize,
+            "insufficient flat features vector size: " << flatFeaturesVec.size()
+            << " expected: " << expectedFlatVecSize
+        );
+    }
+    const size_t docCount = features.size();
+    TVector<TVector<double>> results(Models.size());
+    for (size_t modelIdx = 0; modelIdx < Models.size(); ++modelIdx) {
+        results[modelIdx].resize(docCount * Models[modelIdx].ObliviousTrees.ApproxDimension, 0.0);
+    }
+    if (docCount == 0) {
+        return results;
+    }
+
+    const size_t blockSize = Min(FORMULA_EVALUATION_BLOCK_SIZE, docCount);
+    TVector<ui8> binFeatures(blockSize * binarizationModel.ObliviousTrees.GetEffectiveBinaryFeaturesBucketsCount());
+    TVector<TCalcerIndexType> indexesVec(blockSize);
+    TVector<ui32> transposedHash;
+    TVector<float> ctrs;
+    TVector<TTreeCalcFunction> calcFunctions;
+    for (const auto& model : Models) {
+        calcFunctions.push_back(GetCalcTreesFunction(model, blockSize));
+    }
+    for (size_t blockStart = 0; blockStart < docCount; blockStart += blockSize) {
+        const auto docCountInBlock = Min(blockSize, docCount - blockStart);
+        BinarizeFeatures(
+            binarizationModel,
+            [&features](const TFloatFeature& floatFeature, size_t index) -> float {
+                return features[index][floatFeature.FlatFeatureIndex];
+            },
+            [](const TCatFeature&, size_t) -> int {
+                Y_UNREACHABLE();
+            },
+            blockStart,
+            blockStart + docCountInBlock,
+            binFeatures,
+            transposedHash,
+            ctrs
+        );
+        for (size_t modelIdx = 0; modelIdx < Models.size(); ++modelIdx) {
+            const auto& model = Models[modelIdx];
+            calcFunctions[modelIdx](
+                model,
+                binFeatures.data(),
+                docCountInBlock,
+                indexesVec.data(),
+                0,
+                model.GetTreeCount(),
+                results[modelIdx].data() + blockStart * model.ObliviousTrees.ApproxDimension
+            );
+        }
+    }
+    return results;
+}
+
 constexpr size_t SSE_BLOCK_SIZE = 16;
 
 template <bool NeedXorMask, size_t START_BLOCK, typename TIndexType>
@@ -183,6 +307,33 @@ static void CalcIndexesSse(
 
 #endif
 
+void CalcIndexes(
+    bool needXorMask,
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    ui8* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr,
+    int curTreeSize) {
+    Y_ASSERT(curTreeSize <= 8);
+    memset(indexesVec, 0, docCountInBlock);
+#ifdef _sse2_
+    if (docCountInBlock == FORMULA_EVALUATION_BLOCK_SIZE) {
+        constexpr size_t SSEBlockCount = FORMULA_EVALUATION_BLOCK_SIZE / SSE_BLOCK_SIZE;
+        if (needXorMask) {
+            CalcIndexesSse<true, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+        } else {
+            CalcIndexesSse<false, SSEBlockCount>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+        }
+        return;
+    }
+#endif
+    if (needXorMask) {
+        CalcIndexesBasic<true, 0>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+    } else {
+        CalcIndexesBasic<false, 0>(binFeatures, docCountInBlock, indexesVec, treeSplitsCurPtr, curTreeSize);
+    }
+}
+
 template <typename TIndexType>
 Y_FORCE_INLINE void CalculateLeafValues(const size_t docCountInBlock, const double* __restrict treeLeafPtr, const TIndexType* __restrict indexesPtr, double* __restrict writePtr) {
     Y_PREFETCH_READ(treeLeafPtr, 3);
@@ -348,6 +348,16 @@ void CalcIndexes(
     const TRepackedBin* __restrict treeSplitsCurPtr,
     int curTreeSize);
 
+// Leaf indexes for trees with depth up to 8, indexesVec is overwritten.
+// Blocks of FORMULA_EVALUATION_BLOCK_SIZE documents are processed with SSE.
+void CalcIndexes(
+    bool needXorMask,
+    const ui8* __restrict binFeatures,
+    size_t docCountInBlock,
+    ui8* __restrict indexesVec,
+    const TRepackedBin* __restrict treeSplitsCurPtr,
+    int curTreeSize);
+
 TTreeCalcFunction GetCalcTreesFunction(const TFullModel& model, size_t docCountInBlock);
 
 template <class X>
@@ -489,6 +499,33 @@ private:
     ui64 BlockSize;
 };
 
+/**
+ * Evaluates several models trained on the same float features with shared binarization.
+ * Union of all models borders is built once, each documents block is binarized once and trees of every
+ *  model are evaluated on the shared binarized features.
+ * Holds a copy of each model with tree splits remapped onto the union borders.
+ * Only models without categorical features are supported.
+ */
+class TMultiModelEvaluator {
+public:
+    explicit TMultiModelEvaluator(TConstArrayRef<const TFullModel*> models);
+
+    size_t GetModelCount() const {
+        return Models.size();
+    }
+
+    /**
+     * Evaluate all models on flat feature vectors, see TFullModel::CalcFlat
+     * @param[in] features vector of flat features array reference. First dimension is object index, second
+     *  dimension is feature index.
+     * @return results for each model, indexation is [modelIndex][objectIndex * ApproxDimension + classId]
+     */
+    TVector<TVector<double>> CalcFlat(TConstArrayRef<TConstArrayRef<float>> features) const;
+
+private:
+    TVector<TFullModel> Models;
+};
+
 template <typename TFloatFeatureAccessor, typename TCatFeatureAccessor>
 inline TVector<TVector<double>> CalcTreeIntervalsGeneric(
     const TFullModel& model,
@@ -23,6 +23,7 @@
 #include <util/generic/algorithm.h>
 #include <util/generic/buffer.h>
 #include <util/generic/fwd.h>
+#include <util/generic/map.h>
 #include <util/generic/variant.h>
 #include <util/generic/xrange.h>
 #include <util/string/builder.h>
@@ -401,6 +402,132 @@ void TObliviousTrees::DropUnusedFeatures() {
     UpdateMetadata();
 }
 
+void TObliviousTrees::ReorderTreesForFeatureLocality() {
+    const auto& binFeatures = GetBinFeatures();
+    const auto& repackedBins = GetRepackedBins();
+    const auto& leafOffsets = GetFirstLeafOffsets();
+    const size_t treeCount = TreeSizes.size();
+
+    // rank binarized feature buckets by split usage frequency, most used first
+    TVector<ui32> bucketUsage(GetEffectiveBinaryFeaturesBucketsCount(), 0);
+    for (const auto& bin : repackedBins) {
+        ++bucketUsage[bin.FeatureIndex];
+    }
+    TVector<ui32> bucketsByUsage(bucketUsage.size());
+    Iota(bucketsByUsage.begin(), bucketsByUsage.end(), 0);
+    StableSort(bucketsByUsage.begin(), bucketsByUsage.end(), [&bucketUsage](ui32 lhs, ui32 rhs) {
+        return bucketUsage[lhs] > bucketUsage[rhs];
+    });
+    TVector<ui32> bucketRank(bucketUsage.size());
+    for (auto rank : xrange(bucketsByUsage.size())) {
+        bucketRank[bucketsByUsage[rank]] = rank;
+    }
+
+    // inside each tree put splits on hot buckets first, trees are then sorted by their bucket rank sequences
+    TVector<TVector<int>> treeSplitsOrder(treeCount);
+    TVector<TVector<ui32>> treeBucketRanks(treeCount);
+    for (size_t treeIdx = 0; treeIdx < treeCount; ++treeIdx) {
+        const int treeStart = TreeStartOffsets[treeIdx];
+        auto& splitsOrder = treeSplitsOrder[treeIdx];
+        splitsOrder.resize(TreeSizes[treeIdx]);
+        Iota(splitsOrder.begin(), splitsOrder.end(), 0);
+        StableSort(splitsOrder.begin(), splitsOrder.end(), [&](int lhs, int rhs) {
+            return bucketRank[repackedBins[treeStart + lhs].FeatureIndex]
+                < bucketRank[repackedBins[treeStart + rhs].FeatureIndex];
+        });
+        for (int depth : splitsOrder) {
+            treeBucketRanks[treeIdx].push_back(bucketRank[repackedBins[treeStart + depth].FeatureIndex]);
+        }
+    }
+    TVector<size_t> treesOrder(treeCount);
+    Iota(treesOrder.begin(), treesOrder.end(), 0);
+    StableSort(treesOrder.begin(), treesOrder.end(), [&treeBucketRanks](size_t lhs, size_t rhs) {
+        return treeBucketRanks[lhs] < treeBucketRanks[rhs];
+    });
+
+    TObliviousTreeBuilder builder(FloatFeatures, CatFeatures, ApproxDimension);
+    for (size_t treeIdx : treesOrder) {
+        const int treeStart = TreeStartOffsets[treeIdx];
+        const auto& splitsOrder = treeSplitsOrder[treeIdx];
+        TVector<TModelSplit> modelSplits;
+        for (int depth : splitsOrder) {
+            modelSplits.push_back(binFeatures[TreeSplits[treeStart + depth]]);
+        }
+        // new leaf index bit at position d corresponds to old bit at position splitsOrder[d]
+        const size_t leafCount = 1u << TreeSizes[treeIdx];
+        TVector<double> leafValues(leafCount * ApproxDimension);
+        TVector<double> leafWeights;
+        if (!LeafWeights.empty()) {
+            leafWeights.resize(leafCount);
+        }
+        for (size_t newLeaf = 0; newLeaf < leafCount; ++newLeaf) {
+            size_t oldLeaf = 0;
+            for (size_t depth = 0; depth < splitsOrder.size(); ++depth) {
+                oldLeaf |= ((newLeaf >> depth) & 1) << splitsOrder[depth];
+            }
+            for (int dim = 0; dim < ApproxDimension; ++dim) {
+                leafValues[newLeaf * ApproxDimension + dim]
+                    = LeafValues[leafOffsets[treeIdx] + oldLeaf * ApproxDimension + dim];
+            }
+            if (!LeafWeights.empty()) {
+                leafWeights[newLeaf] = LeafWeights[treeIdx][oldLeaf];
+            }
+        }
+        builder.AddTree(modelSplits, leafValues, leafWeights);
+    }
+    *this = builder.Build();
+}
+
+void TObliviousTrees::FoldIdenticalTrees() {
+    const auto& binFeatures = GetBinFeatures();
+    const auto& leafOffsets = GetFirstLeafOffsets();
+
+    // trees are folded into the first tree with the same split sequence, so trees order is kept
+    TMap<TVector<int>, size_t> foldedTreeIndexBySplits;
+    TVector<TVector<int>> foldedTreeSplits;
+    TVector<TVector<double>> foldedLeafValues;
+    TVector<TVector<double>> foldedLeafWeights;
+    for (size_t treeIdx = 0; treeIdx < TreeSizes.size(); ++treeIdx) {
+        const auto treeSplitsBegin = TreeSplits.begin() + TreeStartOffsets[treeIdx];
+        TVector<int> treeSplits(treeSplitsBegin, treeSplitsBegin + TreeSizes[treeIdx]);
+        const size_t leafCount = 1u << TreeSizes[treeIdx];
+        const double* treeLeafValues = LeafValues.data() + leafOffsets[treeIdx];
+        const auto [it, isNewSplits] = foldedTreeIndexBySplits.emplace(treeSplits, foldedTreeSplits.size());
+        if (isNewSplits) {
+            foldedTreeSplits.push_back(std::move(treeSplits));
+            foldedLeafValues.emplace_back(treeLeafValues, treeLeafValues + leafCount * ApproxDimension);
+            foldedLeafWeights.emplace_back();
+            if (!LeafWeights.empty()) {
+                foldedLeafWeights.back() = LeafWeights[treeIdx];
+            }
+            continue;
+        }
+        auto& leafValues = foldedLeafValues[it->second];
+        for (size_t valueIdx = 0; valueIdx < leafValues.size(); ++valueIdx) {
+            leafValues[valueIdx] += treeLeafValues[valueIdx];
+        }
+        if (!LeafWeights.empty()) {
+            auto& leafWeights = foldedLeafWeights[it->second];
+            for (size_t leafIdx = 0; leafIdx < leafWeights.size(); ++leafIdx) {
+                leafWeights[leafIdx] += LeafWeights[treeIdx][leafIdx];
+            }
+        }
+    }
+    if (foldedTreeSplits.size() == TreeSizes.size()) {
+        return;
+    }
+
+    TObliviousTreeBuilder builder(FloatFeatures, CatFeatures, ApproxDimension);
+    for (size_t treeIdx = 0; treeIdx < foldedTreeSplits.size(); ++treeIdx) {
+        TVector<TModelSplit> modelSplits;
+        for (int binFeatureIdx : foldedTreeSplits[treeIdx]) {
+            modelSplits.push_back(binFeatures[binFeatureIdx]);
+        }
+        builder.AddTree(modelSplits, foldedLeafValues[treeIdx], foldedLeafWeights[treeIdx]);
+    }
+    *this = builder.Build();
+}
+
 void TFullModel::CalcFlat(
     TConstArrayRef<TConstArrayRef<float>> features,
     size_t treeStart,
@@ -901,16 +1028,16 @@ static void StreamModelTreesToBuilder(
     }
 }
 
-TFullModel SumModels(
-    const TVector<const TFullModel*> modelVector,
+// Sums trees and model info, ctr providers of summed models are returned to be merged by the caller.
+static TFullModel SumModelsWithoutCtrs(
+    const TVector<const TFullModel*>& modelVector,
     const TVector<double>& weights,
-    ECtrTableMergePolicy ctrMergePolicy) {
+    TVector<TIntrusivePtr<ICtrProvider>>* ctrProviders) {
 
     CB_ENSURE(!modelVector.empty(), "empty model vector unexpected");
     CB_ENSURE(modelVector.size() == weights.size());
     const auto approxDimension = modelVector.back()->ObliviousTrees.ApproxDimension;
     size_t maxFlatFeatureVectorSize = 0;
-    TVector<TIntrusivePtr<ICtrProvider>> ctrProviders;
     for (const auto& model : modelVector) {
         Y_ASSERT(model != nullptr);
         CB_ENSURE(
@@ -922,7 +1049,7 @@ TFullModel SumModels(
             maxFlatFeatureVectorSize,
             model->ObliviousTrees.GetFlatFeatureVectorExpectedSize()
         );
-        ctrProviders.push_back(model->CtrProvider);
+        ctrProviders->push_back(model->CtrProvider);
     }
     TVector<TFlatFeature> flatFeatureInfoVector(maxFlatFeatureVectorSize);
     for (const auto& model : modelVector) {
@@ -950,7 +1077,32 @@ TFullModel SumModels(
             result.ModelInfo[keyPrefix + key] = value;
         }
     }
-    result.CtrProvider = MergeCtrProvidersData(ctrProviders, ctrMergePolicy);
+    return result;
+}
+
+TFullModel SumModels(
+    const TVector<const TFullModel*> modelVector,
+    const TVector<double>& weights,
+    ECtrTableMergePolicy ctrMergePolicy,
+    int threadCount) {
+
+    TVector<TIntrusivePtr<ICtrProvider>> ctrProviders;
+    TFullModel result = SumModelsWithoutCtrs(modelVector, weights, &ctrProviders);
+    result.CtrProvider = MergeCtrProvidersData(ctrProviders, ctrMergePolicy, threadCount);
     result.UpdateDynamicData();
     return result;
 }
+
+TFullModel SumModelsForSerialization(
+    const TVector<const TFullModel*> modelVector,
+    const TVector<double>& weights,
+    ECtrTableMergePolicy ctrMergePolicy,
+    int threadCount) {
+
+    TVector<TIntrusivePtr<ICtrProvider>> ctrProviders;
+    TFullModel result = SumModelsWithoutCtrs(modelVector, weights, &ctrProviders);
+    result.CtrProvider = MergeCtrProvidersDataForSerialization(ctrProviders, ctrMergePolicy, threadCount);
+    // streamed ctr provider can't set up feature indexes, so only trees metadata is updated
+    result.ObliviousTrees.UpdateMetadata();
+    return result;
+}
@@ -249,6 +249,21 @@ public:
      */
      void DropUnusedFeatures();
 
+    /**
+     * Reorder trees and splits inside each tree so that consecutive trees touch the same binarized
+     *  feature buckets during evaluation. Buckets used by most splits go first.
+     * Leaf values are permuted accordingly, so model predictions stay the same up to floating point
+     *  summation order. Staged evaluation results (CalcTreeIntervals) will change.
+     */
+    void ReorderTreesForFeatureLocality();
+
+    /**
+     * Fold trees with identical split sequences into the first of them: leaf values (and leaf weights)
+     *  of folded trees are summed. Model predictions stay the same up to floating point summation order,
+     *  tree count and model size decrease. Staged evaluation results (CalcTreeIntervals) will change.
+     */
+    void FoldIdenticalTrees();
+
     /**
      * Internal usage only. Updates metadata UsedModelCtrs and BinFeatures vectors to contain all features
      *  currently used in model.
@@ -420,6 +435,24 @@ public:
         UpdateDynamicData();
     }
 
+    /**
+     * Model post-processing pass that improves binarized features access locality during evaluation.
+     * See TObliviousTrees::ReorderTreesForFeatureLocality for details.
+     */
+    void ReorderTreesForFeatureLocality() {
+        ObliviousTrees.ReorderTreesForFeatureLocality();
+        UpdateDynamicData();
+    }
+
+    /**
+     * Model post-processing pass that reduces trees count by folding trees with the same splits.
+     * See TObliviousTrees::FoldIdenticalTrees for details.
+     */
+    void FoldIdenticalTrees() {
+        ObliviousTrees.FoldIdenticalTrees();
+        UpdateDynamicData();
+    }
+
     /**
      * @return Minimal float features vector length sufficient for this model
      */
@@ -742,4 +775,15 @@ TVector<TString> GetModelClassNames(const TFullModel& model);
 TFullModel SumModels(
     const TVector<const TFullModel*> modelVector,
     const TVector<double>& weights,
-    ECtrTableMergePolicy ctrMergePolicy = ECtrTableMergePolicy::IntersectingCountersAverage);
+    ECtrTableMergePolicy ctrMergePolicy = ECtrTableMergePolicy::IntersectingCountersAverage,
+    int threadCount = 1);
+
+/**
+ * Same as SumModels, but ctr tables are merged only while the resulting model is saved and are not kept
+ * in memory together. The resulting model can only be saved.
+ */
+TFullModel SumModelsForSerialization(
+    const TVector<const TFullModel*> modelVector,
+    const TVector<double>& weights,
+    ECtrTableMergePolicy ctrMergePolicy = ECtrTableMergePolicy::IntersectingCountersAverage,
+    int threadCount = 1);
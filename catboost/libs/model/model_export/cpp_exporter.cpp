@@ -327,4 +327,147 @@ namespace NCatboost {
         Out << '\n';
         Out << NResource::Find("catboost_model_export_cpp_model_applicator");
     }
+
+    /*
+     * Straight-line code specialized for each tree of the model
+     */
+
+    static constexpr size_t SPECIALIZED_TREES_PER_FUNCTION = 64;
+
+    void TCatboostModelToCppConverter::WriteSpecializedModel(const TFullModel& model) {
+        CB_ENSURE(!model.HasCategoricalFeatures(), "Specialized export of model with categorical features to cpp is not supported.");
+        CB_ENSURE(model.ObliviousTrees.ApproxDimension == 1, "Export of MultiClassification model to cpp is not supported.");
+        CB_ENSURE(model.GetTreeCount() > 0, "Export of empty model to cpp is not supported.");
+
+        // zero-sized arrays are not allowed, so keep at least one binary feature slot
+        const int binaryFeatureCount = GetBinaryFeatureCount(model);
+        const int binaryFeatureSlots = Max(binaryFeatureCount, 1);
+
+        TIndent indent(0);
+        Out << "#include <algorithm>" << '\n';
+        Out << "#include <cstddef>" << '\n';
+        Out << '\n';
+        Out << "/* Model data */" << '\n';
+        Out << indent++ << "namespace CatboostSpecializedModel {" << '\n';
+        Out << indent << "constexpr size_t FloatFeatureCount = " << model.GetNumFloatFeatures() << ";" << '\n';
+        Out << indent << "constexpr size_t BinaryFeatureCount = " << binaryFeatureSlots << ";" << '\n';
+        Out << indent << "constexpr size_t TreeCount = " << model.GetTreeCount() << ";" << '\n';
+        Out << indent << "constexpr size_t BatchBlockSize = 16;" << '\n';
+        Out << '\n';
+        Out << indent << "constexpr float Borders[BinaryFeatureCount] = {"
+            << (binaryFeatureCount ? OutputBorders(model, true) : TString("0.f")) << "};" << '\n';
+        Out << '\n';
+        Out << indent << "/* Aggregated array of leaf values for trees. Each tree is represented by a separate line: */" << '\n';
+        Out << indent << "constexpr double LeafValues[" << model.ObliviousTrees.LeafValues.size() << "] = {" << OutputLeafValues(model, indent);
+        Out << indent << "};" << '\n';
+        Out << '\n';
+
+        Out << indent << "/* Binarize features of BlockSize documents, binaryFeatures layout is [binFeatureIndex][docIndex] */" << '\n';
+        Out << indent << "template <size_t BlockSize>" << '\n';
+        Out << indent++ << "inline void BinarizeBlock(const float* features, size_t rowStride, size_t docCount, unsigned char (*binaryFeatures)[BlockSize]) {" << '\n';
+        Out << indent << "float values[BlockSize] = {};" << '\n';
+        int binFeatureIndex = 0;
+        for (const auto& floatFeature : model.ObliviousTrees.FloatFeatures) {
+            if (!floatFeature.UsedInModel()) {
+                continue;
+            }
+            Out << indent << "for (size_t doc = 0; doc < docCount; ++doc) {" << '\n';
+            Out << indent << "    values[doc] = features[doc * rowStride + " << floatFeature.FeatureIndex << "];" << '\n';
+            Out << indent << "}" << '\n';
+            for (size_t borderIdx = 0; borderIdx < floatFeature.Borders.size(); ++borderIdx, ++binFeatureIndex) {
+                Out << indent << "for (size_t doc = 0; doc < BlockSize; ++doc) {" << '\n';
+                Out << indent << "    binaryFeatures[" << binFeatureIndex << "][doc] = values[doc] > Borders[" << binFeatureIndex << "];" << '\n';
+                Out << indent << "}" << '\n';
+            }
+        }
+        Out << --indent << "}" << '\n';
+
+        const auto& trees = model.ObliviousTrees;
+        const auto& leafOffsets = trees.GetFirstLeafOffsets();
+        const size_t treeCount = trees.GetTreeCount();
+        for (size_t blockStart = 0; blockStart < treeCount; blockStart += SPECIALIZED_TREES_PER_FUNCTION) {
+            const size_t blockEnd = Min(blockStart + SPECIALIZED_TREES_PER_FUNCTION, treeCount);
+            Out << '\n';
+            Out << indent << "template <size_t BlockSize>" << '\n';
+            Out << indent++ << "inline void ApplyTreesBlock" << blockStart / SPECIALIZED_TREES_PER_FUNCTION
+                << "(const unsigned char (*binaryFeatures)[BlockSize], double* results) {" << '\n';
+            Out << indent << "unsigned int index[BlockSize];" << '\n';
+            Out << indent << "(void)binaryFeatures;" << '\n';
+            for (size_t treeIdx = blockStart; treeIdx < blockEnd; ++treeIdx) {
+                const int treeStart = trees.TreeStartOffsets[treeIdx];
+                const int treeDepth = trees.TreeSizes[treeIdx];
+                Out << indent << "/* Tree " << treeIdx << ", depth " << treeDepth << " */" << '\n';
+                Out << indent << "for (size_t doc = 0; doc < BlockSize; ++doc) {" << '\n';
+                Out << indent << "    index[doc] = ";
+                if (treeDepth == 0) {
+                    Out << "0";
+                }
+                for (int depth = 0; depth < treeDepth; ++depth) {
+                    if (depth != 0) {
+                        Out << " | ";
+                    }
+                    Out << "(binaryFeatures[" << trees.TreeSplits[treeStart + depth] << "][doc] << " << depth << ")";
+                }
+                Out << ";" << '\n';
+                Out << indent << "}" << '\n';
+                Out << indent << "for (size_t doc = 0; doc < BlockSize; ++doc) {" << '\n';
+                Out << indent << "    results[doc] += LeafValues[" << leafOffsets[treeIdx] << " + index[doc]];" << '\n';
+                Out << indent << "}" << '\n';
+            }
+            Out << --indent << "}" << '\n';
+        }
+
+        Out << '\n';
+        Out << indent << "template <size_t BlockSize>" << '\n';
+        Out << indent++ << "inline void ApplyBlock(const float* features, size_t rowStride, size_t docCount, double* results) {" << '\n';
+        Out << indent << "unsigned char binaryFeatures[BinaryFeatureCount][BlockSize];" << '\n';
+        Out << indent << "double blockResults[BlockSize] = {};" << '\n';
+        Out << indent << "BinarizeBlock<BlockSize>(features, rowStride, docCount, binaryFeatures);" << '\n';
+        for (size_t blockStart = 0; blockStart < treeCount; blockStart += SPECIALIZED_TREES_PER_FUNCTION) {
+            Out << indent << "ApplyTreesBlock" << blockStart / SPECIALIZED_TREES_PER_FUNCTION
+                << "<BlockSize>(binaryFeatures, blockResults);" << '\n';
+        }
+        Out << indent << "std::copy(blockResults, blockResults + docCount, results);" << '\n';
+        Out << --indent << "}" << '\n';
+        Out << --indent << "}" << '\n';
+        Out << '\n';
+    }
+
+    void TCatboostModelToCppConverter::WriteSpecializedApplicator(const TFullModel& /*model*/) {
+        Out << "/* Model applicator */" << '\n';
+        Out << '\n';
+        Out << "/*" << '\n';
+        Out << " * Batch applicator: features is a row-major array of docCount rows with rowStride floats each," << '\n';
+        Out << " * results should have space for docCount values" << '\n';
+        Out << " */" << '\n';
+        Out << "void ApplyCatboostModelBatch(" << '\n';
+        Out << "    const float* features," << '\n';
+        Out << "    size_t rowStride," << '\n';
+        Out << "    size_t docCount," << '\n';
+        Out << "    double* results" << '\n';
+        Out << ") {" << '\n';
+        Out << "    using namespace CatboostSpecializedModel;" << '\n';
+        Out << "    for (size_t blockStart = 0; blockStart < docCount; blockStart += BatchBlockSize) {" << '\n';
+        Out << "        const size_t blockDocCount = std::min(BatchBlockSize, docCount - blockStart);" << '\n';
+        Out << "        ApplyBlock<BatchBlockSize>(features + blockStart * rowStride, rowStride, blockDocCount, results + blockStart);" << '\n';
+        Out << "    }" << '\n';
+        Out << "}" << '\n';
+        Out << '\n';
+        Out << "double ApplyCatboostModel(" << '\n';
+        Out << "    const std::vector<float>& features" << '\n';
+        Out << ") {" << '\n';
+        Out << "    double result = 0.0;" << '\n';
+        Out << "    CatboostSpecializedModel::ApplyBlock<1>(features.data(), features.size(), 1, &result);" << '\n';
+        Out << "    return result;" << '\n';
+        Out << "}" << '\n';
+
+        // Also emit the API with catFeatures, for uniformity
+        Out << '\n';
+        Out << "double ApplyCatboostModel(" << '\n';
+        Out << "    const std::vector<float>& floatFeatures," << '\n';
+        Out << "    const std::vector<std::string>&" << '\n';
+        Out << ") {" << '\n';
+        Out << "    return ApplyCatboostModel(floatFeatures);" << '\n';
+        Out << "}" << '\n';
+    }
 }
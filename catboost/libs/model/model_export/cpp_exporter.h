@@ -4,23 +4,45 @@
 
 #include <catboost/libs/helpers/exception.h>
 
+#include <library/json/json_reader.h>
+
 #include <util/stream/file.h>
+#include <util/stream/str.h>
 
 
 namespace NCatboost {
     class TCatboostModelToCppConverter: public ICatboostModelExporter {
     private:
         TOFStream Out;
+        bool SpecializedCode = false;
 
     public:
+        /*
+         * Supported user params:
+         *  "specialized_code": true - generate straight-line code specialized for each tree of the model
+         *   instead of generic applicator loop over model arrays. Only models without categorical features
+         *   are supported.
+         */
         TCatboostModelToCppConverter(const TString& modelFile, bool addFileFormatExtension, const TString& userParametersJson)
             : Out(modelFile + (addFileFormatExtension ? ".cpp" : ""))
         {
-            CB_ENSURE(userParametersJson.empty(), "JSON user params for exporting the model to C++ are not supported");
+            if (!userParametersJson.empty()) {
+                TStringInput is(userParametersJson);
+                NJson::TJsonValue params;
+                NJson::ReadJsonTree(&is, &params);
+                for (const auto& [key, value] : params.GetMapSafe()) {
+                    CB_ENSURE(key == "specialized_code", "Unsupported JSON user param for exporting the model to C++: " << key);
+                    SpecializedCode = value.GetBooleanSafe();
+                }
+            }
         };
 
         void Write(const TFullModel& model, const THashMap<ui32, TString>* catFeaturesHashToString = nullptr) override {
-            if (model.HasCategoricalFeatures()) {
+            if (SpecializedCode) {
+                WriteHeader(/*forCatFeatures*/false);
+                WriteSpecializedModel(model);
+                WriteSpecializedApplicator(model);
+            } else if (model.HasCategoricalFeatures()) {
                 WriteHeader(/*forCatFeatures*/true);
                 WriteModelCatFeatures(model, catFeaturesHashToString);
                 WriteApplicatorCatFeatures();
@@ -38,5 +60,7 @@ namespace NCatboost {
         void WriteCTRStructs();
         void WriteModelCatFeatures(const TFullModel& model, const THashMap<ui32, TString>* catFeaturesHashToString);
         void WriteApplicatorCatFeatures();
+        void WriteSpecializedModel(const TFullModel& model);
+        void WriteSpecializedApplicator(const TFullModel& model);
     };
 }
@@ -4,6 +4,11 @@
 
 #include <catboost/libs/model/model_export/export_helpers.h>
 
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/digest/city.h>
+#include <util/digest/multi.h>
+#include <util/generic/hash.h>
 #include <util/generic/xrange.h>
 #include <util/generic/set.h>
 #include <util/string/cast.h>
@@ -66,6 +71,16 @@ NJson::TJsonValue TStaticCtrProvider::ConvertCtrsToJson(const TVector<TModelCtr>
     return jsonValue;
 }
 
+// load ctr value table rows of the whole block to cache before gathering them
+template <class T>
+static void PrefetchCtrValues(TConstArrayRef<ui32> buckets, TConstArrayRef<T> values, size_t stride) {
+    for (ui32 bucket : buckets) {
+        if (bucket != NCatboost::TDenseIndexHashView::NotFoundIndex) {
+            Y_PREFETCH_READ(values.data() + bucket * stride, 3);
+        }
+    }
+}
+
 void TStaticCtrProvider::CalcCtrs(const TVector<TModelCtr>& neededCtrs,
                                   const TConstArrayRef<ui8>& binarizedFeatures,
                                   const TConstArrayRef<ui32>& hashedCatFeatures,
@@ -77,7 +92,7 @@ void TStaticCtrProvider::CalcCtrs(const TVector<TModelCtr>& neededCtrs,
     auto compressedModelCtrs = NCatboostModelExportHelpers::CompressModelCtrs(neededCtrs);
     size_t samplesCount = docCount;
     TVector<ui64> ctrHashes(samplesCount);
-    TVector<ui64> buckets(samplesCount);
+    TVector<ui32> buckets(samplesCount);
     size_t resultIdx = 0;
     float* resultPtr = result.data();
     TVector<int> transposedCatFeatureIndexes;
@@ -101,12 +116,11 @@ void TStaticCtrProvider::CalcCtrs(const TVector<TModelCtr>& neededCtrs,
             auto hashIndexResolver = learnCtr.GetIndexHashViewer();
             const ECtrType ctrType = ctr->Base.CtrType;
             auto ptrBuckets = buckets.data();
-            for (size_t docId = 0; docId < samplesCount; ++docId) {
-                ptrBuckets[docId] = hashIndexResolver.GetIndex(ctrHashes[docId]);
-            }
+            hashIndexResolver.GetIndexes(ctrHashes, buckets);
             if (ctrType == ECtrType::BinarizedTargetMeanValue || ctrType == ECtrType::FloatTargetMeanValue) {
                 const auto emptyVal = ctr->Calc(0.f, 0.f);
                 auto ctrMean = learnCtr.GetTypedArrayRefForBlobData<TCtrMeanHistory>();
+                PrefetchCtrValues(buckets, ctrMean, 1);
                 for (size_t doc = 0; doc < samplesCount; ++doc) {
                     if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
                         const TCtrMeanHistory& ctrMeanHistory = ctrMean[ptrBuckets[doc]];
@@ -118,6 +132,7 @@ void TStaticCtrProvider::CalcCtrs(const TVector<TModelCtr>& neededCtrs,
             } else if (ctrType == ECtrType::Counter || ctrType == ECtrType::FeatureFreq) {
                 TConstArrayRef<int> ctrTotal = learnCtr.GetTypedArrayRefForBlobData<int>();
                 const int denominator = learnCtr.CounterDenominator;
+                PrefetchCtrValues(buckets, ctrTotal, 1);
                 auto emptyVal = ctr->Calc(0, denominator);
                 for (size_t doc = 0; doc < samplesCount; ++doc) {
                     if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
@@ -129,6 +144,7 @@ void TStaticCtrProvider::CalcCtrs(const TVector<TModelCtr>& neededCtrs,
             } else if (ctrType == ECtrType::Buckets) {
                 auto ctrIntArray = learnCtr.GetTypedArrayRefForBlobData<int>();
                 const int targetClassesCount = learnCtr.TargetClassesCount;
+                PrefetchCtrValues(buckets, ctrIntArray, targetClassesCount);
                 auto emptyVal = ctr->Calc(0, 0);
                 for (size_t doc = 0; doc < samplesCount; ++doc) {
                     if (ptrBuckets[doc] != NCatboost::TDenseIndexHashView::NotFoundIndex) {
@@ -147,6 +163,7 @@ void TStaticCtrProvider::CalcCtrs(const TVector<TModelCtr>& neededCtrs,
             } else {
                 auto ctrIntArray = learnCtr.GetTypedArrayRefForBlobData<int>();
                 const int targetClassesCount = learnCtr.TargetClassesCount;
+                PrefetchCtrValues(buckets, ctrIntArray, targetClassesCount);
 
                 auto emptyVal = ctr->Calc(0, 0);
                 if (targetClassesCount > 2) {
@@ -342,7 +359,118 @@ static void MergeBuckets(const TVector<const TCtrValueTable*>& tables, TCtrValue
     }
 }
 
-TIntrusivePtr<TStaticCtrProvider> MergeStaticCtrProvidersData(const TVector<const TStaticCtrProvider*>& providers, ECtrTableMergePolicy mergePolicy) {
+static ui64 CalcCtrValueTableHash(const TCtrValueTable& table) {
+    const auto buckets = table.GetIndexHashViewer().GetBuckets();
+    const auto blob = table.GetTypedArrayRefForBlobData<char>();
+    return MultiHash(
+        CityHash64(reinterpret_cast<const char*>(buckets.data()), buckets.size() * sizeof(NCatboost::TBucket)),
+        CityHash64(blob.data(), blob.size()),
+        table.CounterDenominator,
+        table.TargetClassesCount
+    );
+}
+
+static bool AreAllTablesEqual(const TVector<const TCtrValueTable*>& tables) {
+    const ui64 firstHash = CalcCtrValueTableHash(*tables[0]);
+    for (const auto* table : tables) {
+        if (table != tables[0] && CalcCtrValueTableHash(*table) != firstHash) {
+            return false;
+        }
+    }
+    for (const auto* table : tables) {
+        if (!(*table == *tables[0])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns either one of tables or mergedTable.
+static const TCtrValueTable* MergeCtrValueTables(
+    const TModelCtrBase& ctrBase,
+    const TVector<const TCtrValueTable*>& tables,
+    ECtrTableMergePolicy mergePolicy,
+    TCtrValueTable* mergedTable
+) {
+    // models summed with themselves or sharing an ancestor often have equal tables
+    if (tables.size() == 1 || AreAllTablesEqual(tables)) {
+        return tables[0];
+    }
+    switch (mergePolicy)
+    {
+    case ECtrTableMergePolicy::LeaveMostDiversifiedTable:
+        {
+            size_t maxCtrTableSize = 0;
+            const TCtrValueTable* maxTable = nullptr;
+            for (const auto* valueTable : tables) {
+                auto ctrSize = valueTable->GetIndexHashViewer().CountNonEmptyBuckets();
+                if (ctrSize > maxCtrTableSize) {
+                    maxCtrTableSize = ctrSize;
+                    maxTable = valueTable;
+                }
+            }
+            Y_ASSERT(maxTable != nullptr);
+            return maxTable;
+        }
+    case ECtrTableMergePolicy::IntersectingCountersAverage:
+        *mergedTable = TCtrValueTable();
+        mergedTable->ModelCtrBase = ctrBase;
+        MergeBuckets(tables, mergedTable);
+        return mergedTable;
+    default:
+        Y_UNREACHABLE();
+    }
+}
+
+void MergeStaticCtrProvidersData(
+    const TVector<const TStaticCtrProvider*>& providers,
+    ECtrTableMergePolicy mergePolicy,
+    int threadCount,
+    const std::function<void(const TCtrValueTable&)>& tableCallback
+) {
+    CB_ENSURE(threadCount > 0, "Thread count should be positive");
+    TVector<std::pair<TModelCtrBase, TVector<const TCtrValueTable*>>> ctrBaseTables;
+    THashMap<TModelCtrBase, size_t> ctrBaseIndices;
+    for (const auto& provider: providers) {
+        for (const auto& [ctrBase, ctrValueTable] : provider->CtrData.LearnCtrs) {
+            const auto [it, isNew] = ctrBaseIndices.emplace(ctrBase, ctrBaseTables.size());
+            if (isNew) {
+                ctrBaseTables.emplace_back(ctrBase, TVector<const TCtrValueTable*>());
+            }
+            ctrBaseTables[it->second].second.push_back(&ctrValueTable);
+        }
+    }
+    if (mergePolicy == ECtrTableMergePolicy::FailIfCtrsIntersects) {
+        for (const auto& [ctrBase, tables] : ctrBaseTables) {
+            if (tables.size() > 1) {
+                throw TCatBoostException() << "FailIfCtrsIntersects policy forbids model ctr tables intersection";
+            }
+        }
+    }
+
+    NPar::TLocalExecutor localExecutor;
+    localExecutor.RunAdditionalThreads(threadCount - 1);
+    // tables are merged in groups and passed to callback in a fixed order, so only a group is kept in memory
+    const size_t groupSize = threadCount;
+    TVector<TCtrValueTable> mergedTables(groupSize);
+    TVector<const TCtrValueTable*> groupTables(groupSize);
+    for (size_t groupBegin = 0; groupBegin < ctrBaseTables.size(); groupBegin += groupSize) {
+        const size_t groupEnd = Min(groupBegin + groupSize, ctrBaseTables.size());
+        NPar::ParallelFor(localExecutor, 0, groupEnd - groupBegin, [&](int idx) {
+            const auto& [ctrBase, tables] = ctrBaseTables[groupBegin + idx];
+            groupTables[idx] = MergeCtrValueTables(ctrBase, tables, mergePolicy, &mergedTables[idx]);
+        });
+        for (size_t idx : xrange(groupEnd - groupBegin)) {
+            tableCallback(*groupTables[idx]);
+        }
+    }
+}
+
+TIntrusivePtr<TStaticCtrProvider> MergeStaticCtrProvidersData(
+    const TVector<const TStaticCtrProvider*>& providers,
+    ECtrTableMergePolicy mergePolicy,
+    int threadCount
+) {
     if (providers.empty()) {
         return TIntrusivePtr<TStaticCtrProvider>();
     }
@@ -351,44 +479,13 @@ TIntrusivePtr<TStaticCtrProvider> MergeStaticCtrProvidersData(const TVector<cons
         result->CtrData = providers[0]->CtrData;
         return result;
     }
-    THashMap<TModelCtrBase, TVector<const TCtrValueTable*>> valuesMap;
-    for (const auto& provider: providers) {
-        for (const auto& [ctrBase, ctrValueTables] : provider->CtrData.LearnCtrs) {
-            valuesMap[ctrBase].push_back(&ctrValueTables);
-        }
-    }
-    for (const auto& [ctrBase, ctrValueTables] : valuesMap) {
-        if (ctrValueTables.size() == 1) {
-            result->CtrData.LearnCtrs[ctrBase] = *(ctrValueTables[0]);
-            continue;
+    MergeStaticCtrProvidersData(
+        providers,
+        mergePolicy,
+        threadCount,
+        [&result](const TCtrValueTable& table) {
+            result->CtrData.LearnCtrs[table.ModelCtrBase] = table;
         }
-        auto& target = result->CtrData.LearnCtrs[ctrBase];
-        target.ModelCtrBase = ctrBase;
-        switch (mergePolicy)
-        {
-        case ECtrTableMergePolicy::FailIfCtrsIntersects:
-            throw TCatBoostException() << "FailIfCtrsIntersects policy forbids model ctr tables intersection";
-        case ECtrTableMergePolicy::LeaveMostDiversifiedTable:
-            {
-                size_t maxCtrTableSize = 0;
-                const TCtrValueTable* maxTable = nullptr;
-                for (const auto* valueTable : ctrValueTables) {
-                    auto ctrSize = valueTable->GetIndexHashViewer().CountNonEmptyBuckets();
-                    if (ctrSize > maxCtrTableSize) {
-                        maxCtrTableSize = ctrSize;
-                        maxTable = valueTable;
-                    }
-                }
-                Y_ASSERT(maxTable != nullptr);
-                result->CtrData.LearnCtrs[ctrBase] = *maxTable;
-            }
-            break;
-        case ECtrTableMergePolicy::IntersectingCountersAverage:
-            MergeBuckets(ctrValueTables, &target);
-            break;
-        default:
-            Y_UNREACHABLE();
-        }
-    }
+    );
     return result;
 }
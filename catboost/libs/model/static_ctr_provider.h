@@ -158,4 +158,16 @@ private:
 
 TIntrusivePtr<TStaticCtrProvider> MergeStaticCtrProvidersData(
     const TVector<const TStaticCtrProvider*>& providers,
-    ECtrTableMergePolicy mergePolicy);
+    ECtrTableMergePolicy mergePolicy,
+    int threadCount = 1);
+
+/**
+ * Merges ctr tables of providers one by one and passes them to tableCallback in the same order on every run,
+ * so that merged tables are not kept in memory together. Intersecting tables are merged by threadCount threads,
+ * tables that are equal in all providers are passed as is.
+ */
+void MergeStaticCtrProvidersData(
+    const TVector<const TStaticCtrProvider*>& providers,
+    ECtrTableMergePolicy mergePolicy,
+    int threadCount,
+    const std::function<void(const TCtrValueTable&)>& tableCallback);
@@ -0,0 +1,37 @@
+#include "model_test_helpers.h"
+
+#include <catboost/libs/model/model.h>
+
+#include <library/unittest/registar.h>
+
+
+Y_UNIT_TEST_SUITE(TFoldTreesTests) {
+    Y_UNIT_TEST(TestSummedModelTreesAreFolded) {
+        auto model = TrainFloatCatboostModel(/*iterations*/ 40);
+        // every tree of the summed model has an identical twin
+        auto summedModel = SumModels({&model, &model}, {1.0, 0.5});
+        auto foldedModel = summedModel;
+        foldedModel.FoldIdenticalTrees();
+
+        UNIT_ASSERT_VALUES_EQUAL(summedModel.GetTreeCount(), 2 * model.GetTreeCount());
+        UNIT_ASSERT(foldedModel.GetTreeCount() <= model.GetTreeCount());
+        UNIT_ASSERT_VALUES_EQUAL(
+            summedModel.ObliviousTrees.LeafWeights.empty(),
+            foldedModel.ObliviousTrees.LeafWeights.empty());
+
+        CheckPredictionsAreEqual(summedModel, foldedModel);
+    }
+
+    Y_UNIT_TEST(TestFoldingIsIdempotent) {
+        auto model = TrainFloatCatboostModel(/*iterations*/ 40);
+        auto foldedModel = SumModels({&model, &model}, {1.0, 0.5});
+        foldedModel.FoldIdenticalTrees();
+        UNIT_ASSERT(foldedModel.GetTreeCount() <= model.GetTreeCount());
+
+        auto foldedAgainModel = foldedModel;
+        foldedAgainModel.FoldIdenticalTrees();
+        UNIT_ASSERT_VALUES_EQUAL(foldedModel.GetTreeCount(), foldedAgainModel.GetTreeCount());
+        UNIT_ASSERT_EQUAL(foldedModel.ObliviousTrees.TreeSplits, foldedAgainModel.ObliviousTrees.TreeSplits);
+        UNIT_ASSERT_EQUAL(foldedModel.ObliviousTrees.LeafValues, foldedAgainModel.ObliviousTrees.LeafValues);
+    }
+}
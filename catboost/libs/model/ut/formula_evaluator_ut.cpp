@@ -6,6 +6,7 @@
 #include <catboost/libs/train_lib/train_model.h>
 
 #include <util/folder/tempdir.h>
+#include <util/random/fast.h>
 
 
 using namespace NCB;
@@ -189,4 +190,31 @@ Y_UNIT_TEST_SUITE(TObliviousTreeModel) {
         };
         UNIT_ASSERT_NO_EXCEPTION(applyBatch());
     }
+
+    Y_UNIT_TEST(TestMultiModelEvaluator) {
+        const TFullModel models[] = {SimpleFloatModel(), MultiValueFloatModel(), SimpleFloatModel()};
+        TVector<const TFullModel*> modelPtrs = {&models[0], &models[1], &models[2]};
+        TMultiModelEvaluator evaluator(modelPtrs);
+        UNIT_ASSERT_VALUES_EQUAL(evaluator.GetModelCount(), 3);
+
+        TFastRng64 rng(0);
+        for (size_t docCount : {1, 7, 300}) {
+            TVector<TVector<float>> data(docCount, TVector<float>(3));
+            TVector<TConstArrayRef<float>> features;
+            for (auto& doc : data) {
+                for (auto& value : doc) {
+                    value = rng.GenRandReal1() * 600.f - 300.f;
+                }
+                doc[1] = rng.GenRandReal1();
+                features.push_back(doc);
+            }
+            const auto results = evaluator.CalcFlat(features);
+            UNIT_ASSERT_VALUES_EQUAL(results.size(), 3);
+            for (size_t modelIdx = 0; modelIdx < 3; ++modelIdx) {
+                TVector<double> expected(docCount * models[modelIdx].GetDimensionsCount());
+                models[modelIdx].CalcFlat(features, expected);
+                UNIT_ASSERT_EQUAL(expected, results[modelIdx]);
+            }
+        }
+    }
 }
@@ -1,6 +1,7 @@
 #include "model_test_helpers.h"
 
 #include <catboost/libs/algo/apply.h>
+#include <catboost/libs/model/static_ctr_provider.h>
 #include <catboost/libs/train_lib/train_model.h>
 
 #include <library/unittest/registar.h>
@@ -8,6 +9,41 @@
 using namespace std;
 using namespace NCB;
 
+static TModelCtrBase MakeCounterCtrBase(int catFeatureIdx) {
+    TModelCtrBase ctrBase;
+    ctrBase.Projection.CatFeatures = {catFeatureIdx};
+    ctrBase.CtrType = ECtrType::Counter;
+    return ctrBase;
+}
+
+static TCtrValueTable MakeCounterTable(
+    const TModelCtrBase& ctrBase,
+    const TVector<std::pair<ui64, int>>& counters,
+    int counterDenominator
+) {
+    TCtrValueTable table;
+    table.ModelCtrBase = ctrBase;
+    table.CounterDenominator = counterDenominator;
+    auto hashBuilder = table.GetIndexHashBuilder(counters.size());
+    auto blob = table.AllocateBlobAndGetArrayRef<int>(counters.size());
+    for (const auto& [hash, counter] : counters) {
+        blob[hashBuilder.AddIndex(hash)] = counter;
+    }
+    return table;
+}
+
+static TVector<TIntrusivePtr<TStaticCtrProvider>> MakeIntersectingCtrProviders() {
+    const auto firstBase = MakeCounterCtrBase(0);
+    const auto secondBase = MakeCounterCtrBase(1);
+    TCtrData firstData;
+    firstData.LearnCtrs[firstBase] = MakeCounterTable(firstBase, {{1, 10}, {2, 20}}, 30);
+    firstData.LearnCtrs[secondBase] = MakeCounterTable(secondBase, {{1, 4}, {3, 8}}, 12);
+    TCtrData secondData;
+    secondData.LearnCtrs[firstBase] = firstData.LearnCtrs[firstBase];
+    secondData.LearnCtrs[secondBase] = MakeCounterTable(secondBase, {{1, 6}, {4, 2}}, 8);
+    return {new TStaticCtrProvider(firstData), new TStaticCtrProvider(secondData)};
+}
+
 Y_UNIT_TEST_SUITE(TModelSummTests) {
 
     Y_UNIT_TEST(FloatModelMergeTest) {
@@ -26,6 +62,61 @@ Y_UNIT_TEST_SUITE(TModelSummTests) {
         }
         auto mergedModel = SumModels(modelPtrs, modelWeights);
         UNIT_ASSERT_EQUAL(mergedModel.ObliviousTrees, bigModel.ObliviousTrees);
+
+        TStringStream streamedModel;
+        OutputModel(SumModelsForSerialization(modelPtrs, modelWeights), &streamedModel);
+        UNIT_ASSERT_EQUAL(DeserializeModel(streamedModel.Str()).ObliviousTrees, bigModel.ObliviousTrees);
+    }
+
+    Y_UNIT_TEST(CtrTablesMergeTest) {
+        const auto providerHolders = MakeIntersectingCtrProviders();
+        const TVector<const TStaticCtrProvider*> providers = {providerHolders[0].Get(), providerHolders[1].Get()};
+        const auto firstBase = MakeCounterCtrBase(0);
+        const auto secondBase = MakeCounterCtrBase(1);
+
+        const auto merged = MergeStaticCtrProvidersData(providers, ECtrTableMergePolicy::IntersectingCountersAverage);
+        // equal tables are left as is
+        UNIT_ASSERT_EQUAL(merged->CtrData.LearnCtrs.at(firstBase), providers[0]->CtrData.LearnCtrs.at(firstBase));
+        const auto& mergedTable = merged->CtrData.LearnCtrs.at(secondBase);
+        UNIT_ASSERT_VALUES_EQUAL(mergedTable.CounterDenominator, 10);
+        const auto indexViewer = mergedTable.GetIndexHashViewer();
+        const auto counters = mergedTable.GetTypedArrayRefForBlobData<int>();
+        UNIT_ASSERT_VALUES_EQUAL(counters[indexViewer.GetIndex(1)], 5);
+        UNIT_ASSERT_VALUES_EQUAL(counters[indexViewer.GetIndex(3)], 8);
+        UNIT_ASSERT_VALUES_EQUAL(counters[indexViewer.GetIndex(4)], 2);
+
+        const auto parallelMerged = MergeStaticCtrProvidersData(
+            providers,
+            ECtrTableMergePolicy::IntersectingCountersAverage,
+            /*threadCount*/ 4
+        );
+        UNIT_ASSERT_EQUAL(parallelMerged->CtrData, merged->CtrData);
+
+        UNIT_ASSERT_EXCEPTION(
+            MergeStaticCtrProvidersData(providers, ECtrTableMergePolicy::FailIfCtrsIntersects),
+            TCatBoostException
+        );
+    }
+
+    Y_UNIT_TEST(CtrTablesStreamedMergeTest) {
+        const auto providerHolders = MakeIntersectingCtrProviders();
+        const TVector<TIntrusivePtr<ICtrProvider>> providers(providerHolders.begin(), providerHolders.end());
+
+        const auto streamed = MergeCtrProvidersDataForSerialization(
+            providers,
+            ECtrTableMergePolicy::IntersectingCountersAverage,
+            /*threadCount*/ 2
+        );
+        TStringStream stream;
+        streamed->Save(&stream);
+        TStaticCtrProvider loaded;
+        loaded.Load(&stream);
+
+        const auto merged = MergeStaticCtrProvidersData(
+            {providerHolders[0].Get(), providerHolders[1].Get()},
+            ECtrTableMergePolicy::IntersectingCountersAverage
+        );
+        UNIT_ASSERT_EQUAL(loaded.CtrData, merged->CtrData);
     }
 
     Y_UNIT_TEST(AdultModelMergeTest) {
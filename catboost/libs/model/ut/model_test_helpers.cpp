@@ -5,6 +5,9 @@
 #include <catboost/libs/data_new/ut/lib/for_loader.h>
 #include <catboost/libs/train_lib/train_model.h>
 
+#include <library/unittest/registar.h>
+
+#include <util/random/fast.h>
 #include <util/string/builder.h>
 
 
@@ -72,6 +75,27 @@ TFullModel TrainFloatCatboostModel(int iterations, int seed) {
     return model;
 }
 
+void CheckPredictionsAreEqual(const TFullModel& lhs, const TFullModel& rhs, double eps) {
+    UNIT_ASSERT_VALUES_EQUAL(lhs.GetNumFloatFeatures(), rhs.GetNumFloatFeatures());
+    TFastRng64 rng(42);
+    const size_t docCount = 1000;
+    TVector<TVector<float>> features(docCount, TVector<float>(lhs.GetNumFloatFeatures()));
+    TVector<TConstArrayRef<float>> featureRefs;
+    for (auto& docFeatures : features) {
+        for (auto& value : docFeatures) {
+            value = rng.GenRandReal1();
+        }
+        featureRefs.push_back(docFeatures);
+    }
+    TVector<double> expected(docCount);
+    TVector<double> result(docCount);
+    lhs.CalcFlat(featureRefs, expected);
+    rhs.CalcFlat(featureRefs, result);
+    for (size_t docId = 0; docId < docCount; ++docId) {
+        UNIT_ASSERT_DOUBLES_EQUAL(expected[docId], result[docId], eps);
+    }
+}
+
 TDataProviderPtr GetAdultPool() {
     TSrcData srcData;
     srcData.DsvFileData =
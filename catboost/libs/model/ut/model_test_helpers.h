@@ -5,4 +5,7 @@
 
 TFullModel TrainFloatCatboostModel(int iterations = 5, int seed = 123);
 
+// compares predictions of float features only models on random documents
+void CheckPredictionsAreEqual(const TFullModel& lhs, const TFullModel& rhs, double eps = 1e-9);
+
 NCB::TDataProviderPtr GetAdultPool();
@@ -0,0 +1,24 @@
+#include "model_test_helpers.h"
+
+#include <catboost/libs/model/model.h>
+
+#include <library/unittest/registar.h>
+
+
+Y_UNIT_TEST_SUITE(TReorderTreesTests) {
+    Y_UNIT_TEST(TestPredictionsAreKept) {
+        auto model = TrainFloatCatboostModel(/*iterations*/ 40);
+        auto reorderedModel = model;
+        reorderedModel.ReorderTreesForFeatureLocality();
+
+        UNIT_ASSERT_VALUES_EQUAL(model.GetTreeCount(), reorderedModel.GetTreeCount());
+        UNIT_ASSERT_VALUES_EQUAL(
+            model.ObliviousTrees.GetBinaryFeaturesFullCount(),
+            reorderedModel.ObliviousTrees.GetBinaryFeaturesFullCount());
+        UNIT_ASSERT_VALUES_EQUAL(
+            model.ObliviousTrees.LeafWeights.size(),
+            reorderedModel.ObliviousTrees.LeafWeights.size());
+
+        CheckPredictionsAreEqual(model, reorderedModel);
+    }
+}
@@ -13,6 +13,7 @@ NCatboostOptions::TBoostingOptions::TBoostingOptions(ETaskType taskType)
     , OverfittingDetector("od_config", TOverfittingDetectorOptions())
     , BoostingType("boosting_type", EBoostingType::Ordered)
     , ApproxOnFullHistory("approx_on_full_history", false, taskType)
+    , SinglePrecisionFoldApproxes("single_precision_fold_approxes", false, taskType)
     , MinFoldSize("min_fold_size", 100, taskType)
     , DataPartitionType("data_partition", EDataPartitionType::FeatureParallel, taskType)
 {
@@ -21,22 +22,24 @@ NCatboostOptions::TBoostingOptions::TBoostingOptions(ETaskType taskType)
 void NCatboostOptions::TBoostingOptions::Load(const NJson::TJsonValue& options) {
     CheckedLoad(options,
             &LearningRate, &FoldLenMultiplier, &PermutationBlockSize, &IterationCount, &OverfittingDetector,
-            &BoostingType, &PermutationCount, &MinFoldSize, &ApproxOnFullHistory, &DataPartitionType);
+            &BoostingType, &PermutationCount, &MinFoldSize, &ApproxOnFullHistory, &SinglePrecisionFoldApproxes,
+            &DataPartitionType);
 
     Validate();
 }
 
 void NCatboostOptions::TBoostingOptions::Save(NJson::TJsonValue* options) const {
     SaveFields(options, LearningRate, FoldLenMultiplier, PermutationBlockSize, IterationCount, OverfittingDetector,
-            BoostingType, PermutationCount, MinFoldSize, ApproxOnFullHistory, DataPartitionType);
+            BoostingType, PermutationCount, MinFoldSize, ApproxOnFullHistory, SinglePrecisionFoldApproxes,
+            DataPartitionType);
 }
 
 bool NCatboostOptions::TBoostingOptions::operator==(const TBoostingOptions& rhs) const {
     return std::tie(LearningRate, FoldLenMultiplier, PermutationBlockSize, IterationCount, OverfittingDetector,
-            ApproxOnFullHistory, BoostingType, PermutationCount,
+            ApproxOnFullHistory, SinglePrecisionFoldApproxes, BoostingType, PermutationCount,
             MinFoldSize, DataPartitionType) ==
         std::tie(rhs.LearningRate, rhs.FoldLenMultiplier, rhs.PermutationBlockSize, rhs.IterationCount,
-                rhs.OverfittingDetector, rhs.ApproxOnFullHistory, rhs.BoostingType,
+                rhs.OverfittingDetector, rhs.ApproxOnFullHistory, rhs.SinglePrecisionFoldApproxes, rhs.BoostingType,
                 rhs.PermutationCount, rhs.MinFoldSize, rhs.DataPartitionType);
 }
 
@@ -31,6 +31,8 @@ namespace NCatboostOptions {
         TOption<TOverfittingDetectorOptions> OverfittingDetector;
         TOption<EBoostingType> BoostingType;
         TCpuOnlyOption<bool> ApproxOnFullHistory;
+        // keep approxes of learning folds in float between iterations to reduce memory usage
+        TCpuOnlyOption<bool> SinglePrecisionFoldApproxes;
 
         TGpuOnlyOption<ui32> MinFoldSize;
         TGpuOnlyOption<EDataPartitionType> DataPartitionType;
@@ -8,6 +8,7 @@ NCatboostOptions::TDataProcessingOptions::TDataProcessingOptions(ETaskType type)
       , AllowConstLabel("allow_const_label", false)
       , FloatFeaturesBinarization("float_features_binarization", TBinarizationOptions(
             EBorderSelectionType::GreedyLogSum, type == ETaskType::GPU ? 128 : 254, ENanMode::Min))
+      , UseQuantileSketchForBorders("use_quantile_sketch_for_borders", false)
       , ClassesCount("classes_count", 0)
       , ClassWeights("class_weights", TVector<float>())
       , ClassNames("class_names", TVector<TString>())
@@ -17,19 +18,19 @@ NCatboostOptions::TDataProcessingOptions::TDataProcessingOptions(ETaskType type)
 }
 
 void NCatboostOptions::TDataProcessingOptions::Load(const NJson::TJsonValue& options) {
-    CheckedLoad(options, &IgnoredFeatures, &HasTimeFlag, &AllowConstLabel, &FloatFeaturesBinarization, &ClassesCount, &ClassWeights, &ClassNames, &GpuCatFeaturesStorage);
+    CheckedLoad(options, &IgnoredFeatures, &HasTimeFlag, &AllowConstLabel, &FloatFeaturesBinarization, &UseQuantileSketchForBorders, &ClassesCount, &ClassWeights, &ClassNames, &GpuCatFeaturesStorage);
     CB_ENSURE(FloatFeaturesBinarization->BorderCount <= GetMaxBinCount(), "Error: catboost doesn't support binarization with >= 256 levels");
 }
 
 void NCatboostOptions::TDataProcessingOptions::Save(NJson::TJsonValue* options) const {
-    SaveFields(options, IgnoredFeatures, HasTimeFlag, AllowConstLabel, FloatFeaturesBinarization, ClassesCount, ClassWeights, ClassNames, GpuCatFeaturesStorage);
+    SaveFields(options, IgnoredFeatures, HasTimeFlag, AllowConstLabel, FloatFeaturesBinarization, UseQuantileSketchForBorders, ClassesCount, ClassWeights, ClassNames, GpuCatFeaturesStorage);
 }
 
 bool NCatboostOptions::TDataProcessingOptions::operator==(const TDataProcessingOptions& rhs) const {
-    return std::tie(IgnoredFeatures, HasTimeFlag, AllowConstLabel, FloatFeaturesBinarization, ClassesCount, ClassWeights,
-            ClassNames, GpuCatFeaturesStorage) ==
-        std::tie(rhs.IgnoredFeatures, rhs.HasTimeFlag, rhs.AllowConstLabel, rhs.FloatFeaturesBinarization, rhs.ClassesCount,
-                rhs.ClassWeights, rhs.ClassNames, rhs.GpuCatFeaturesStorage);
+    return std::tie(IgnoredFeatures, HasTimeFlag, AllowConstLabel, FloatFeaturesBinarization, UseQuantileSketchForBorders,
+            ClassesCount, ClassWeights, ClassNames, GpuCatFeaturesStorage) ==
+        std::tie(rhs.IgnoredFeatures, rhs.HasTimeFlag, rhs.AllowConstLabel, rhs.FloatFeaturesBinarization,
+                rhs.UseQuantileSketchForBorders, rhs.ClassesCount, rhs.ClassWeights, rhs.ClassNames, rhs.GpuCatFeaturesStorage);
 }
 
 bool NCatboostOptions::TDataProcessingOptions::operator!=(const TDataProcessingOptions& rhs) const {
@@ -29,6 +29,7 @@ namespace NCatboostOptions {
         TOption<bool> HasTimeFlag;
         TOption<bool> AllowConstLabel;
         TOption<TBinarizationOptions> FloatFeaturesBinarization;
+        TOption<bool> UseQuantileSketchForBorders;
         TOption<ui32> ClassesCount;
         TOption<TVector<float>> ClassWeights;
         TOption<TVector<TString>> ClassNames;
@@ -259,6 +259,7 @@ bool AreZeroWeightsAfterBootstrap(EBootstrapType type) {
     switch (type) {
         case EBootstrapType::Bernoulli:
         case EBootstrapType::Poisson:
+        case EBootstrapType::MVS:
             return true;
         default:
             return false;
@@ -75,7 +75,8 @@ enum class EBootstrapType {
     Poisson,
     Bayesian,
     Bernoulli,
-    No
+    No,
+    MVS // gradient-based importance sampling, keeps objects with large gradients (CPU only)
 };
 
 enum class EGrowingPolicy {
@@ -195,7 +196,8 @@ enum class EFstrType {
     InternalFeatureImportance,
     Interaction,
     InternalInteraction,
-    ShapValues
+    ShapValues,
+    LossFunctionChange
 };
 
 enum class EObservationsToBootstrap {
@@ -224,6 +224,7 @@ void NCatboostOptions::PlainJsonToOptions(
     CopyOption(plainOptions, "learning_rate", &boostingOptionsRef, &seenKeys);
     CopyOption(plainOptions, "fold_len_multiplier", &boostingOptionsRef, &seenKeys);
     CopyOption(plainOptions, "approx_on_full_history", &boostingOptionsRef, &seenKeys);
+    CopyOption(plainOptions, "single_precision_fold_approxes", &boostingOptionsRef, &seenKeys);
     CopyOption(plainOptions, "fold_permutation_block", &boostingOptionsRef, &seenKeys);
     CopyOption(plainOptions, "min_fold_size", &boostingOptionsRef, &seenKeys);
     CopyOption(plainOptions, "permutation_count", &boostingOptionsRef, &seenKeys);
@@ -303,6 +304,7 @@ void NCatboostOptions::PlainJsonToOptions(
     CopyOption(plainOptions, "class_names", &dataProcessingOptions, &seenKeys);
     CopyOption(plainOptions, "class_weights", &dataProcessingOptions, &seenKeys);
     CopyOption(plainOptions, "gpu_cat_features_storage", &dataProcessingOptions, &seenKeys);
+    CopyOption(plainOptions, "use_quantile_sketch_for_borders", &dataProcessingOptions, &seenKeys);
 
     auto& floatFeaturesBinarization = dataProcessingOptions["float_features_binarization"];
     floatFeaturesBinarization.SetType(NJson::JSON_MAP);
@@ -16,15 +16,20 @@
 
 #include <util/generic/cast.h>
 #include <util/generic/deque.h>
+#include <util/generic/hash.h>
+#include <util/generic/maybe.h>
 #include <util/generic/mapfindptr.h>
 #include <util/generic/scope.h>
 #include <util/generic/vector.h>
+#include <util/generic/xrange.h>
 #include <util/generic/ylimits.h>
 #include <util/system/madvise.h>
 #include <util/system/types.h>
 #include <util/system/unaligned_mem.h>
 
+using NCB::DecompressQuants;
 using NCB::EObjectsOrder;
+using NCB::HasCompressedQuants;
 using NCB::IQuantizedFeaturesDataVisitor;
 using NCB::IQuantizedFeaturesDatasetLoader;
 using NCB::QuantizationSchemaFromProto;
@@ -47,25 +52,36 @@ namespace {
         void Do(IQuantizedFeaturesDataVisitor* visitor) override;
 
     private:
+        // returns Nothing() if chunk is not needed
+        TMaybe<EColumn> GetChunkColumnType(ui32 columnIdx, ui32 localIdx) const;
+
         void AddChunk(
             const TQuantizedPool::TChunkDescription& chunk,
+            TMaybeOwningConstArrayHolder<ui8> quants,
             EColumn columnType,
             const size_t* flatFeatureIdx,
             const size_t* baselineIdx,
             IQuantizedFeaturesDataVisitor* visitor) const;
 
         static TLoadQuantizedPoolParameters GetLoadParameters() {
-            return {/*LockMemory*/ false, /*Precharge*/ false};
+            // compressed chunks are decompressed in parallel in `Do`
+            return {/*LockMemory*/ false, /*Precharge*/ false, /*DecompressChunks*/ false};
         }
 
+    private:
+        // max total size of compressed chunks decompressed in parallel at once
+        static constexpr size_t DECOMPRESSION_BATCH_SIZE = 64 << 20;
+
     private:
         ui32 ObjectCount;
         TVector<bool> IsFeatureIgnored;
+        THashMap<size_t, size_t> ColumnIdxToFlatIdx;
         TQuantizedPool QuantizedPool;
         TPathWithScheme PairsPath;
         TPathWithScheme GroupWeightsPath;
         TDataMetaInfo DataMetaInfo;
         EObjectsOrder ObjectsOrder;
+        NPar::TLocalExecutor* LocalExecutor;
     };
 }
 
@@ -75,6 +91,7 @@ TCBQuantizedDataLoader::TCBQuantizedDataLoader(TDatasetLoaderPullArgs&& args)
     , PairsPath(args.CommonArgs.PairsFilePath)
     , GroupWeightsPath(args.CommonArgs.GroupWeightsFilePath)
     , ObjectsOrder(args.CommonArgs.ObjectsOrder)
+    , LocalExecutor(args.CommonArgs.LocalExecutor)
 {
     CB_ENSURE(QuantizedPool.DocumentCount > 0, "Pool is empty");
     CB_ENSURE(
@@ -212,23 +229,54 @@ static void AssignUnaligned(const TConstArrayRef<ui8> unaligned, TVector<U>* dst
     }
 }
 
+TMaybe<EColumn> TCBQuantizedDataLoader::GetChunkColumnType(const ui32 columnIdx, const ui32 localIdx) const {
+    const auto isStringColumn = QuantizedPool.HasStringColumns &&
+        (localIdx == QuantizedPool.StringDocIdLocalIndex ||
+         localIdx == QuantizedPool.StringGroupIdLocalIndex ||
+         localIdx == QuantizedPool.StringSubgroupIdLocalIndex);
+    if (isStringColumn) {
+        // Ignore string columns, they are only needed for fancy output for evaluation.
+        return Nothing();
+    }
+
+    const auto columnType = QuantizedPool.ColumnTypes[localIdx];
+    if (columnType == EColumn::DocId) {
+        // Skip DocId columns presented in old pools.
+        return Nothing();
+    }
+
+    CB_ENSURE(
+        columnType == EColumn::Num || columnType == EColumn::Baseline ||
+        columnType == EColumn::Label || columnType == EColumn::Categ ||
+        columnType == EColumn::Weight || columnType == EColumn::GroupWeight ||
+        columnType == EColumn::GroupId || columnType == EColumn::SubgroupId,
+        "Expected Num, Baseline, Label, Categ, Weight, GroupWeight, GroupId, or Subgroupid; got "
+        LabeledOutput(columnType, columnIdx));
+
+    const auto* const flatFeatureIdx = ColumnIdxToFlatIdx.FindPtr(columnIdx);
+    if (flatFeatureIdx && IsFeatureIgnored[*flatFeatureIdx]) {
+        return Nothing();
+    }
+
+    return columnType;
+}
+
 void TCBQuantizedDataLoader::AddChunk(
     const TQuantizedPool::TChunkDescription& chunk,
+    TMaybeOwningConstArrayHolder<ui8> quantsHolder,
     const EColumn columnType,
     const size_t* const flatFeatureIdx,
     const size_t* const baselineIdx,
     IQuantizedFeaturesDataVisitor* const visitor) const
 {
-    const auto quants = MakeArrayRef(
-        reinterpret_cast<const ui8*>(chunk.Chunk->Quants()->data()),
-        chunk.Chunk->Quants()->size());
+    const auto quants = *quantsHolder;
 
     switch (columnType) {
         case EColumn::Num: {
             visitor->AddFloatFeaturePart(
                 *flatFeatureIdx,
                 chunk.DocumentOffset,
-                TMaybeOwningConstArrayHolder<ui8>::CreateNonOwning(quants));
+                std::move(quantsHolder));
             break;
         } case EColumn::Label: {
             // TODO(akhropov): will be raw strings as was decided for new data formats for MLTOOLS-140.
@@ -277,47 +325,74 @@ void TCBQuantizedDataLoader::Do(IQuantizedFeaturesDataVisitor* visitor) {
         {},
         QuantizationSchemaFromProto(QuantizedPool.QuantizationSchema));
 
-    const auto columnIdxToFlatIdx = GetColumnIndexToFlatIndexMap(QuantizedPool);
+    ColumnIdxToFlatIdx = GetColumnIndexToFlatIndexMap(QuantizedPool);
     const auto columnIdxToBaselineIdx = GetColumnIndexToBaselineIndexMap(QuantizedPool);
     const auto chunkRefs = GatherAndSortChunks(QuantizedPool);
 
+    TVector<TMaybe<EColumn>> chunkColumnTypes;
+    chunkColumnTypes.reserve(chunkRefs.size());
+    for (const auto& chunkRef : chunkRefs) {
+        chunkColumnTypes.push_back(GetChunkColumnType(chunkRef.ColumnIndex, chunkRef.LocalIndex));
+    }
+
     TSequantialChunkEvictor evictor(1ULL << 24);
-    for (const auto chunkRef : chunkRefs) {
-        evictor.Push(chunkRef);
-        Y_DEFER { evictor.MaybeEvict(); };
-
-        const auto columnIdx = chunkRef.ColumnIndex;
-        const auto localIdx = chunkRef.LocalIndex;
-        const auto isStringColumn = QuantizedPool.HasStringColumns &&
-            (localIdx == QuantizedPool.StringDocIdLocalIndex ||
-             localIdx == QuantizedPool.StringGroupIdLocalIndex ||
-             localIdx == QuantizedPool.StringSubgroupIdLocalIndex);
-        if (isStringColumn) {
-            // Ignore string columns, they are only needed for fancy output for evaluation.
-            continue;
+    TVector<TVector<ui8>> decompressedQuants;
+    for (size_t batchBegin = 0; batchBegin < chunkRefs.size();) {
+        // Compressed chunks are decompressed in parallel in batches (in file order), uncompressed
+        // chunks are passed to visitor as is.
+        size_t batchEnd = batchBegin;
+        size_t batchCompressedSize = 0;
+        while (batchEnd < chunkRefs.size() && (batchEnd == batchBegin || batchCompressedSize < DECOMPRESSION_BATCH_SIZE)) {
+            const auto& chunk = *chunkRefs[batchEnd].Description->Chunk;
+            if (chunkColumnTypes[batchEnd] && HasCompressedQuants(chunk)) {
+                batchCompressedSize += chunk.Quants()->size();
+            }
+            ++batchEnd;
         }
 
-        const auto columnType = QuantizedPool.ColumnTypes[localIdx];
-        if (columnType == EColumn::DocId) {
-            // Skip DocId columns presented in old pools.
-            continue;
+        decompressedQuants.resize(batchEnd - batchBegin);
+        if (batchCompressedSize) {
+            LocalExecutor->ExecRangeWithThrow(
+                [&] (int chunkIdxInBatch) {
+                    const auto chunkIdx = batchBegin + chunkIdxInBatch;
+                    const auto& chunk = *chunkRefs[chunkIdx].Description->Chunk;
+                    if (chunkColumnTypes[chunkIdx] && HasCompressedQuants(chunk)) {
+                        DecompressQuants(chunk, &decompressedQuants[chunkIdxInBatch]);
+                    }
+                },
+                0,
+                SafeIntegerCast<int>(batchEnd - batchBegin),
+                NPar::TLocalExecutor::WAIT_COMPLETE);
         }
 
-        CB_ENSURE(
-            columnType == EColumn::Num || columnType == EColumn::Baseline ||
-            columnType == EColumn::Label || columnType == EColumn::Categ ||
-            columnType == EColumn::Weight || columnType == EColumn::GroupWeight ||
-            columnType == EColumn::GroupId || columnType == EColumn::SubgroupId,
-            "Expected Num, Baseline, Label, Categ, Weight, GroupWeight, GroupId, or Subgroupid; got "
-            LabeledOutput(columnType, columnIdx));
-
-        const auto* const flatFeatureIdx = columnIdxToFlatIdx.FindPtr(columnIdx);
-        if (flatFeatureIdx && IsFeatureIgnored[*flatFeatureIdx]) {
-            continue;
+        for (auto chunkIdx : xrange(batchBegin, batchEnd)) {
+            const auto& chunkRef = chunkRefs[chunkIdx];
+            evictor.Push(chunkRef);
+            Y_DEFER { evictor.MaybeEvict(); };
+
+            if (!chunkColumnTypes[chunkIdx]) {
+                continue;
+            }
+
+            const auto& description = *chunkRef.Description;
+            auto quants = HasCompressedQuants(*description.Chunk)
+                ? TMaybeOwningConstArrayHolder<ui8>::CreateOwning(
+                    std::move(decompressedQuants[chunkIdx - batchBegin]))
+                : TMaybeOwningConstArrayHolder<ui8>::CreateNonOwning(
+                    MakeArrayRef(
+                        reinterpret_cast<const ui8*>(description.Chunk->Quants()->data()),
+                        description.Chunk->Quants()->size()));
+
+            AddChunk(
+                description,
+                std::move(quants),
+                *chunkColumnTypes[chunkIdx],
+                ColumnIdxToFlatIdx.FindPtr(chunkRef.ColumnIndex),
+                columnIdxToBaselineIdx.FindPtr(chunkRef.ColumnIndex),
+                visitor);
         }
 
-        const auto* const baselineIdx = columnIdxToBaselineIdx.FindPtr(columnIdx);
-        AddChunk(*chunkRef.Description, columnType, flatFeatureIdx, baselineIdx, visitor);
+        batchBegin = batchEnd;
     }
 
     evictor.MaybeEvict(true);
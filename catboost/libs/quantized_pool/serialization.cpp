@@ -10,11 +10,14 @@
 
 #include <contrib/libs/flatbuffers/include/flatbuffers/flatbuffers.h>
 
+#include <library/blockcodecs/codecs.h>
+
 #include <util/digest/numeric.h>
 #include <util/folder/path.h>
 #include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
 #include <util/generic/array_size.h>
+#include <util/generic/cast.h>
 #include <util/generic/deque.h>
 #include <util/generic/strbuf.h>
 #include <util/generic/string.h>
@@ -40,7 +43,8 @@ static const size_t MagicSize = Y_ARRAY_SIZE(Magic);  // yes, with terminating z
 static const char MagicEnd[] = "CatboostQuantizedPoolEnd";
 static const size_t MagicEndSize = Y_ARRAY_SIZE(MagicEnd);  // yes, with terminating zero
 static const ui32 Version = 1;
-static const ui32 VersionHash = IntHash(Version);
+// same as `Version` but chunks may have `QuantsCodec`
+static const ui32 CompressedChunksVersion = 2;
 
 template <typename T>
 static TDeque<ui32> CollectAndSortKeys(const T& m) {
@@ -94,51 +98,37 @@ static void SkipPadding(const ui64 alignment, TCountingInput* const input) {
     CB_ENSURE(bytesToSkip == bytesSkipped);
 }
 
-namespace {
-    struct TChunkInfo {
-        ui32 Size = 0;
-        ui64 Offset = 0;
-        ui32 DocumentOffset = 0;
-        ui32 DocumentsInChunkCount = 0;
-
-        TChunkInfo() = default;
-        TChunkInfo(ui32 size, ui64 offset, ui32 documentOffset, ui32 documentsInChunkCount)
-            : Size(size)
-            , Offset(offset)
-            , DocumentOffset(documentOffset)
-            , DocumentsInChunkCount(documentsInChunkCount) {
-        }
-    };
-}
-
 static void WriteChunk(
+    const ui32 columnIndex,
     const NCB::TQuantizedPool::TChunkDescription& chunk,
-    TCountingOutput* const output,
-    TDeque<TChunkInfo>* const chunkInfos,
-    flatbuffers::FlatBufferBuilder* const builder) {
+    flatbuffers::FlatBufferBuilder* const builder,
+    NCB::TQuantizedPoolFileWriter* const writer) {
 
     builder->Clear();
 
     const auto quantsOffset = builder->CreateVector(
         chunk.Chunk->Quants()->data(),
         chunk.Chunk->Quants()->size());
+    const auto quantsCodecOffset = NCB::HasCompressedQuants(*chunk.Chunk)
+        ? builder->CreateString(chunk.Chunk->QuantsCodec())
+        : flatbuffers::Offset<flatbuffers::String>();
     NCB::NIdl::TQuantizedFeatureChunkBuilder chunkBuilder(*builder);
     chunkBuilder.add_BitsPerDocument(chunk.Chunk->BitsPerDocument());
     chunkBuilder.add_Quants(quantsOffset);
+    chunkBuilder.add_QuantsCodec(quantsCodecOffset);
     builder->Finish(chunkBuilder.Finish());
 
-    AddPadding(16, output);
-
-    const auto chunkOffset = output->Counter();
-    output->Write(builder->GetBufferPointer(), builder->GetSize());
-
-    chunkInfos->emplace_back(builder->GetSize(), chunkOffset, chunk.DocumentOffset, chunk.DocumentCount);
+    writer->AddChunk(
+        columnIndex,
+        chunk.DocumentOffset,
+        chunk.DocumentCount,
+        MakeArrayRef(builder->GetBufferPointer(), builder->GetSize()));
 }
 
-static void WriteHeader(TCountingOutput* const output) {
+static void WriteHeader(const ui32 version, TCountingOutput* const output) {
     output->Write(Magic, MagicSize);
-    WriteLittleEndian(Version, output);
-    WriteLittleEndian(VersionHash, output);
+    WriteLittleEndian(version, output);
+    WriteLittleEndian(IntHash(version), output);
 
     const ui32 metainfoSize = 0;
     WriteLittleEndian(metainfoSize, output);
@@ -148,7 +138,7 @@ static void WriteHeader(TCountingOutput* const output) {
     // we may add some metainfo here
 }
 
-static TPoolMetainfo MakePoolMetainfo(
+TPoolMetainfo NCB::MakePoolMetainfo(
     const THashMap<size_t, size_t>& columnIndexToLocalIndex,
     const TConstArrayRef<EColumn> columnTypes,
     const TConstArrayRef<TString> columnNames,
@@ -198,9 +188,11 @@ static TPoolMetainfo MakePoolMetainfo(
             case EColumn::Sparse:
                 pbColumnType = NCB::NIdl::CT_SPARSE;
                 break;
+            case EColumn::Auxiliary:
+                pbColumnType = NCB::NIdl::CT_AUXILIARY;
+                break;
             case EColumn::Timestamp:
             case EColumn::Prediction:
-            case EColumn::Auxiliary:
                 ythrow TCatBoostException() << "unexpected column type in quantized pool";
         }
 
@@ -222,67 +214,109 @@ static TPoolMetainfo MakePoolMetainfo(
     return metainfo;
 }
 
-static void WriteAsOneFile(const NCB::TQuantizedPool& pool, IOutputStream* slave) {
-    TCountingOutput output(slave);
+NCB::TQuantizedPoolFileWriter::TQuantizedPoolFileWriter(
+    IOutputStream* const output,
+    const bool hasCompressedChunks)
+    : Output(MakeHolder<TCountingOutput>(output)) {
+
+    WriteHeader(hasCompressedChunks ? CompressedChunksVersion : Version, Output.Get());
+    ChunksOffset = Output->Counter();
+}
+
+NCB::TQuantizedPoolFileWriter::~TQuantizedPoolFileWriter() = default;
+
+void NCB::TQuantizedPoolFileWriter::AddColumn(const ui32 columnIndex) {
+    ColumnIndexToChunkInfos[columnIndex];
+}
+
+void NCB::TQuantizedPoolFileWriter::AddChunk(
+    const ui32 columnIndex,
+    const ui32 documentOffset,
+    const ui32 documentCount,
+    const TConstArrayRef<ui8> chunk) {
+
+    CB_ENSURE_INTERNAL(!Finished, "Attempt to add chunk to finished quantized pool");
+
+    AddPadding(16, Output.Get());
 
-    WriteHeader(&output);
+    TChunkInfo chunkInfo;
+    chunkInfo.Size = SafeIntegerCast<ui32>(chunk.size());
+    chunkInfo.Offset = Output->Counter();
+    chunkInfo.DocumentOffset = documentOffset;
+    chunkInfo.DocumentsInChunkCount = documentCount;
+    Output->Write(chunk.data(), chunk.size());
 
-    const auto chunksOffset = output.Counter();
+    ColumnIndexToChunkInfos[columnIndex].push_back(chunkInfo);
+}
+
+void NCB::TQuantizedPoolFileWriter::Finish(
+    const TPoolMetainfo& poolMetainfo,
+    const TPoolQuantizationSchema& quantizationSchema) {
+
+    CB_ENSURE_INTERNAL(!Finished, "Quantized pool is already finished");
+    Finished = true;
+
+    auto* const output = Output.Get();
+
+    const ui64 poolMetainfoSizeOffset = output->Counter();
+    const ui32 poolMetainfoSize = poolMetainfo.ByteSizeLong();
+    WriteLittleEndian(poolMetainfoSize, output);
+    poolMetainfo.SerializeToStream(output);
+
+    const ui64 quantizationSchemaSizeOffset = output->Counter();
+    const ui32 quantizationSchemaSize = quantizationSchema.ByteSizeLong();
+    WriteLittleEndian(quantizationSchemaSize, output);
+    quantizationSchema.SerializeToStream(output);
+
+    const ui64 featureCountOffset = output->Counter();
+    const ui32 featureCount = ColumnIndexToChunkInfos.size();
+    WriteLittleEndian(featureCount, output);
+    for (const auto& [trueFeatureIndex, chunkInfos] : ColumnIndexToChunkInfos) {
+        const ui32 chunkCount = chunkInfos.size();
+
+        WriteLittleEndian(trueFeatureIndex, output);
+        WriteLittleEndian(chunkCount, output);
+        for (const auto& chunkInfo : chunkInfos) {
+            WriteLittleEndian(chunkInfo.Size, output);
+            WriteLittleEndian(chunkInfo.Offset, output);
+            WriteLittleEndian(chunkInfo.DocumentOffset, output);
+            WriteLittleEndian(chunkInfo.DocumentsInChunkCount, output);
+        }
+    }
+
+    WriteLittleEndian(ChunksOffset, output);
+    WriteLittleEndian(poolMetainfoSizeOffset, output);
+    WriteLittleEndian(quantizationSchemaSizeOffset, output);
+    WriteLittleEndian(featureCountOffset, output);
+    output->Write(MagicEnd, MagicEndSize);
+}
+
+static void WriteAsOneFile(const NCB::TQuantizedPool& pool, IOutputStream* slave) {
+    const bool hasCompressedChunks = AnyOf(pool.Chunks, [](const auto& chunks) {
+        return AnyOf(chunks, [](const auto& chunk) { return NCB::HasCompressedQuants(*chunk.Chunk); });
+    });
+    NCB::TQuantizedPoolFileWriter writer(slave, hasCompressedChunks);
 
     const auto sortedTrueFeatureIndices = CollectAndSortKeys(pool.ColumnIndexToLocalIndex);
-    TDeque<TDeque<TChunkInfo>> perFeatureChunkInfos;
-    perFeatureChunkInfos.resize(pool.ColumnIndexToLocalIndex.size());
     {
         flatbuffers::FlatBufferBuilder builder;
         for (const auto trueFeatureIndex : sortedTrueFeatureIndices) {
             const auto localIndex = pool.ColumnIndexToLocalIndex.at(trueFeatureIndex);
-            auto* const chunkInfos = &perFeatureChunkInfos[localIndex];
+            writer.AddColumn(trueFeatureIndex);
             for (const auto& chunk : pool.Chunks[localIndex]) {
-                WriteChunk(chunk, &output, chunkInfos, &builder);
+                WriteChunk(trueFeatureIndex, chunk, &builder, &writer);
             }
         }
     }
 
-    const ui64 poolMetainfoSizeOffset = output.Counter();
-    {
-        const auto poolMetainfo = MakePoolMetainfo(
+    writer.Finish(
+        NCB::MakePoolMetainfo(
             pool.ColumnIndexToLocalIndex,
             pool.ColumnTypes,
             pool.ColumnNames,
             pool.DocumentCount,
-            pool.IgnoredColumnIndices);
-        const ui32 poolMetainfoSize = poolMetainfo.ByteSizeLong();
-        WriteLittleEndian(poolMetainfoSize, &output);
-        poolMetainfo.SerializeToStream(&output);
-    }
-
-    const ui64 quantizationSchemaSizeOffset = output.Counter();
-    const ui32 quantizationSchemaSize = pool.QuantizationSchema.ByteSizeLong();
-    WriteLittleEndian(quantizationSchemaSize, &output);
-    pool.QuantizationSchema.SerializeToStream(&output);
-
-    const ui64 featureCountOffset = output.Counter();
-    const ui32 featureCount = sortedTrueFeatureIndices.size();
-    WriteLittleEndian(featureCount, &output);
-    for (const ui32 trueFeatureIndex : sortedTrueFeatureIndices) {
-        const auto localIndex = pool.ColumnIndexToLocalIndex.at(trueFeatureIndex);
-        const ui32 chunkCount = perFeatureChunkInfos[localIndex].size();
-
-        WriteLittleEndian(trueFeatureIndex, &output);
-        WriteLittleEndian(chunkCount, &output);
-        for (const auto& chunkInfo : perFeatureChunkInfos[localIndex]) {
-            WriteLittleEndian(chunkInfo.Size, &output);
-            WriteLittleEndian(chunkInfo.Offset, &output);
-            WriteLittleEndian(chunkInfo.DocumentOffset, &output);
-            WriteLittleEndian(chunkInfo.DocumentsInChunkCount, &output);
-        }
-    }
-
-    WriteLittleEndian(chunksOffset, &output);
-    WriteLittleEndian(poolMetainfoSizeOffset, &output);
-    WriteLittleEndian(quantizationSchemaSizeOffset, &output);
-    WriteLittleEndian(featureCountOffset, &output);
-    output.Write(MagicEnd, MagicEndSize);
+            pool.IgnoredColumnIndices),
+        pool.QuantizationSchema);
 }
 
 void NCB::SaveQuantizedPool(const TQuantizedPool& pool, IOutputStream* const output) {
@@ -302,11 +336,13 @@ static void ReadHeader(TCountingInput* const input) {
 
     ui32 version;
     ReadLittleEndian(&version, input);
-    CB_ENSURE(Version == version);
+    CB_ENSURE(
+        Version == version || CompressedChunksVersion == version,
+        "Unsupported quantized pool format version " << version);
 
     ui32 versionHash;
     ReadLittleEndian(&versionHash, input);
-    CB_ENSURE(VersionHash == versionHash);
+    CB_ENSURE(IntHash(version) == versionHash);
 
     ui32 metainfoSize;
     ReadLittleEndian(&metainfoSize, input);
@@ -574,6 +610,50 @@ static void CollectChunks(const TConstArrayRef<char> blob, NCB::TQuantizedPool&
     }
 }
 
+bool NCB::HasCompressedQuants(const NIdl::TQuantizedFeatureChunk& chunk) {
+    return chunk.QuantsCodec() && chunk.QuantsCodec()->size();
+}
+
+void NCB::DecompressQuants(const NIdl::TQuantizedFeatureChunk& chunk, TVector<ui8>* const quants) {
+    const TStringBuf compressed{
+        reinterpret_cast<const char*>(chunk.Quants()->data()),
+        chunk.Quants()->size()};
+    if (!HasCompressedQuants(chunk)) {
+        quants->assign(compressed.begin(), compressed.end());
+        return;
+    }
+
+    const auto* const codec = NBlockCodecs::Codec(TStringBuf(
+        chunk.QuantsCodec()->data(),
+        chunk.QuantsCodec()->size()));
+    quants->yresize(codec->DecompressedLength(compressed));
+    const auto decompressedSize = codec->Decompress(compressed, quants->data());
+    CB_ENSURE(decompressedSize == quants->size(), "Corrupted compressed chunk in quantized pool");
+}
+
+static void DecompressChunks(NCB::TQuantizedPool* const pool) {
+    flatbuffers::FlatBufferBuilder builder;
+    TVector<ui8> quants;
+    for (auto& chunks : pool->Chunks) {
+        for (auto& chunk : chunks) {
+            if (!NCB::HasCompressedQuants(*chunk.Chunk)) {
+                continue;
+            }
+
+            NCB::DecompressQuants(*chunk.Chunk, &quants);
+
+            builder.Clear();
+            builder.Finish(NCB::NIdl::CreateTQuantizedFeatureChunk(
+                builder,
+                chunk.Chunk->BitsPerDocument(),
+                builder.CreateVector(quants.data(), quants.size())));
+            pool->Blobs.push_back(TBlob::Copy(builder.GetBufferPointer(), builder.GetSize()));
+            chunk.Chunk = flatbuffers::GetRoot<NCB::NIdl::TQuantizedFeatureChunk>(
+                pool->Blobs.back().AsCharPtr());
+        }
+    }
+}
+
 NCB::TQuantizedPool NCB::LoadQuantizedPool(
     const TStringBuf path,
     const TLoadQuantizedPoolParameters& params) {
@@ -592,6 +672,10 @@ NCB::TQuantizedPool NCB::LoadQuantizedPool(
     ValidatePoolPart(blobView);
     CollectChunks(blobView, pool);
 
+    if (params.DecompressChunks) {
+        DecompressChunks(&pool);
+    }
+
     return pool;
 }
 
@@ -1,7 +1,15 @@
 #pragma once
 
+#include <catboost/libs/column_description/column.h>
+
 #include <util/generic/fwd.h>
+#include <util/generic/map.h>
+#include <util/generic/ptr.h>
+#include <util/generic/vector.h>
 #include <util/stream/fwd.h>
+#include <util/system/types.h>
+
+class TCountingOutput;
 
 namespace NCB {
     struct TQuantizedPool;
@@ -10,17 +18,73 @@ namespace NCB {
     namespace NIdl {
         class TPoolMetainfo;
         class TPoolQuantizationSchema;
+        struct TQuantizedFeatureChunk;
     }
 }
 
 namespace NCB {
     void SaveQuantizedPool(const TQuantizedPool& pool, IOutputStream* output);
 
+    NIdl::TPoolMetainfo MakePoolMetainfo(
+        const THashMap<size_t, size_t>& columnIndexToLocalIndex,
+        TConstArrayRef<EColumn> columnTypes,
+        TConstArrayRef<TString> columnNames,
+        size_t documentCount,
+        TConstArrayRef<size_t> ignoredColumnIndices);
+
+    // Writes quantized pool incrementally: chunks are appended to `output` (16-byte aligned) as
+    // soon as they are added, only their locations are kept in memory until `Finish` writes the
+    // chunk table. Chunks of different columns may be interleaved in any order.
+    class TQuantizedPoolFileWriter {
+    public:
+        struct TChunkInfo {
+            ui32 Size = 0;
+            ui64 Offset = 0;
+            ui32 DocumentOffset = 0;
+            ui32 DocumentsInChunkCount = 0;
+        };
+
+    public:
+        // writes header, `hasCompressedChunks` has to be set if any of chunks will have `QuantsCodec`
+        explicit TQuantizedPoolFileWriter(IOutputStream* output, bool hasCompressedChunks = false);
+        ~TQuantizedPoolFileWriter();
+
+        // Make column present in chunk table even if it has no chunks
+        void AddColumn(ui32 columnIndex);
+
+        // `chunk` is a serialized `NIdl::TQuantizedFeatureChunk`
+        void AddChunk(
+            ui32 columnIndex,
+            ui32 documentOffset,
+            ui32 documentCount,
+            TConstArrayRef<ui8> chunk);
+
+        // writes pool metainfo, quantization schema and chunk table, no chunks can be added after it
+        void Finish(
+            const NIdl::TPoolMetainfo& poolMetainfo,
+            const NIdl::TPoolQuantizationSchema& quantizationSchema);
+
+    private:
+        THolder<TCountingOutput> Output;
+        ui64 ChunksOffset = 0;
+        TMap<ui32, TVector<TChunkInfo>> ColumnIndexToChunkInfos;
+        bool Finished = false;
+    };
+
     struct TLoadQuantizedPoolParameters {
         bool LockMemory = true;
         bool Precharge = true;
+
+        // Replace compressed chunks with decompressed ones, otherwise it's up to the caller to
+        // decompress them (see `DecompressQuants`).
+        bool DecompressChunks = true;
     };
 
+    bool HasCompressedQuants(const NIdl::TQuantizedFeatureChunk& chunk);
+
+    // Decompressed `chunk.Quants()` if they are compressed, `chunk.Quants()` as is otherwise
+    void DecompressQuants(const NIdl::TQuantizedFeatureChunk& chunk, TVector<ui8>* quants);
+
     // Load quantized pool saved by `SaveQuantizedPool` from file.
     TQuantizedPool LoadQuantizedPool(TStringBuf path, const TLoadQuantizedPoolParameters& params);
 
@@ -0,0 +1,449 @@
+#include "streaming_writer.h"
+
+#include <catboost/idl/pool/flat/quantized_chunk_t.fbs.h>
+#include <catboost/idl/pool/proto/metainfo.pb.h>
+#include <catboost/idl/pool/proto/quantization_schema.pb.h>
+#include <catboost/libs/column_description/cd_parser.h>
+#include <catboost/libs/data_new/loader.h>
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/logging/logging.h>
+#include <catboost/libs/quantization_schema/quantize.h>
+#include <catboost/libs/quantization_schema/serialization.h>
+
+#include <contrib/libs/flatbuffers/include/flatbuffers/flatbuffers.h>
+
+#include <library/blockcodecs/codecs.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/buffer.h>
+#include <util/generic/cast.h>
+#include <util/generic/hash.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ylimits.h>
+#include <util/string/cast.h>
+
+#include <functional>
+
+
+namespace NCB {
+
+    // codec == nullptr means no compression
+    template <class T>
+    static void BuildChunk(
+        TConstArrayRef<T> values,
+        NIdl::EBitsPerDocumentFeature bitsPerDocument,
+        const NBlockCodecs::ICodec* codec,
+        flatbuffers::FlatBufferBuilder* builder
+    ) {
+        const TStringBuf quants(reinterpret_cast<const char*>(values.data()), sizeof(T) * values.size());
+        if (!codec) {
+            builder->Finish(
+                NIdl::CreateTQuantizedFeatureChunk(
+                    *builder,
+                    bitsPerDocument,
+                    builder->CreateVector(reinterpret_cast<const ui8*>(quants.data()), quants.size())
+                )
+            );
+            return;
+        }
+
+        TBuffer compressedQuants;
+        codec->Encode(quants, compressedQuants);
+        const auto quantsOffset = builder->CreateVector(
+            reinterpret_cast<const ui8*>(compressedQuants.Data()),
+            compressedQuants.Size()
+        );
+        const auto quantsCodecOffset = builder->CreateString(codec->Name().data(), codec->Name().size());
+        builder->Finish(
+            NIdl::CreateTQuantizedFeatureChunk(*builder, bitsPerDocument, quantsOffset, quantsCodecOffset)
+        );
+    }
+
+
+    TQuantizedPoolStreamingWriter::TQuantizedPoolStreamingWriter(
+        IOutputStream* output,
+        const TPoolQuantizationSchema& quantizationSchema,
+        NPar::TLocalExecutor* localExecutor,
+        ui32 documentsPerChunk,
+        TStringBuf chunksCodecName
+    )
+        : ChunksCodecName(chunksCodecName)
+        , FileWriter(output, /*hasCompressedChunks*/ !ChunksCodecName.empty())
+        , QuantizationSchema(quantizationSchema)
+        , LocalExecutor(localExecutor)
+        , DocumentsPerChunk(documentsPerChunk)
+    {
+        CB_ENSURE(DocumentsPerChunk > 0, "Chunk size must be positive");
+        if (ChunksCodecName) {
+            // throws if there's no such codec
+            NBlockCodecs::Codec(ChunksCodecName);
+        }
+    }
+
+    void TQuantizedPoolStreamingWriter::Start(
+        bool inBlock,
+        const TDataMetaInfo& metaInfo,
+        ui32 objectCount,
+        EObjectsOrder objectsOrder,
+        TVector<TIntrusivePtr<IResourceHolder>> resourceHolders
+    ) {
+        Y_UNUSED(objectCount, objectsOrder, resourceHolders);
+
+        CB_ENSURE(!InProcess, "Attempt to start new processing without finishing the last");
+        CB_ENSURE(!inBlock, "Block processing is not supported by quantized pool streaming writer");
+        CB_ENSURE(metaInfo.ColumnsInfo.Defined(), "Quantized pool can be written only for data with columns info");
+        InProcess = true;
+
+        MetaInfo = metaInfo;
+
+        const auto& featuresLayout = *MetaInfo.FeaturesLayout;
+        const auto featuresMetaInfo = featuresLayout.GetExternalFeaturesMetaInfo();
+        const auto& columns = MetaInfo.ColumnsInfo->Columns;
+
+        ui32 flatFeatureIdx = 0;
+        for (auto columnIdx : xrange<ui32>(columns.size())) {
+            switch (columns[columnIdx].Type) {
+                case EColumn::Num:
+                    FloatFeatureColumnIndices.push_back(columnIdx);
+                    ++flatFeatureIdx;
+                    break;
+                case EColumn::Categ:
+                    CB_ENSURE(
+                        !featuresMetaInfo[flatFeatureIdx].IsAvailable,
+                        "Categorical features are not supported by quantized pools yet, feature "
+                        << flatFeatureIdx << " has to be ignored"
+                    );
+                    ++flatFeatureIdx;
+                    break;
+                case EColumn::Sparse:
+                    ythrow TCatBoostException() << "Sparse columns are not supported by quantized pools";
+                case EColumn::Label:
+                    TargetColumnIndex = columnIdx;
+                    break;
+                case EColumn::Baseline:
+                    BaselineColumnIndices.push_back(columnIdx);
+                    break;
+                case EColumn::Weight:
+                    WeightColumnIndex = columnIdx;
+                    break;
+                case EColumn::GroupWeight:
+                    GroupWeightColumnIndex = columnIdx;
+                    break;
+                case EColumn::GroupId:
+                    GroupIdColumnIndex = columnIdx;
+                    break;
+                case EColumn::SubgroupId:
+                    SubgroupIdColumnIndex = columnIdx;
+                    break;
+                case EColumn::Timestamp:
+                    CATBOOST_WARNING_LOG << "Timestamp column " << columnIdx
+                        << " is not supported by quantized pools and will be skipped" << Endl;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        const ui32 floatFeatureCount = featuresLayout.GetFloatFeatureCount();
+        FloatFeatureSchemaIndices.assign(floatFeatureCount, Nothing());
+        for (auto floatFeatureIdx : xrange(floatFeatureCount)) {
+            const auto externalIdx = featuresLayout.GetExternalFeatureIdx(floatFeatureIdx, EFeatureType::Float);
+            if (!featuresMetaInfo[externalIdx].IsAvailable) {
+                continue;
+            }
+            const auto it = LowerBound(
+                QuantizationSchema.FeatureIndices.begin(),
+                QuantizationSchema.FeatureIndices.end(),
+                (size_t)externalIdx
+            );
+            if ((it == QuantizationSchema.FeatureIndices.end()) || (*it != externalIdx)) {
+                continue;
+            }
+            const size_t schemaIdx = it - QuantizationSchema.FeatureIndices.begin();
+            const auto& borders = QuantizationSchema.Borders[schemaIdx];
+            if (borders.empty()) {
+                continue;
+            }
+            CB_ENSURE(
+                borders.size() <= Max<ui8>(),
+                "Feature " << externalIdx << " has " << borders.size() << " borders, quantized pools support at most "
+                << (ui32)Max<ui8>()
+            );
+            FloatFeatureSchemaIndices[floatFeatureIdx] = schemaIdx;
+        }
+
+        FloatFeatures.resize(floatFeatureCount);
+        Baseline.resize(BaselineColumnIndices.size());
+
+        Cursor = 0;
+        NextCursor = 0;
+        DocumentOffset = 0;
+    }
+
+    void TQuantizedPoolStreamingWriter::StartNextBlock(ui32 blockSize) {
+        if (NextCursor >= DocumentsPerChunk) {
+            FlushChunks();
+        }
+        Cursor = NextCursor;
+        NextCursor = Cursor + blockSize;
+        ResizeBuffers(NextCursor);
+    }
+
+    void TQuantizedPoolStreamingWriter::AddTarget(ui32 localObjectIdx, const TString& value) {
+        float target;
+        CB_ENSURE(
+            TryFromString(value, target),
+            "Target value " << value.Quote() << " is not a number, quantized pools support only numeric targets"
+        );
+        Target[Cursor + localObjectIdx] = target;
+    }
+
+    void TQuantizedPoolStreamingWriter::SetGroupWeights(TVector<float>&& groupWeights) {
+        Y_UNUSED(groupWeights);
+        CB_ENSURE(false, "Group weights from a separate file can't be written to quantized pool, use GroupWeight column");
+    }
+
+    void TQuantizedPoolStreamingWriter::SetPairs(TVector<TPair>&& pairs) {
+        Y_UNUSED(pairs);
+        CB_ENSURE(false, "Pairs can't be written to quantized pool, pass them in a separate file");
+    }
+
+    void TQuantizedPoolStreamingWriter::Finish() {
+        CB_ENSURE(InProcess, "Attempt to finish without starting processing");
+        if (NextCursor) {
+            FlushChunks();
+        }
+
+        const auto& columns = MetaInfo.ColumnsInfo->Columns;
+
+        THashMap<size_t, size_t> columnIndexToLocalIndex;
+        TVector<EColumn> columnTypes;
+        TVector<TString> columnNames;
+        TVector<size_t> ignoredColumnIndices;
+        ui32 floatFeatureIdx = 0;
+        for (auto columnIdx : xrange(columns.size())) {
+            columnIndexToLocalIndex.emplace(columnIdx, columnIdx);
+
+            auto columnType = columns[columnIdx].Type;
+            if (columnType == EColumn::Num) {
+                // ignored, missing from the schema or without borders - no chunks were written
+                if (!FloatFeatureSchemaIndices[floatFeatureIdx]) {
+                    ignoredColumnIndices.push_back(columnIdx);
+                }
+                ++floatFeatureIdx;
+            } else if (IsFactorColumn(columnType)) {
+                // categorical features are always ignored, checked in Start
+                ignoredColumnIndices.push_back(columnIdx);
+            } else if ((columnType == EColumn::Timestamp) || (columnType == EColumn::Prediction)) {
+                // has no chunks
+                columnType = EColumn::Auxiliary;
+            }
+            columnTypes.push_back(columnType);
+            columnNames.push_back(columns[columnIdx].Id);
+        }
+
+        FileWriter.Finish(
+            MakePoolMetainfo(
+                columnIndexToLocalIndex,
+                columnTypes,
+                columnNames,
+                DocumentOffset,
+                ignoredColumnIndices
+            ),
+            QuantizationSchemaToProto(QuantizationSchema)
+        );
+
+        InProcess = false;
+        FloatFeatures.clear();
+        Baseline.clear();
+    }
+
+    void TQuantizedPoolStreamingWriter::ResizeBuffers(ui32 size) {
+        for (auto floatFeatureIdx : xrange(FloatFeatures.size())) {
+            if (FloatFeatureSchemaIndices[floatFeatureIdx]) {
+                FloatFeatures[floatFeatureIdx].resize(size);
+            }
+        }
+        if (TargetColumnIndex) {
+            Target.resize(size);
+        }
+        for (auto& oneBaseline : Baseline) {
+            oneBaseline.resize(size);
+        }
+        if (WeightColumnIndex) {
+            Weights.resize(size);
+        }
+        if (GroupWeightColumnIndex) {
+            GroupWeights.resize(size);
+        }
+        if (GroupIdColumnIndex) {
+            GroupIds.resize(size);
+        }
+        if (SubgroupIdColumnIndex) {
+            SubgroupIds.resize(size);
+        }
+    }
+
+    void TQuantizedPoolStreamingWriter::FlushChunks() {
+        const ui32 documentCount = NextCursor;
+        CB_ENSURE(
+            DocumentOffset + documentCount <= Max<ui32>(),
+            "Quantized pools with more than " << Max<ui32>() << " objects are not supported"
+        );
+
+        using TBuildChunkFunc = std::function<void(flatbuffers::FlatBufferBuilder*)>;
+
+        const NBlockCodecs::ICodec* codec = ChunksCodecName ? NBlockCodecs::Codec(ChunksCodecName) : nullptr;
+
+        TVector<ui32> columnIndices;
+        TVector<TBuildChunkFunc> buildChunkFuncs;
+
+        auto addColumn = [&] (ui32 columnIdx, TBuildChunkFunc&& buildChunkFunc) {
+            columnIndices.push_back(columnIdx);
+            buildChunkFuncs.push_back(std::move(buildChunkFunc));
+        };
+
+        for (auto floatFeatureIdx : xrange(FloatFeatures.size())) {
+            if (!FloatFeatureSchemaIndices[floatFeatureIdx]) {
+                continue;
+            }
+            addColumn(
+                FloatFeatureColumnIndices[floatFeatureIdx],
+                [&, floatFeatureIdx] (flatbuffers::FlatBufferBuilder* builder) {
+                    const size_t schemaIdx = *FloatFeatureSchemaIndices[floatFeatureIdx];
+                    const TConstArrayRef<float> borders = QuantizationSchema.Borders[schemaIdx];
+                    const ENanMode nanMode = QuantizationSchema.NanModes[schemaIdx];
+                    const auto& values = FloatFeatures[floatFeatureIdx];
+
+                    TVector<ui8> quants;
+                    quants.yresize(documentCount);
+                    for (auto i : xrange(documentCount)) {
+                        quants[i] = (ui8)Quantize(values[i], borders, nanMode);
+                    }
+                    BuildChunk<ui8>(quants, NIdl::EBitsPerDocumentFeature_BPDF_8, codec, builder);
+                }
+            );
+        }
+        if (TargetColumnIndex) {
+            addColumn(
+                *TargetColumnIndex,
+                [&] (flatbuffers::FlatBufferBuilder* builder) {
+                    BuildChunk<float>(Target, NIdl::EBitsPerDocumentFeature_BPDF_32, codec, builder);
+                }
+            );
+        }
+        for (auto baselineIdx : xrange(Baseline.size())) {
+            addColumn(
+                BaselineColumnIndices[baselineIdx],
+                [&, baselineIdx] (flatbuffers::FlatBufferBuilder* builder) {
+                    // stored as double in quantized pools
+                    const TVector<double> baseline(Baseline[baselineIdx].begin(), Baseline[baselineIdx].end());
+                    BuildChunk<double>(baseline, NIdl::EBitsPerDocumentFeature_BPDF_64, codec, builder);
+                }
+            );
+        }
+        if (WeightColumnIndex) {
+            addColumn(
+                *WeightColumnIndex,
+                [&] (flatbuffers::FlatBufferBuilder* builder) {
+                    BuildChunk<float>(Weights, NIdl::EBitsPerDocumentFeature_BPDF_32, codec, builder);
+                }
+            );
+        }
+        if (GroupWeightColumnIndex) {
+            addColumn(
+                *GroupWeightColumnIndex,
+                [&] (flatbuffers::FlatBufferBuilder* builder) {
+                    BuildChunk<float>(GroupWeights, NIdl::EBitsPerDocumentFeature_BPDF_32, codec, builder);
+                }
+            );
+        }
+        if (GroupIdColumnIndex) {
+            addColumn(
+                *GroupIdColumnIndex,
+                [&] (flatbuffers::FlatBufferBuilder* builder) {
+                    BuildChunk<TGroupId>(GroupIds, NIdl::EBitsPerDocumentFeature_BPDF_64, codec, builder);
+                }
+            );
+        }
+        if (SubgroupIdColumnIndex) {
+            addColumn(
+                *SubgroupIdColumnIndex,
+                [&] (flatbuffers::FlatBufferBuilder* builder) {
+                    BuildChunk<TSubgroupId>(SubgroupIds, NIdl::EBitsPerDocumentFeature_BPDF_32, codec, builder);
+                }
+            );
+        }
+
+        // all buffers are resized to NextCursor == documentCount, so chunks are built from whole buffers
+        TVector<flatbuffers::FlatBufferBuilder> builders(buildChunkFuncs.size());
+        LocalExecutor->ExecRangeWithThrow(
+            [&] (int chunkIdx) {
+                buildChunkFuncs[chunkIdx](&builders[chunkIdx]);
+            },
+            0,
+            SafeIntegerCast<int>(buildChunkFuncs.size()),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+
+        // written in fixed column order to keep output deterministic
+        for (auto chunkIdx : xrange(builders.size())) {
+            FileWriter.AddChunk(
+                columnIndices[chunkIdx],
+                SafeIntegerCast<ui32>(DocumentOffset),
+                documentCount,
+                MakeArrayRef(builders[chunkIdx].GetBufferPointer(), builders[chunkIdx].GetSize())
+            );
+        }
+
+        DocumentOffset += documentCount;
+        Cursor = 0;
+        NextCursor = 0;
+    }
+
+
+    void SaveQuantizedPoolFromRawDataset(
+        const TPathWithScheme& poolPath,
+        const NCatboostOptions::TDsvPoolFormatParams& dsvPoolFormatParams,
+        const TVector<ui32>& ignoredFeatures,
+        const TPoolQuantizationSchema& quantizationSchema,
+        IOutputStream* output,
+        NPar::TLocalExecutor* localExecutor,
+        ui32 documentsPerChunk,
+        TStringBuf chunksCodecName
+    ) {
+        auto datasetLoader = GetProcessor<IDatasetLoader>(
+            poolPath, // for choosing processor
+
+            // processor args
+            TDatasetLoaderPullArgs {
+                poolPath,
+
+                TDatasetLoaderCommonArgs {
+                    /*PairsFilePath*/ TPathWithScheme(),
+                    /*GroupWeightsFilePath*/ TPathWithScheme(),
+                    dsvPoolFormatParams.Format,
+                    MakeCdProviderFromFile(dsvPoolFormatParams.CdFilePath),
+                    ignoredFeatures,
+                    EObjectsOrder::Undefined,
+                    10000, // same block size as in ReadDataset
+                    localExecutor
+                }
+            }
+        );
+        CB_ENSURE(
+            datasetLoader->GetVisitorType() == EDatasetVisitorType::RawObjectsOrder,
+            "Only datasets with raw objects order data can be written as quantized pools"
+        );
+
+        TQuantizedPoolStreamingWriter writer(
+            output,
+            quantizationSchema,
+            localExecutor,
+            documentsPerChunk,
+            chunksCodecName
+        );
+        datasetLoader->DoIfCompatible(&writer);
+    }
+
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "serialization.h"
+
+#include <catboost/libs/data_new/meta_info.h>
+#include <catboost/libs/data_new/visitor.h>
+#include <catboost/libs/data_util/path_with_scheme.h>
+#include <catboost/libs/options/load_options.h>
+#include <catboost/libs/quantization_schema/schema.h>
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/maybe.h>
+#include <util/generic/strbuf.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/stream/fwd.h>
+#include <util/system/types.h>
+
+
+namespace NCB {
+
+    /* Converts raw dataset to quantized pool without materializing it.
+     *
+     * Objects are buffered until at least `documentsPerChunk` of them are collected, then all
+     * columns of this window are quantized and serialized to chunks in parallel and appended to
+     * `output`. Chunk table is written by `Finish`, so memory usage is bounded by one chunk window
+     * (plus one block of the loader) regardless of dataset size.
+     *
+     * Borders have to be known beforehand (see `TQuantileSketch` or `LoadQuantizationSchema`).
+     * Float features not present in `quantizationSchema` or having no borders are not written
+     * and become ignored in the resulting pool.
+     *
+     * If `chunksCodecName` is not empty chunks are compressed with this `library/blockcodecs` codec
+     * (in parallel as well).
+     *
+     * Only non-block processing (`Start` is called once with `inBlock == false`) is supported.
+     */
+    class TQuantizedPoolStreamingWriter final : public IRawObjectsOrderDataVisitor {
+    public:
+        static constexpr ui32 DEFAULT_DOCUMENTS_PER_CHUNK = 1 << 16;
+
+    public:
+        TQuantizedPoolStreamingWriter(
+            IOutputStream* output,
+            const TPoolQuantizationSchema& quantizationSchema,
+            NPar::TLocalExecutor* localExecutor,
+            ui32 documentsPerChunk = DEFAULT_DOCUMENTS_PER_CHUNK,
+            TStringBuf chunksCodecName = TStringBuf());
+
+        void Start(
+            bool inBlock,
+            const TDataMetaInfo& metaInfo,
+            ui32 objectCount,
+            EObjectsOrder objectsOrder,
+            TVector<TIntrusivePtr<IResourceHolder>> resourceHolders
+        ) override;
+
+        void StartNextBlock(ui32 blockSize) override;
+
+        void AddGroupId(ui32 localObjectIdx, TGroupId value) override {
+            GroupIds[Cursor + localObjectIdx] = value;
+        }
+        void AddSubgroupId(ui32 localObjectIdx, TSubgroupId value) override {
+            SubgroupIds[Cursor + localObjectIdx] = value;
+        }
+        void AddTimestamp(ui32 localObjectIdx, ui64 value) override {
+            // not supported by quantized pools format
+            Y_UNUSED(localObjectIdx, value);
+        }
+
+        void AddFloatFeature(ui32 localObjectIdx, ui32 flatFeatureIdx, float feature) override {
+            auto floatFeatureIdx = MetaInfo.FeaturesLayout->GetInternalFeatureIdx(flatFeatureIdx);
+            auto& values = FloatFeatures[floatFeatureIdx];
+            if (!values.empty()) {
+                values[Cursor + localObjectIdx] = feature;
+            }
+        }
+        void AddAllFloatFeatures(ui32 localObjectIdx, TConstArrayRef<float> features) override {
+            const auto objectIdx = Cursor + localObjectIdx;
+            for (auto floatFeatureIdx : xrange(features.size())) {
+                auto& values = FloatFeatures[floatFeatureIdx];
+                if (!values.empty()) {
+                    values[objectIdx] = features[floatFeatureIdx];
+                }
+            }
+        }
+
+        // only ignored categorical features are allowed, their values are skipped
+        ui32 GetCatFeatureValue(ui32 flatFeatureIdx, TStringBuf feature) override {
+            Y_UNUSED(flatFeatureIdx, feature);
+            return 0;
+        }
+        void AddCatFeature(ui32 localObjectIdx, ui32 flatFeatureIdx, TStringBuf feature) override {
+            Y_UNUSED(localObjectIdx, flatFeatureIdx, feature);
+        }
+        void AddAllCatFeatures(ui32 localObjectIdx, TConstArrayRef<ui32> features) override {
+            Y_UNUSED(localObjectIdx, features);
+        }
+
+        void AddTarget(ui32 localObjectIdx, const TString& value) override;
+        void AddTarget(ui32 localObjectIdx, float value) override {
+            Target[Cursor + localObjectIdx] = value;
+        }
+        void AddBaseline(ui32 localObjectIdx, ui32 baselineIdx, float value) override {
+            Baseline[baselineIdx][Cursor + localObjectIdx] = value;
+        }
+        void AddWeight(ui32 localObjectIdx, float value) override {
+            Weights[Cursor + localObjectIdx] = value;
+        }
+        void AddGroupWeight(ui32 localObjectIdx, float value) override {
+            GroupWeights[Cursor + localObjectIdx] = value;
+        }
+
+        // quantized pools store group weights in GroupWeight column only
+        void SetGroupWeights(TVector<float>&& groupWeights) override;
+
+        // pairs are always stored in a separate file
+        void SetPairs(TVector<TPair>&& pairs) override;
+
+        // data is not kept after being written
+        TMaybeData<TConstArrayRef<TGroupId>> GetGroupIds() const override {
+            return Nothing();
+        }
+
+        void Finish() override;
+
+    private:
+        void ResizeBuffers(ui32 size);
+
+        // quantize and write all buffered objects
+        void FlushChunks();
+
+    private:
+        TString ChunksCodecName;
+        TQuantizedPoolFileWriter FileWriter;
+        TPoolQuantizationSchema QuantizationSchema;
+        NPar::TLocalExecutor* LocalExecutor;
+        ui32 DocumentsPerChunk;
+
+        TDataMetaInfo MetaInfo;
+        bool InProcess = false;
+
+        // column indices in source dataset
+        TVector<ui32> FloatFeatureColumnIndices; // [floatFeatureIdx]
+        TVector<ui32> BaselineColumnIndices; // [baselineIdx]
+        TMaybe<ui32> TargetColumnIndex;
+        TMaybe<ui32> WeightColumnIndex;
+        TMaybe<ui32> GroupWeightColumnIndex;
+        TMaybe<ui32> GroupIdColumnIndex;
+        TMaybe<ui32> SubgroupIdColumnIndex;
+
+        // [floatFeatureIdx], Nothing() for features that are not written
+        TVector<TMaybe<size_t>> FloatFeatureSchemaIndices;
+
+        // buffers for current chunk window, indexed by object index in the window
+        TVector<TVector<float>> FloatFeatures; // [floatFeatureIdx], empty for features that are not written
+        TVector<float> Target;
+        TVector<TVector<float>> Baseline; // [baselineIdx]
+        TVector<float> Weights;
+        TVector<float> GroupWeights;
+        TVector<TGroupId> GroupIds;
+        TVector<TSubgroupId> SubgroupIds;
+
+        ui32 Cursor = 0;
+        ui32 NextCursor = 0;
+
+        // index of the first object of current chunk window in the whole dataset
+        ui64 DocumentOffset = 0;
+    };
+
+
+    // Reads raw dataset from `poolPath` and writes it as quantized pool to `output` chunk by chunk
+    void SaveQuantizedPoolFromRawDataset(
+        const TPathWithScheme& poolPath,
+        const NCatboostOptions::TDsvPoolFormatParams& dsvPoolFormatParams,
+        const TVector<ui32>& ignoredFeatures,
+        const TPoolQuantizationSchema& quantizationSchema,
+        IOutputStream* output,
+        NPar::TLocalExecutor* localExecutor,
+        ui32 documentsPerChunk = TQuantizedPoolStreamingWriter::DEFAULT_DOCUMENTS_PER_CHUNK,
+        TStringBuf chunksCodecName = TStringBuf());
+
+}
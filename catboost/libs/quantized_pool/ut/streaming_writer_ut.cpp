@@ -0,0 +1,281 @@
+#include <catboost/idl/pool/flat/quantized_chunk_t.fbs.h>
+#include <catboost/libs/data_new/data_provider.h>
+#include <catboost/libs/data_new/load_data.h>
+#include <catboost/libs/data_new/ut/lib/for_loader.h>
+#include <catboost/libs/quantized_pool/pool.h>
+#include <catboost/libs/quantized_pool/serialization.h>
+#include <catboost/libs/quantized_pool/streaming_writer.h>
+#include <catboost/libs/quantization_schema/schema.h>
+
+#include <util/generic/strbuf.h>
+#include <util/generic/xrange.h>
+#include <util/stream/file.h>
+#include <util/system/mktemp.h>
+#include <util/system/tempfile.h>
+
+#include <library/unittest/registar.h>
+
+
+using namespace NCB;
+using namespace NCB::NDataNewUT;
+
+
+Y_UNIT_TEST_SUITE(QuantizedPoolStreamingWriter) {
+    template <class T>
+    static TVector<T> GetColumnData(const TQuantizedPool& pool, size_t columnIndex, size_t expectedChunkCount) {
+        const auto& chunks = pool.Chunks[pool.ColumnIndexToLocalIndex.at(columnIndex)];
+        UNIT_ASSERT_VALUES_EQUAL(chunks.size(), expectedChunkCount);
+
+        TVector<T> data;
+        for (const auto& chunk : chunks) {
+            UNIT_ASSERT_VALUES_EQUAL(chunk.DocumentOffset, data.size());
+            const auto* quants = chunk.Chunk->Quants();
+            UNIT_ASSERT_VALUES_EQUAL(quants->size(), chunk.DocumentCount * sizeof(T));
+            const T* begin = reinterpret_cast<const T*>(quants->data());
+            data.insert(data.end(), begin, begin + chunk.DocumentCount);
+        }
+        return data;
+    }
+
+    static TPoolQuantizationSchema MakeQuantizationSchema() {
+        TPoolQuantizationSchema schema;
+        schema.FeatureIndices = {0, 2};
+        schema.Borders = {{0.15f, 0.5f}, {0.2f}};
+        schema.NanModes = {ENanMode::Max, ENanMode::Forbidden};
+        return schema;
+    }
+
+    static void TestFromDsv(TStringBuf chunksCodecName) {
+        TSrcData srcData;
+        srcData.CdFileData = AsStringBuf(
+            "0\tTarget\n"
+            "1\tWeight\n"
+            "2\tNum\tf0\n"
+            "3\tCateg\tc0\n"
+            "4\tNum\tf1\n"
+            "5\tBaseline\n"
+            "6\tAuxiliary\n"
+        );
+        srcData.DsvFileData = AsStringBuf(
+            "0\t1.0\t0.1\ta\t0.1\t0.5\tx\n"
+            "1\t0.5\tnan\tb\t0.3\t-0.5\ty\n"
+            "0\t2.0\t0.7\ta\t0.2\t0.0\tz\n"
+        );
+        srcData.IgnoredFeatures = {1};
+
+        TReadDatasetMainParams readDatasetMainParams;
+        TVector<THolder<TTempFile>> srcDataFiles;
+        SaveSrcData(srcData, &readDatasetMainParams, &srcDataFiles);
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        const TString quantizedPoolFileName = MakeTempName();
+        TTempFile quantizedPoolFile(quantizedPoolFileName);
+        {
+            TFileOutput output(quantizedPoolFileName);
+            SaveQuantizedPoolFromRawDataset(
+                readDatasetMainParams.PoolPath,
+                readDatasetMainParams.DsvPoolFormatParams,
+                srcData.IgnoredFeatures,
+                MakeQuantizationSchema(),
+                &output,
+                &localExecutor,
+                TQuantizedPoolStreamingWriter::DEFAULT_DOCUMENTS_PER_CHUNK,
+                chunksCodecName
+            );
+        }
+
+        const auto pool = LoadQuantizedPool(quantizedPoolFileName, {/*LockMemory*/ false, /*Precharge*/ false});
+        UNIT_ASSERT_VALUES_EQUAL(pool.DocumentCount, 3);
+        UNIT_ASSERT_VALUES_EQUAL(pool.ColumnTypes.size(), 7);
+        UNIT_ASSERT_VALUES_EQUAL(pool.IgnoredColumnIndices, TVector<size_t>{3});
+
+        UNIT_ASSERT_VALUES_EQUAL(GetColumnData<float>(pool, 0, 1), (TVector<float>{0.f, 1.f, 0.f}));
+        UNIT_ASSERT_VALUES_EQUAL(GetColumnData<float>(pool, 1, 1), (TVector<float>{1.f, 0.5f, 2.f}));
+        UNIT_ASSERT_VALUES_EQUAL(GetColumnData<ui8>(pool, 2, 1), (TVector<ui8>{0, 2, 2}));
+        UNIT_ASSERT_VALUES_EQUAL(GetColumnData<ui8>(pool, 4, 1), (TVector<ui8>{0, 1, 0}));
+        UNIT_ASSERT_VALUES_EQUAL(GetColumnData<double>(pool, 5, 1), (TVector<double>{0.5, -0.5, 0.0}));
+        UNIT_ASSERT(pool.Chunks[pool.ColumnIndexToLocalIndex.at(3)].empty());
+        UNIT_ASSERT(pool.Chunks[pool.ColumnIndexToLocalIndex.at(6)].empty());
+
+        // written pool is readable by the usual loader
+        TDataProviderPtr dataProvider = ReadDataset(
+            TPathWithScheme("quantized://" + quantizedPoolFileName),
+            /*pairsFilePath*/ TPathWithScheme(),
+            /*groupWeightsFilePath*/ TPathWithScheme(),
+            NCatboostOptions::TDsvPoolFormatParams(),
+            /*ignoredFeatures*/ {},
+            EObjectsOrder::Undefined,
+            &localExecutor
+        );
+        UNIT_ASSERT_VALUES_EQUAL(dataProvider->GetObjectCount(), 3);
+        UNIT_ASSERT_VALUES_EQUAL(dataProvider->MetaInfo.GetFeatureCount(), 3);
+        const auto target = *dataProvider->RawTargetData.GetTarget();
+        UNIT_ASSERT_VALUES_EQUAL(TVector<TString>(target.begin(), target.end()), (TVector<TString>{"0", "1", "0"}));
+
+        auto quantizedDataProvider = dataProvider->CastMoveTo<TQuantizedObjectsDataProvider>();
+        UNIT_ASSERT(quantizedDataProvider);
+        const auto feature0 = (*quantizedDataProvider->ObjectsData->GetFloatFeature(0))->ExtractValues(&localExecutor);
+        UNIT_ASSERT_VALUES_EQUAL(TVector<ui8>((*feature0).begin(), (*feature0).end()), (TVector<ui8>{0, 2, 2}));
+    }
+
+    Y_UNIT_TEST(FromDsv) {
+        TestFromDsv(TStringBuf());
+    }
+
+    Y_UNIT_TEST(FromDsvCompressed) {
+        TestFromDsv("lz4");
+    }
+
+    Y_UNIT_TEST(FeaturesNotInSchema) {
+        TSrcData srcData;
+        srcData.CdFileData = AsStringBuf(
+            "0\tTarget\n"
+            "1\tNum\tf0\n"
+            "2\tNum\tf1\n"
+            "3\tNum\tf2\n"
+        );
+        srcData.DsvFileData = AsStringBuf(
+            "0\t0.1\t0.3\t1.0\n"
+            "1\t0.7\t0.4\t2.0\n"
+        );
+
+        TReadDatasetMainParams readDatasetMainParams;
+        TVector<THolder<TTempFile>> srcDataFiles;
+        SaveSrcData(srcData, &readDatasetMainParams, &srcDataFiles);
+
+        // f1 is available but missing from the schema, f2 has no borders
+        TPoolQuantizationSchema schema;
+        schema.FeatureIndices = {0, 2};
+        schema.Borders = {{0.5f}, {}};
+        schema.NanModes = {ENanMode::Forbidden, ENanMode::Forbidden};
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        const TString quantizedPoolFileName = MakeTempName();
+        TTempFile quantizedPoolFile(quantizedPoolFileName);
+        {
+            TFileOutput output(quantizedPoolFileName);
+            SaveQuantizedPoolFromRawDataset(
+                readDatasetMainParams.PoolPath,
+                readDatasetMainParams.DsvPoolFormatParams,
+                srcData.IgnoredFeatures,
+                schema,
+                &output,
+                &localExecutor
+            );
+        }
+
+        const auto pool = LoadQuantizedPool(quantizedPoolFileName, {/*LockMemory*/ false, /*Precharge*/ false});
+        UNIT_ASSERT_VALUES_EQUAL(pool.DocumentCount, 2);
+        UNIT_ASSERT_VALUES_EQUAL(pool.IgnoredColumnIndices, (TVector<size_t>{2, 3}));
+        UNIT_ASSERT_VALUES_EQUAL(GetColumnData<ui8>(pool, 1, 1), (TVector<ui8>{0, 1}));
+        UNIT_ASSERT(pool.Chunks[pool.ColumnIndexToLocalIndex.at(2)].empty());
+        UNIT_ASSERT(pool.Chunks[pool.ColumnIndexToLocalIndex.at(3)].empty());
+
+        TDataProviderPtr dataProvider = ReadDataset(
+            TPathWithScheme("quantized://" + quantizedPoolFileName),
+            /*pairsFilePath*/ TPathWithScheme(),
+            /*groupWeightsFilePath*/ TPathWithScheme(),
+            NCatboostOptions::TDsvPoolFormatParams(),
+            /*ignoredFeatures*/ {},
+            EObjectsOrder::Undefined,
+            &localExecutor
+        );
+        UNIT_ASSERT_VALUES_EQUAL(dataProvider->GetObjectCount(), 2);
+        UNIT_ASSERT_VALUES_EQUAL(dataProvider->MetaInfo.GetFeatureCount(), 3);
+        const auto featuresMetaInfo = dataProvider->MetaInfo.FeaturesLayout->GetExternalFeaturesMetaInfo();
+        UNIT_ASSERT(featuresMetaInfo[0].IsAvailable);
+        UNIT_ASSERT(!featuresMetaInfo[1].IsAvailable);
+        UNIT_ASSERT(!featuresMetaInfo[2].IsAvailable);
+
+        auto quantizedDataProvider = dataProvider->CastMoveTo<TQuantizedObjectsDataProvider>();
+        UNIT_ASSERT(quantizedDataProvider);
+        const auto feature0 = (*quantizedDataProvider->ObjectsData->GetFloatFeature(0))->ExtractValues(&localExecutor);
+        UNIT_ASSERT_VALUES_EQUAL(TVector<ui8>((*feature0).begin(), (*feature0).end()), (TVector<ui8>{0, 1}));
+    }
+
+    static void TestChunkWindows(TStringBuf chunksCodecName) {
+        TDataColumnsMetaInfo columnsInfo;
+        columnsInfo.Columns = {
+            {EColumn::Label, ""},
+            {EColumn::GroupId, ""},
+            {EColumn::Num, "f0"},
+            {EColumn::Timestamp, ""}
+        };
+        TDataMetaInfo metaInfo(std::move(columnsInfo), false, false);
+
+        TPoolQuantizationSchema schema;
+        schema.FeatureIndices = {0};
+        schema.Borders = {{0.5f, 1.5f, 2.5f}};
+        schema.NanModes = {ENanMode::Forbidden};
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        const TString quantizedPoolFileName = MakeTempName();
+        TTempFile quantizedPoolFile(quantizedPoolFileName);
+        {
+            TFileOutput output(quantizedPoolFileName);
+            TQuantizedPoolStreamingWriter writer(
+                &output,
+                schema,
+                &localExecutor,
+                /*documentsPerChunk*/ 3,
+                chunksCodecName
+            );
+
+            writer.Start(false, metaInfo, 7, EObjectsOrder::Undefined, {});
+            ui32 objectIdx = 0;
+            for (ui32 blockSize : {2, 2, 3}) {
+                writer.StartNextBlock(blockSize);
+                for (auto localObjectIdx : xrange(blockSize)) {
+                    writer.AddTarget(localObjectIdx, ToString(objectIdx % 2));
+                    writer.AddGroupId(localObjectIdx, objectIdx / 3);
+                    writer.AddFloatFeature(localObjectIdx, 0, float(objectIdx % 4));
+                    writer.AddTimestamp(localObjectIdx, objectIdx);
+                    ++objectIdx;
+                }
+            }
+            writer.Finish();
+        }
+
+        const auto pool = LoadQuantizedPool(quantizedPoolFileName, {/*LockMemory*/ false, /*Precharge*/ false});
+        UNIT_ASSERT_VALUES_EQUAL(pool.DocumentCount, 7);
+
+        // first window has 4 objects (2 blocks), second - 3 objects (1 block)
+        UNIT_ASSERT_VALUES_EQUAL(
+            GetColumnData<float>(pool, 0, 2),
+            (TVector<float>{0.f, 1.f, 0.f, 1.f, 0.f, 1.f, 0.f})
+        );
+        UNIT_ASSERT_VALUES_EQUAL(
+            GetColumnData<ui64>(pool, 1, 2),
+            (TVector<ui64>{0, 0, 0, 1, 1, 1, 2})
+        );
+        UNIT_ASSERT_VALUES_EQUAL(
+            GetColumnData<ui8>(pool, 2, 2),
+            (TVector<ui8>{0, 1, 2, 3, 0, 1, 2})
+        );
+        UNIT_ASSERT_VALUES_EQUAL(pool.ColumnTypes[pool.ColumnIndexToLocalIndex.at(3)], EColumn::Auxiliary);
+
+        const auto rawPool = LoadQuantizedPool(
+            quantizedPoolFileName,
+            {/*LockMemory*/ false, /*Precharge*/ false, /*DecompressChunks*/ false}
+        );
+        for (const auto& chunks : rawPool.Chunks) {
+            for (const auto& chunk : chunks) {
+                UNIT_ASSERT_VALUES_EQUAL(HasCompressedQuants(*chunk.Chunk), !chunksCodecName.empty());
+            }
+        }
+    }
+
+    Y_UNIT_TEST(ChunkWindows) {
+        TestChunkWindows(TStringBuf());
+    }
+
+    Y_UNIT_TEST(ChunkWindowsCompressed) {
+        TestChunkWindows("zstd_1");
+    }
+}
@@ -110,6 +110,8 @@ namespace NCB {
             quantizationOptions.CpuRamLimit
                 = ParseMemorySizeDescription(params->SystemOptions->CpuUsedRamLimit.Get());
             quantizationOptions.AllowWriteFiles = allowWriteFiles;
+            quantizationOptions.UseQuantileSketchForBuildBorders
+                = params->DataProcessingOptions->UseQuantileSketchForBorders.Get();
 
             if (!quantizedFeaturesInfo) {
                 quantizedFeaturesInfo = MakeIntrusive<TQuantizedFeaturesInfo>(
@@ -264,7 +264,8 @@ static void Train(
             ctx->LearnProgress.Folds,
             isPairwiseScoring,
             defaultCalcStatsObjBlockSize,
-            GetBernoulliSampleRate(ctx->Params.ObliviousTreeOptions->BootstrapConfig)
+            GetSampleRate(ctx->Params.ObliviousTreeOptions->BootstrapConfig),
+            IsSampledBySampleWeights(ctx->Params.ObliviousTreeOptions->BootstrapConfig)
         ); // TODO(espetrov): create only if sample rate < 1
     }
 
@@ -282,8 +283,8 @@ static void Train(
         profile.StartNextIteration();
 
         if (timer.Passed() > ctx->OutputOptions.GetSnapshotSaveInterval()) {
-            profile.AddOperation("Save snapshot");
             ctx->SaveProgress();
+            profile.AddOperation("Save snapshot");
             timer.Reset();
         }
 
@@ -352,6 +353,11 @@ static void Train(
     }
 
     ctx->SaveProgress();
+    ctx->WaitForSnapshotSaving();
+
+    if (ctx->MemoryBudget.IsLimited()) {
+        CATBOOST_INFO_LOG << "Memory usage at the end of training: " << ctx->MemoryBudget.GetBreakdown() << Endl;
+    }
 
     if (hasTest) {
         (*testMultiApprox) = ctx->LearnProgress.TestApprox;
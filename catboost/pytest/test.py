@@ -1833,6 +1833,48 @@ def test_fstr(fstr_type, boosting_type):
     return local_canonical_file(output_fstr_path)
 
 
+@pytest.mark.parametrize('boosting_type', BOOSTING_TYPE)
+def test_loss_function_change_fstr(boosting_type):
+    model_path = yatest.common.test_output_path('adult_model.bin')
+    output_fstr_path = yatest.common.test_output_path('fstr.tsv')
+    ignored_feature = 3
+
+    cmd = (
+        CATBOOST_PATH,
+        'fit',
+        '--use-best-model', 'false',
+        '--loss-function', 'Logloss',
+        '-f', data_file('adult', 'train_small'),
+        '--column-description', data_file('adult', 'train.cd'),
+        '--boosting-type', boosting_type,
+        '-i', '10',
+        '-w', '0.03',
+        '-T', '4',
+        '-I', str(ignored_feature),
+        '-m', model_path
+    )
+    yatest.common.execute(cmd)
+
+    fstr_cmd = (
+        CATBOOST_PATH,
+        'fstr',
+        '--input-path', data_file('adult', 'test_small'),
+        '--column-description', data_file('adult', 'train.cd'),
+        '-m', model_path,
+        '-o', output_fstr_path,
+        '--fstr-type', 'LossFunctionChange'
+    )
+    yatest.common.execute(fstr_cmd)
+
+    fstr = np.loadtxt(output_fstr_path, dtype=str, delimiter='\t', ndmin=2)
+    scores = dict((int(feature), float(score)) for score, feature in fstr)
+    feature_count = 17
+    assert len(fstr) == feature_count
+    assert sorted(scores.keys()) == list(range(feature_count))
+    assert scores[ignored_feature] == 0
+    assert any(score != 0 for score in scores.values())
+
+
 @pytest.mark.parametrize('loss_function', LOSS_FUNCTIONS)
 @pytest.mark.parametrize(
     'dev_score_calc_obj_block_size',
@@ -3187,6 +3229,40 @@ def test_subsample_per_tree_level(boosting_type, dev_score_calc_obj_block_size):
     return local_canonical_file(output_eval_path)
 
 
+@pytest.mark.parametrize('boosting_type', BOOSTING_TYPE)
+@pytest.mark.parametrize('sampling_frequency', ['PerTree', 'PerTreeLevel'])
+def test_mvs_bootstrap(boosting_type, sampling_frequency):
+    test_error_paths = {}
+    for bootstrap_type in ('MVS', 'Bernoulli'):
+        output_model_path = yatest.common.test_output_path('model_{}.bin'.format(bootstrap_type))
+        test_error_paths[bootstrap_type] = yatest.common.test_output_path('test_error_{}.tsv'.format(bootstrap_type))
+        cmd = (
+            CATBOOST_PATH,
+            'fit',
+            '--use-best-model', 'false',
+            '--loss-function', 'Logloss',
+            '-f', data_file('adult', 'train_small'),
+            '-t', data_file('adult', 'test_small'),
+            '--column-description', data_file('adult', 'train.cd'),
+            '--boosting-type', boosting_type,
+            '-i', '100',
+            '-w', '0.1',
+            '-T', '4',
+            '-m', output_model_path,
+            '--test-err-log', test_error_paths[bootstrap_type],
+            '--sampling-frequency', sampling_frequency,
+            '--bootstrap-type', bootstrap_type,
+            '--subsample', '0.5',
+        )
+        yatest.common.execute(cmd)
+        assert os.path.exists(output_model_path)
+
+    # sampling by gradients should not be noticeably worse than uniform sampling of the same size
+    mvs_error = np.loadtxt(test_error_paths['MVS'], skiprows=1)[-1, 1]
+    bernoulli_error = np.loadtxt(test_error_paths['Bernoulli'], skiprows=1)[-1, 1]
+    assert mvs_error < 1.02 * bernoulli_error
+
+
 @pytest.mark.parametrize('boosting_type', BOOSTING_TYPE)
 @pytest.mark.parametrize(
     'dev_score_calc_obj_block_size',
@@ -3253,6 +3329,36 @@ def test_plain(boosting_type, dev_score_calc_obj_block_size):
     return [local_canonical_file(output_eval_path)]
 
 
+@pytest.mark.parametrize('loss_function', ['Logloss', 'MultiClass'])
+def test_single_precision_fold_approxes(loss_function):
+    test_error_paths = {}
+    for single_precision in (False, True):
+        suffix = 'single' if single_precision else 'double'
+        output_model_path = yatest.common.test_output_path('model_{}.bin'.format(suffix))
+        test_error_paths[suffix] = yatest.common.test_output_path('test_error_{}.tsv'.format(suffix))
+        cmd = (
+            CATBOOST_PATH,
+            'fit',
+            '--use-best-model', 'false',
+            '--loss-function', loss_function,
+            '-f', data_file('adult', 'train_small'),
+            '-t', data_file('adult', 'test_small'),
+            '--column-description', data_file('adult', 'train.cd'),
+            '--boosting-type', 'Ordered',
+            '-i', '20',
+            '-T', '4',
+            '-m', output_model_path,
+            '--test-err-log', test_error_paths[suffix],
+        ) + (('--single-precision-fold-approxes',) if single_precision else ())
+        yatest.common.execute(cmd)
+        assert os.path.exists(output_model_path)
+
+    # rounding of fold approxes may change some splits but should not affect quality
+    double_error = np.loadtxt(test_error_paths['double'], skiprows=1)[-1, 1]
+    single_error = np.loadtxt(test_error_paths['single'], skiprows=1)[-1, 1]
+    assert abs(single_error - double_error) < 0.01 * double_error
+
+
 @pytest.mark.parametrize('boosting_type', BOOSTING_TYPE)
 @pytest.mark.parametrize(
     'dev_score_calc_obj_block_size',
@@ -3263,7 +3369,8 @@ def test_bootstrap(boosting_type, dev_score_calc_obj_block_size):
     bootstrap_option = {
         'no': ('--bootstrap-type', 'No',),
         'bayes': ('--bootstrap-type', 'Bayesian', '--bagging-temperature', '0.0',),
-        'bernoulli': ('--bootstrap-type', 'Bernoulli', '--subsample', '1.0',)
+        'bernoulli': ('--bootstrap-type', 'Bernoulli', '--subsample', '1.0',),
+        'mvs': ('--bootstrap-type', 'MVS', '--subsample', '1.0',)
     }
     cmd = (
         CATBOOST_PATH,
@@ -3287,6 +3394,7 @@ def test_bootstrap(boosting_type, dev_score_calc_obj_block_size):
     ref_eval_path = yatest.common.test_output_path('test_no.eval')
     assert(filecmp.cmp(ref_eval_path, yatest.common.test_output_path('test_bayes.eval')))
     assert(filecmp.cmp(ref_eval_path, yatest.common.test_output_path('test_bernoulli.eval')))
+    assert(filecmp.cmp(ref_eval_path, yatest.common.test_output_path('test_mvs.eval')))
 
     return [local_canonical_file(ref_eval_path)]
 
@@ -4226,6 +4334,66 @@ def test_eval_non_additive_metric(eval_period):
     return [local_canonical_file(output_eval_path)]
 
 
+# eval-metrics processes 50 plot lines per pass, 200 iterations with eval period 3 need several passes
+@pytest.mark.parametrize('iterations', [20, 200], ids=['iterations=20', 'iterations=200'])
+def test_eval_non_additive_metric_approx_in_tmp_dir(iterations):
+    output_model_path = yatest.common.test_output_path('model.bin')
+    cmd = (
+        CATBOOST_PATH,
+        'fit',
+        '--use-best-model', 'false',
+        '--loss-function', 'Logloss',
+        '-f', data_file('adult', 'train_small'),
+        '-t', data_file('adult', 'test_small'),
+        '--column-description', data_file('adult', 'train.cd'),
+        '-i', str(iterations),
+        '-w', '0.03',
+        '-T', '4',
+        '-m', output_model_path,
+    )
+    yatest.common.execute(cmd)
+
+    def run_eval_metrics(output_eval_path, calc_on_parts, used_ram_limit):
+        cmd = [
+            CATBOOST_PATH,
+            'eval-metrics',
+            '--metrics', 'AUC:hints=skip_train~false,Logloss',
+            '--input-path', data_file('adult', 'test_small'),
+            '--column-description', data_file('adult', 'train.cd'),
+            '-m', output_model_path,
+            '-o', output_eval_path,
+            '--eval-period', '3',
+            '--block-size', '10',
+            '-T', '4',
+        ]
+        if calc_on_parts:
+            cmd += ['--calc-on-parts']
+        if used_ram_limit is not None:
+            cmd += ['--used-ram-limit', used_ram_limit, '--tmp-dir', yatest.common.test_output_path('tmp')]
+        yatest.common.execute(cmd)
+        return np.loadtxt(output_eval_path, skiprows=1)
+
+    metrics = {}
+    for calc_on_parts in (False, True):
+        in_memory_metrics = run_eval_metrics(
+            yatest.common.test_output_path('in_memory_calc_on_parts={}.eval'.format(calc_on_parts)),
+            calc_on_parts,
+            None
+        )
+        in_tmp_dir_metrics = run_eval_metrics(
+            yatest.common.test_output_path('in_tmp_dir_calc_on_parts={}.eval'.format(calc_on_parts)),
+            calc_on_parts,
+            '1KB'
+        )
+        assert np.all(in_memory_metrics == in_tmp_dir_metrics)
+        metrics[calc_on_parts] = in_memory_metrics
+    assert not os.path.exists(yatest.common.test_output_path('tmp'))
+
+    # additive metrics are summed over parts in different order
+    assert metrics[False].shape == metrics[True].shape
+    assert np.allclose(metrics[False], metrics[True], rtol=1e-6, atol=1e-8)
+
+
 @pytest.mark.parametrize('boosting_type', ['Plain', 'Ordered'])
 @pytest.mark.parametrize('max_ctr_complexity', [1, 2])
 def test_eval_eq_calc(boosting_type, max_ctr_complexity):
@@ -4312,6 +4480,51 @@ def test_object_importances(loss_function, leaf_estimation_iteration):
     return [local_canonical_file(object_importances_path)]
 
 
+@pytest.mark.parametrize('leaf_estimation_method', ['Gradient', 'Newton'])
+def test_object_importances_quantized_pool(leaf_estimation_method):
+    output_model_path = yatest.common.test_output_path('model.bin')
+    object_importances_path = yatest.common.test_output_path('object_importances.tsv')
+    quantized_object_importances_path = yatest.common.test_output_path('object_importances.tsv.quantized')
+
+    def get_pool_path(set_name, is_quantized=False):
+        path = data_file('querywise', set_name)
+        return 'quantized://' + path + '.quantized' if is_quantized else path
+
+    # model borders are taken from the quantized pool, so both pools are binarized in the same way
+    cmd = (
+        CATBOOST_PATH,
+        'fit',
+        '--loss-function', 'Logloss',
+        '-f', get_pool_path('train', True),
+        '-t', get_pool_path('test', True),
+        '-i', '10',
+        '--leaf-estimation-method', leaf_estimation_method,
+        '--boosting-type', 'Plain',
+        '-T', '4',
+        '-m', output_model_path,
+        '--use-best-model', 'false'
+    )
+    yatest.common.execute(cmd)
+
+    def run_ostr(train, test, output_path, cd=None):
+        cmd = (
+            CATBOOST_PATH,
+            'ostr',
+            '-f', train,
+            '-t', test,
+            '-m', output_model_path,
+            '-o', output_path,
+        )
+        if cd:
+            cmd += ('--column-description', cd)
+        yatest.common.execute(cmd)
+
+    run_ostr(get_pool_path('train'), get_pool_path('test'), object_importances_path, data_file('querywise', 'train.cd'))
+    run_ostr(get_pool_path('train', True), get_pool_path('test', True), quantized_object_importances_path)
+
+    assert filecmp.cmp(object_importances_path, quantized_object_importances_path)
+
+
 # Create `num_tests` test files from `test_input_path`.
 def split_test_to(num_tests, test_input_path):
     test_input_lines = open(test_input_path).readlines()
@@ -170,6 +170,8 @@ class EFstrType(Enum):
     Interaction = 1
     """Calculate SHAP Values for every object."""
     ShapValues = 2
+    """Calculate loss function change on dataset for every feature removed from the model."""
+    LossFunctionChange = 3
 
 
 class Pool(_PoolBase):
@@ -1496,9 +1498,11 @@ class CatBoost(_CatBoostBase):
                     Calculate SHAP Values for every object.
                 - Interaction
                     Calculate pairwise score between every feature.
+                - LossFunctionChange
+                    Calculate increase of the model loss function on data for every feature removed from the model.
 
         prettified : bool, optional (default=False)
-            used only for FeatureImportance fstr_type
+            used only for FeatureImportance and LossFunctionChange fstr_type
             change returned data format to the list of (feature_id, importance) pairs sorted by importance
 
         thread_count : int, optional (default=-1)
@@ -1525,6 +1529,8 @@ class CatBoost(_CatBoostBase):
                 Values are calculated for RawFormulaVal predictions.
             - Interaction
                 list of length [n_features] of 3-element lists of (first_feature_index, second_feature_index, interaction_score (float))
+            - LossFunctionChange
+                same as FeatureImportance, values are loss function increases (float) on data for every feature
         """
 
         if not isinstance(verbose, bool) and not isinstance(verbose, int):
@@ -1544,7 +1550,7 @@ class CatBoost(_CatBoostBase):
 
         with log_fixup():
             fstr, feature_names = self._calc_fstr(fstr_type, data, thread_count, verbose)
-        if fstr_type == EFstrType.FeatureImportance:
+        if fstr_type in (EFstrType.FeatureImportance, EFstrType.LossFunctionChange):
             feature_importances = [value[0] for value in fstr]
             if prettified:
                 return sorted(zip(feature_names, feature_importances), key=itemgetter(1), reverse=True)
@@ -1657,6 +1663,9 @@ class CatBoost(_CatBoostBase):
                 * coreml_model_version : string
                 * coreml_model_author : string
                 * coreml_model_license: string
+            Parameters for C++ export:
+                * specialized_code : bool - generate straight-line code specialized for each tree
+                  (models without categorical features only)
         pool : catboost.Pool or list or numpy.array or pandas.DataFrame or pandas.Series or catboost.FeaturesData
             Training pool.
         """
@@ -1886,6 +1895,9 @@ class CatBoostClassifier(CatBoost):
         To use the order in which objects are represented in the input data
         (do not perform a random permutation on the stages of converting
         the Categ features to Num and the choice of a tree structure).
+    use_quantile_sketch_for_borders : bool, [default=False]
+        Select float feature borders from a streaming quantile sketch of all feature values
+        instead of sorting full (or subsampled) data. Useful for very large datasets.
     allow_const_label : bool, [default=False]
         To allow the constant label value in dataset.
     classes_count : int, [default=None]
@@ -1953,6 +1965,9 @@ class CatBoostClassifier(CatBoost):
     approx_on_full_history : bool, [default=False]
         If this flag is set to True, each approximated value is calculated using all the preceeding rows in the fold (slower, more accurate).
         If this flag is set to False, each approximated value is calculated using only the beginning 1/fold_len_multiplier fraction of the fold (faster, slightly less accurate).
+    single_precision_fold_approxes : bool, [default=False]
+        Keep approxes of learning folds in single precision between iterations to reduce memory usage
+        (mostly useful for Ordered boosting on large datasets). Derivatives are still calculated in double precision.
     boosting_type : string, default value depends on object count and feature count in train dataset and on learning mode.
         Boosting scheme.
         Possible values:
@@ -2043,6 +2058,7 @@ class CatBoostClassifier(CatBoost):
         max_ctr_complexity=None,
         has_time=None,
         allow_const_label=None,
+        use_quantile_sketch_for_borders=None,
         classes_count=None,
         class_weights=None,
         class_names=None,
@@ -2065,6 +2081,7 @@ class CatBoostClassifier(CatBoost):
         allow_writing_files=None,
         final_ctr_computation_mode=None,
         approx_on_full_history=None,
+        single_precision_fold_approxes=None,
         boosting_type=None,
         simple_ctr=None,
         combinations_ctr=None,
@@ -2421,6 +2438,7 @@ class CatBoostRegressor(CatBoost):
         max_ctr_complexity=None,
         has_time=None,
         allow_const_label=None,
+        use_quantile_sketch_for_borders=None,
         one_hot_max_size=None,
         random_strength=None,
         name=None,
@@ -2439,6 +2457,7 @@ class CatBoostRegressor(CatBoost):
         allow_writing_files=None,
         final_ctr_computation_mode=None,
         approx_on_full_history=None,
+        single_precision_fold_approxes=None,
         boosting_type=None,
         simple_ctr=None,
         combinations_ctr=None,
@@ -1731,6 +1731,18 @@ def test_shap_feature_importance(task_type):
     return local_canonical_file(fimp_npy_path)
 
 
+def test_loss_function_change_feature_importance(task_type):
+    pool = Pool(TRAIN_FILE, column_description=CD_FILE)
+    test_pool = Pool(TEST_FILE, column_description=CD_FILE)
+    ignored_feature = 3
+    model = CatBoostClassifier(iterations=5, learning_rate=0.03, ignored_features=[ignored_feature], task_type=task_type, devices='0')
+    model.fit(pool)
+    fimp = model.get_feature_importance(fstr_type=EFstrType.LossFunctionChange, data=test_pool)
+    assert len(fimp) == pool.num_col()
+    assert fimp[ignored_feature] == 0
+    assert any(value != 0 for value in fimp)
+
+
 def test_od(task_type):
     train_pool = Pool(TRAIN_FILE, column_description=CD_FILE)
     test_pool = Pool(TEST_FILE, column_description=CD_FILE)
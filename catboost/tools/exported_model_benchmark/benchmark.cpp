@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/*
+ * Benchmark for exported C++ models without categorical features, reports per document apply time.
+ * It is not a part of the test suite and is built together with an exported model by hand:
+ *   g++ -std=c++14 -O2 -march=native -o generic.exe benchmark.cpp model.cpp
+ *   g++ -std=c++14 -O2 -march=native -DWITH_BATCH_APPLY -o specialized.exe benchmark.cpp specialized_model.cpp
+ * Build with -DWITH_BATCH_APPLY for models exported with "specialized_code" user param.
+ * Usage: benchmark.exe features.tsv repetitions
+ * features.tsv contains float features only, one document per line.
+ */
+
+constexpr char DELIMITER = '\t';
+
+extern double ApplyCatboostModel(const vector<float>& features);
+#ifdef WITH_BATCH_APPLY
+extern void ApplyCatboostModelBatch(const float* features, size_t rowStride, size_t docCount, double* results);
+#endif
+
+static vector<vector<float>> ReadFeatures(const string& path) {
+    vector<vector<float>> result;
+    ifstream input(path);
+    string line;
+    while (getline(input, line)) {
+        vector<float> features;
+        string token;
+        istringstream tokens(line);
+        while (getline(tokens, token, DELIMITER)) {
+            features.push_back(stof(token));
+        }
+        result.push_back(move(features));
+    }
+    return result;
+}
+
+template <typename TFunc>
+static double MeasureNsPerDoc(size_t docCount, int repetitions, TFunc func) {
+    const auto start = chrono::steady_clock::now();
+    for (int i = 0; i < repetitions; ++i) {
+        func();
+    }
+    const auto finish = chrono::steady_clock::now();
+    return chrono::duration<double, nano>(finish - start).count() / (docCount * repetitions);
+}
+
+int main(int argc, char* argv[]) {
+    assert(argc == 3);
+    const vector<vector<float>> features = ReadFeatures(argv[1]);
+    const int repetitions = stoi(argv[2]);
+    assert(!features.empty());
+    const size_t docCount = features.size();
+
+    double checksum = 0;
+    vector<double> results(docCount);
+    const double singleNs = MeasureNsPerDoc(docCount, repetitions, [&] () {
+        for (size_t docId = 0; docId < docCount; ++docId) {
+            results[docId] = ApplyCatboostModel(features[docId]);
+        }
+        checksum += results.back();
+    });
+    cout << "single\t" << singleNs << " ns/doc" << endl;
+
+#ifdef WITH_BATCH_APPLY
+    const size_t rowStride = features[0].size();
+    vector<float> flatFeatures;
+    for (const auto& docFeatures : features) {
+        assert(docFeatures.size() == rowStride);
+        flatFeatures.insert(flatFeatures.end(), docFeatures.begin(), docFeatures.end());
+    }
+    vector<double> batchResults(docCount);
+    const double batchNs = MeasureNsPerDoc(docCount, repetitions, [&] () {
+        ApplyCatboostModelBatch(flatFeatures.data(), rowStride, docCount, batchResults.data());
+        checksum += batchResults.back();
+    });
+    cout << "batch\t" << batchNs << " ns/doc" << endl;
+    for (size_t docId = 0; docId < docCount; ++docId) {
+        assert(abs(results[docId] - batchResults[docId]) < 1e-9);
+    }
+#endif
+    cerr << "checksum\t" << checksum << endl;
+    return 0;
+}
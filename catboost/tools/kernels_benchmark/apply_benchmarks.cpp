@@ -0,0 +1,296 @@
+#include "benchmark.h"
+#include "synthetic_data.h"
+
+#include <catboost/libs/data_new/data_provider.h>
+#include <catboost/libs/fstr/shap_values.h>
+#include <catboost/libs/model/formula_evaluator.h>
+#include <catboost/libs/model/model.h>
+#include <catboost/libs/model/model_build_helper.h>
+#include <catboost/libs/train_lib/train_model.h>
+
+#include <library/json/json_value.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+#include <util/random/fast.h>
+#include <util/string/builder.h>
+
+
+using namespace NCB;
+
+
+namespace NKernelsBenchmark {
+
+    static const TVector<ui64> DocCounts = {10000, 100000, 1000000};
+
+
+    // float features model with random splits, leaf weights are set so SHAP values can be prepared
+    static TFullModel CreateSyntheticModel(
+        ui32 floatFeatureCount,
+        ui32 borderCount,
+        ui32 treeCount,
+        int depth,
+        TFastRng64* rng
+    ) {
+        TVector<TFloatFeature> floatFeatures;
+        for (auto featureIdx : xrange(floatFeatureCount)) {
+            floatFeatures.emplace_back(/*hasNans*/ false, featureIdx, featureIdx, TVector<float>());
+        }
+        const TVector<float> borders = GenerateBorders(borderCount);
+
+        TObliviousTreeBuilder builder(floatFeatures, TVector<TCatFeature>(), /*approxDimension*/ 1);
+        const size_t leafCount = size_t(1) << depth;
+        for (auto treeIdx : xrange(treeCount)) {
+            Y_UNUSED(treeIdx);
+            TVector<TModelSplit> splits;
+            for (auto splitIdx : xrange(depth)) {
+                Y_UNUSED(splitIdx);
+                splits.emplace_back(TFloatSplit(rng->Uniform(floatFeatureCount), borders[rng->Uniform(borderCount)]));
+            }
+            TVector<double> leafValues(leafCount);
+            TVector<double> leafWeights(leafCount);
+            for (auto leafIdx : xrange(leafCount)) {
+                leafValues[leafIdx] = rng->GenRandReal1() - 0.5;
+                leafWeights[leafIdx] = 1 + rng->Uniform(100);
+            }
+            builder.AddTree(splits, leafValues, leafWeights);
+        }
+
+        TFullModel model;
+        model.ObliviousTrees = builder.Build();
+        model.UpdateDynamicData();
+        return model;
+    }
+
+    // model with online CTR splits trained on synthetic data with `catFeatureCount` categorical features
+    static TFullModel TrainCtrModel(
+        ui32 floatFeatureCount,
+        ui32 catFeatureCount,
+        const TVector<ui32>& catFeatureValueHashes,
+        const TBenchmarkOptions& options
+    ) {
+        const ui32 objectCount = 20000;
+        TFastRng64 rng(options.Seed);
+        auto floatFeatures = GenerateFloatFeatures(floatFeatureCount, objectCount, &rng);
+        auto catFeatures = GenerateCatFeatures(catFeatureCount, objectCount, catFeatureValueHashes, &rng);
+        auto target = GenerateBinaryTarget(floatFeatures, objectCount, &rng);
+
+        TDataProviders dataProviders;
+        dataProviders.Learn = CreateRawDataProvider(
+            objectCount,
+            std::move(floatFeatures),
+            std::move(catFeatures),
+            std::move(target));
+
+        NJson::TJsonValue params;
+        params.InsertValue("loss_function", "Logloss");
+        params.InsertValue("iterations", 50);
+        params.InsertValue("depth", 6);
+        params.InsertValue("random_seed", options.Seed);
+        params.InsertValue("thread_count", options.ThreadCount);
+        params.InsertValue("allow_writing_files", false);
+        params.InsertValue("logging_level", "Silent");
+
+        TFullModel model;
+        TrainModel(params, nullptr, Nothing(), Nothing(), std::move(dataProviders), "", &model, {});
+        CB_ENSURE(!model.ObliviousTrees.GetUsedModelCtrs().empty(), "Trained model has no CTR splits");
+        return model;
+    }
+
+    // binarized features, hashes of categorical features and CTR values for each block of evaluation
+    struct TBinarizedBlock {
+        size_t DocCount = 0;
+        TVector<ui8> BinarizedFeatures;
+        TVector<ui32> TransposedHash;
+        TVector<float> Ctrs;
+    };
+
+    static TVector<TBinarizedBlock> BinarizeByBlocks(
+        const TFullModel& model,
+        const TVector<TVector<float>>& floatFeatures, // [flatFeatureIdx][docIdx]
+        const TVector<TVector<ui32>>& catFeatures,    // [catFeatureIdx][docIdx], flat indices follow float features
+        size_t docCount
+    ) {
+        const size_t floatFeatureCount = floatFeatures.size();
+        const auto floatAccessor = [&] (const TFloatFeature& floatFeature, size_t docIdx) -> float {
+            return floatFeatures[floatFeature.FlatFeatureIndex][docIdx];
+        };
+        const auto catAccessor = [&] (const TCatFeature& catFeature, size_t docIdx) -> ui32 {
+            return catFeatures[catFeature.FlatFeatureIndex - floatFeatureCount][docIdx];
+        };
+
+        const size_t usedCtrCount = model.ObliviousTrees.GetUsedModelCtrs().size();
+        TVector<TBinarizedBlock> blocks;
+        for (size_t blockStart = 0; blockStart < docCount; blockStart += FORMULA_EVALUATION_BLOCK_SIZE) {
+            auto& block = blocks.emplace_back();
+            block.DocCount = Min<size_t>(FORMULA_EVALUATION_BLOCK_SIZE, docCount - blockStart);
+            block.BinarizedFeatures.yresize(
+                block.DocCount * model.ObliviousTrees.GetEffectiveBinaryFeaturesBucketsCount());
+            block.TransposedHash.yresize(block.DocCount * model.GetUsedCatFeaturesCount());
+            block.Ctrs.yresize(block.DocCount * usedCtrCount);
+            BinarizeFeatures(
+                model,
+                floatAccessor,
+                catAccessor,
+                blockStart,
+                blockStart + block.DocCount,
+                block.BinarizedFeatures,
+                block.TransposedHash,
+                block.Ctrs);
+        }
+        return blocks;
+    }
+
+
+    static TBenchmark MakeBinarizeFloatsBenchmark(ui32 borderCount) {
+        return {
+            TStringBuilder() << "BinarizeFloats[borders=" << borderCount << "]",
+            DocCounts,
+            [borderCount] (ui64 size, const TBenchmarkOptions& options, NPar::TLocalExecutor*) {
+                TFastRng64 rng(options.Seed);
+                auto values = MakeAtomicShared<TVector<float>>(std::move(GenerateFloatFeatures(1, size, &rng)[0]));
+                auto borders = MakeAtomicShared<TVector<float>>(GenerateBorders(borderCount));
+                const size_t bucketCount = (borderCount + MAX_VALUES_PER_BIN - 1) / MAX_VALUES_PER_BIN;
+                auto result = MakeAtomicShared<TVector<ui8>>(FORMULA_EVALUATION_BLOCK_SIZE * bucketCount);
+
+                TBenchmarkCase benchmarkCase;
+                benchmarkCase.ItemCount = size;
+                benchmarkCase.BytesPerItem = sizeof(float) + bucketCount * sizeof(ui8);
+                benchmarkCase.Run = [=] () {
+                    const float* valuesPtr = values->data();
+                    for (size_t blockStart = 0; blockStart < size; blockStart += FORMULA_EVALUATION_BLOCK_SIZE) {
+                        const size_t docCount = Min<size_t>(FORMULA_EVALUATION_BLOCK_SIZE, size - blockStart);
+                        Fill(result->begin(), result->end(), 0);
+                        ui8* resultPtr = result->data();
+                        BinarizeFloats<false>(
+                            docCount,
+                            [valuesPtr] (size_t docIdx) { return valuesPtr[docIdx]; },
+                            *borders,
+                            blockStart,
+                            resultPtr);
+                    }
+                };
+                return benchmarkCase;
+            }
+        };
+    }
+
+    // tree leaf indices and approxes calculation from binarized features (CalcIndexesSseDepthed on SSE builds)
+    static TBenchmark MakeCalcTreesBenchmark(int depth) {
+        return {
+            TStringBuilder() << "CalcTrees[depth=" << depth << ",trees=1000]",
+            DocCounts,
+            [depth] (ui64 size, const TBenchmarkOptions& options, NPar::TLocalExecutor*) {
+                const ui32 floatFeatureCount = 50;
+                TFastRng64 rng(options.Seed);
+                auto model = MakeAtomicShared<TFullModel>(
+                    CreateSyntheticModel(floatFeatureCount, /*borderCount*/ 64, /*treeCount*/ 1000, depth, &rng));
+                auto blocks = MakeAtomicShared<TVector<TBinarizedBlock>>(
+                    BinarizeByBlocks(*model, GenerateFloatFeatures(floatFeatureCount, size, &rng), {}, size));
+                auto calcTrees = GetCalcTreesFunction(*model, FORMULA_EVALUATION_BLOCK_SIZE);
+                auto indexes = MakeAtomicShared<TVector<TCalcerIndexType>>(FORMULA_EVALUATION_BLOCK_SIZE);
+                auto results = MakeAtomicShared<TVector<double>>(size);
+
+                TBenchmarkCase benchmarkCase;
+                benchmarkCase.ItemCount = size;
+                benchmarkCase.BytesPerItem
+                    = model->ObliviousTrees.GetEffectiveBinaryFeaturesBucketsCount() * sizeof(ui8) + sizeof(double);
+                benchmarkCase.Run = [=] () {
+                    Fill(results->begin(), results->end(), 0.0);
+                    size_t blockStart = 0;
+                    for (const auto& block : *blocks) {
+                        calcTrees(
+                            *model,
+                            block.BinarizedFeatures.data(),
+                            block.DocCount,
+                            indexes->data(),
+                            0,
+                            model->GetTreeCount(),
+                            results->data() + blockStart);
+                        blockStart += block.DocCount;
+                    }
+                };
+                return benchmarkCase;
+            }
+        };
+    }
+
+    // CTR values calculation from hashed categorical features with the model CTR tables
+    static TBenchmark MakeCalcCtrsBenchmark() {
+        return {
+            "CalcCtrs[cat_features=4,unique_values=1000]",
+            DocCounts,
+            [] (ui64 size, const TBenchmarkOptions& options, NPar::TLocalExecutor*) {
+                const ui32 floatFeatureCount = 4;
+                const ui32 catFeatureCount = 4;
+                const auto valueHashes = GenerateCatFeatureHashes(/*uniqueValueCount*/ 1000);
+                auto model = MakeAtomicShared<TFullModel>(
+                    TrainCtrModel(floatFeatureCount, catFeatureCount, valueHashes, options));
+
+                TFastRng64 rng(options.Seed + 1);
+                auto blocks = MakeAtomicShared<TVector<TBinarizedBlock>>(
+                    BinarizeByBlocks(
+                        *model,
+                        GenerateFloatFeatures(floatFeatureCount, size, &rng),
+                        GenerateCatFeatures(catFeatureCount, size, valueHashes, &rng),
+                        size));
+                const size_t usedCtrCount = model->ObliviousTrees.GetUsedModelCtrs().size();
+                auto ctrs = MakeAtomicShared<TVector<float>>(FORMULA_EVALUATION_BLOCK_SIZE * usedCtrCount);
+
+                TBenchmarkCase benchmarkCase;
+                benchmarkCase.ItemCount = size;
+                benchmarkCase.BytesPerItem
+                    = model->GetUsedCatFeaturesCount() * sizeof(ui32) + usedCtrCount * sizeof(float);
+                benchmarkCase.Run = [=] () {
+                    for (const auto& block : *blocks) {
+                        model->CtrProvider->CalcCtrs(
+                            model->ObliviousTrees.GetUsedModelCtrs(),
+                            block.BinarizedFeatures,
+                            block.TransposedHash,
+                            block.DocCount,
+                            MakeArrayRef(ctrs->data(), block.DocCount * usedCtrCount));
+                    }
+                };
+                return benchmarkCase;
+            }
+        };
+    }
+
+    // SHAP values preparation for each leaf of each tree (CalcShapValuesForLeafRecursive)
+    static TBenchmark MakePrepareShapTreesBenchmark(int depth) {
+        return {
+            TStringBuilder() << "PrepareShapTrees[depth=" << depth << "]",
+            /*treeCounts*/ {10, 100, 1000},
+            [depth] (ui64 size, const TBenchmarkOptions& options, NPar::TLocalExecutor* localExecutor) {
+                const ui32 floatFeatureCount = 50;
+                TFastRng64 rng(options.Seed);
+                auto model = MakeAtomicShared<TFullModel>(
+                    CreateSyntheticModel(floatFeatureCount, /*borderCount*/ 64, size, depth, &rng));
+
+                TBenchmarkCase benchmarkCase;
+                benchmarkCase.ItemName = "leaf";
+                benchmarkCase.ItemCount = size << depth;
+                // leaf value and weight, SHAP value for each split on the path to the leaf
+                benchmarkCase.BytesPerItem = 2 * sizeof(double) + depth * (sizeof(int) + sizeof(double));
+                benchmarkCase.Run = [=] () {
+                    PrepareTrees(*model, localExecutor);
+                };
+                return benchmarkCase;
+            }
+        };
+    }
+
+
+    TVector<TBenchmark> GetApplyBenchmarks() {
+        return {
+            MakeBinarizeFloatsBenchmark(/*borderCount*/ 32),
+            MakeBinarizeFloatsBenchmark(/*borderCount*/ 254),
+            MakeCalcTreesBenchmark(/*depth*/ 6),
+            MakeCalcTreesBenchmark(/*depth*/ 8),
+            MakeCalcCtrsBenchmark(),
+            MakePrepareShapTreesBenchmark(/*depth*/ 6),
+            MakePrepareShapTreesBenchmark(/*depth*/ 8)
+        };
+    }
+}
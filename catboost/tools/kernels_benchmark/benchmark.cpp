@@ -0,0 +1,57 @@
+#include "benchmark.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+#include <util/stream/format.h>
+#include <util/system/hp_timer.h>
+
+
+namespace NKernelsBenchmark {
+
+    TBenchmarkResult RunBenchmark(
+        const TBenchmark& benchmark,
+        ui64 size,
+        const TBenchmarkOptions& options,
+        NPar::TLocalExecutor* localExecutor
+    ) {
+        CB_ENSURE(options.Repetitions > 0, "Number of repetitions must be positive");
+
+        TBenchmarkCase benchmarkCase = benchmark.Setup(size, options, localExecutor);
+        CB_ENSURE(benchmarkCase.ItemCount > 0, "Benchmark " << benchmark.Name << " has no items to process");
+
+        benchmarkCase.Run(); // warm-up
+
+        TVector<double> nsPerItem;
+        for (auto repetition : xrange(options.Repetitions)) {
+            Y_UNUSED(repetition);
+            THPTimer timer;
+            benchmarkCase.Run();
+            nsPerItem.push_back(timer.Passed() * 1e9 / benchmarkCase.ItemCount);
+        }
+        Sort(nsPerItem);
+
+        TBenchmarkResult result;
+        result.Name = benchmark.Name;
+        result.Size = size;
+        result.ItemName = benchmarkCase.ItemName;
+        result.MinNsPerItem = nsPerItem.front();
+        result.MedianNsPerItem = nsPerItem[nsPerItem.size() / 2];
+        result.BytesPerItem = benchmarkCase.BytesPerItem;
+        return result;
+    }
+
+    void OutputResultsHeader(IOutputStream* out) {
+        *out << "benchmark\tsize\titem\tmin_ns_per_item\tmedian_ns_per_item\tbytes_per_item\n";
+    }
+
+    void OutputResult(const TBenchmarkResult& result, IOutputStream* out) {
+        *out << result.Name << '\t'
+            << result.Size << '\t'
+            << result.ItemName << '\t'
+            << Prec(result.MinNsPerItem, PREC_POINT_DIGITS, 3) << '\t'
+            << Prec(result.MedianNsPerItem, PREC_POINT_DIGITS, 3) << '\t'
+            << result.BytesPerItem << Endl;
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/generic/ylimits.h>
+#include <util/stream/output.h>
+#include <util/system/types.h>
+
+#include <functional>
+
+
+namespace NKernelsBenchmark {
+
+    struct TBenchmarkOptions {
+        ui64 Seed = 0;
+        int ThreadCount = 1;
+        ui32 Repetitions = 5;
+        ui64 MaxSize = Max<ui64>(); // cases with larger size are skipped
+    };
+
+    /* Prepared benchmark case.
+     * Inputs are generated by setup, so only Run is measured. Run must be repeatable.
+     */
+    struct TBenchmarkCase {
+        TString ItemName = "doc";  // unit of work per item statistics are reported in
+        ui64 ItemCount = 0;
+        ui64 BytesPerItem = 0;     // input and output data touched by the kernel per item
+        std::function<void()> Run;
+    };
+
+    using TBenchmarkSetup = std::function<TBenchmarkCase(
+        ui64 size,
+        const TBenchmarkOptions& options,
+        NPar::TLocalExecutor* localExecutor)>;
+
+    struct TBenchmark {
+        TString Name;
+        TVector<ui64> Sizes;
+        TBenchmarkSetup Setup;
+    };
+
+    struct TBenchmarkResult {
+        TString Name;
+        ui64 Size = 0;
+        TString ItemName;
+        double MinNsPerItem = 0;
+        double MedianNsPerItem = 0;
+        ui64 BytesPerItem = 0;
+    };
+
+    // benchmarks of model apply and feature importance kernels
+    TVector<TBenchmark> GetApplyBenchmarks();
+
+    // benchmarks of data loading, quantization and training kernels
+    TVector<TBenchmark> GetTrainingBenchmarks();
+
+    // one warm-up run and options.Repetitions measured runs
+    TBenchmarkResult RunBenchmark(
+        const TBenchmark& benchmark,
+        ui64 size,
+        const TBenchmarkOptions& options,
+        NPar::TLocalExecutor* localExecutor);
+
+    void OutputResultsHeader(IOutputStream* out);
+    void OutputResult(const TBenchmarkResult& result, IOutputStream* out);
+}
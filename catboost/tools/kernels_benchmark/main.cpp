@@ -0,0 +1,68 @@
+/* Microbenchmarks of CPU training and apply kernels on synthetic data.
+ *
+ * Results are written to stdout as tab-separated values with columns
+ *   benchmark, size, item, min_ns_per_item, median_ns_per_item, bytes_per_item
+ * so that runs before and after a kernel change can be compared with any diff or spreadsheet tool.
+ */
+
+#include "benchmark.h"
+
+#include <library/getopt/small/last_getopt.h>
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/stream/output.h>
+
+
+using namespace NKernelsBenchmark;
+
+
+int main(int argc, char** argv) {
+    using namespace NLastGetopt;
+    TBenchmarkOptions options;
+    TString filter;
+    TOpts opts = NLastGetopt::TOpts::Default();
+    opts.AddLongOption("filter").RequiredArgument("SUBSTRING")
+        .Help("Run only benchmarks with names containing SUBSTRING")
+        .DefaultValue("")
+        .StoreResult(&filter);
+    opts.AddLongOption("max-size").RequiredArgument("SIZE")
+        .Help("Skip benchmark cases with size greater than SIZE")
+        .DefaultValue(options.MaxSize)
+        .StoreResult(&options.MaxSize);
+    opts.AddLongOption("repetitions").RequiredArgument("N")
+        .Help("Number of measured runs of each benchmark case")
+        .DefaultValue(options.Repetitions)
+        .StoreResult(&options.Repetitions);
+    opts.AddLongOption('T', "thread-count").RequiredArgument("N")
+        .Help("Number of threads used by kernels")
+        .DefaultValue(options.ThreadCount)
+        .StoreResult(&options.ThreadCount);
+    opts.AddLongOption("seed").RequiredArgument("SEED")
+        .Help("Random seed for synthetic data generation")
+        .DefaultValue(options.Seed)
+        .StoreResult(&options.Seed);
+    TOptsParseResult args(&opts, argc, argv);
+
+    NPar::TLocalExecutor localExecutor;
+    localExecutor.RunAdditionalThreads(options.ThreadCount - 1);
+
+    TVector<TBenchmark> benchmarks = GetApplyBenchmarks();
+    for (auto& benchmark : GetTrainingBenchmarks()) {
+        benchmarks.push_back(std::move(benchmark));
+    }
+
+    OutputResultsHeader(&Cout);
+    for (const auto& benchmark : benchmarks) {
+        if (!benchmark.Name.Contains(filter)) {
+            continue;
+        }
+        for (auto size : benchmark.Sizes) {
+            if (size > options.MaxSize) {
+                continue;
+            }
+            Cerr << "Running " << benchmark.Name << " on size " << size << Endl;
+            OutputResult(RunBenchmark(benchmark, size, options, &localExecutor), &Cout);
+        }
+    }
+    return 0;
+}
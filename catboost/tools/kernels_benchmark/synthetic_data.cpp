@@ -0,0 +1,116 @@
+#include "synthetic_data.h"
+
+#include <catboost/libs/cat_feature/cat_feature.h>
+#include <catboost/libs/data_new/data_provider_builders.h>
+
+#include <util/generic/xrange.h>
+#include <util/string/cast.h>
+
+
+using namespace NCB;
+
+
+namespace NKernelsBenchmark {
+
+    TVector<TVector<float>> GenerateFloatFeatures(ui32 featureCount, ui32 objectCount, TFastRng64* rng) {
+        TVector<TVector<float>> features(featureCount);
+        for (auto& feature : features) {
+            feature.yresize(objectCount);
+            for (auto& value : feature) {
+                value = rng->GenRandReal1();
+            }
+        }
+        return features;
+    }
+
+    TVector<ui32> GenerateCatFeatureHashes(ui32 uniqueValueCount) {
+        TVector<ui32> hashes;
+        hashes.yresize(uniqueValueCount);
+        for (auto valueIdx : xrange(uniqueValueCount)) {
+            hashes[valueIdx] = CalcCatFeatureHash(ToString(valueIdx));
+        }
+        return hashes;
+    }
+
+    TVector<TVector<ui32>> GenerateCatFeatures(
+        ui32 featureCount,
+        ui32 objectCount,
+        const TVector<ui32>& valueHashes,
+        TFastRng64* rng
+    ) {
+        TVector<TVector<ui32>> features(featureCount);
+        for (auto& feature : features) {
+            feature.yresize(objectCount);
+            for (auto& value : feature) {
+                value = valueHashes[rng->Uniform(valueHashes.size())];
+            }
+        }
+        return features;
+    }
+
+    TVector<float> GenerateBinaryTarget(const TVector<TVector<float>>& floatFeatures, ui32 objectCount, TFastRng64* rng) {
+        TVector<float> target;
+        target.yresize(objectCount);
+        for (auto objectIdx : xrange(objectCount)) {
+            const double probability = floatFeatures.empty() ? 0.5 : floatFeatures[0][objectIdx];
+            target[objectIdx] = rng->GenRandReal1() < probability ? 1.0f : 0.0f;
+        }
+        return target;
+    }
+
+    TVector<float> GenerateBorders(ui32 borderCount) {
+        TVector<float> borders;
+        borders.yresize(borderCount);
+        for (auto borderIdx : xrange(borderCount)) {
+            borders[borderIdx] = float(borderIdx + 1) / (borderCount + 1);
+        }
+        return borders;
+    }
+
+    TDataProviderPtr CreateRawDataProvider(
+        ui32 objectCount,
+        TVector<TVector<float>>&& floatFeatures,
+        TVector<TVector<ui32>>&& catFeatures,
+        TVector<float>&& target
+    ) {
+        const ui32 floatFeatureCount = floatFeatures.size();
+        const ui32 catFeatureCount = catFeatures.size();
+
+        TVector<ui32> catFeatureIndices;
+        for (auto catFeatureIdx : xrange(catFeatureCount)) {
+            catFeatureIndices.push_back(floatFeatureCount + catFeatureIdx);
+        }
+
+        return CreateDataProvider(
+            [&] (IRawFeaturesOrderDataVisitor* visitor) {
+                TDataMetaInfo metaInfo;
+                metaInfo.HasTarget = !target.empty();
+                metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                    floatFeatureCount + catFeatureCount,
+                    catFeatureIndices,
+                    TVector<TString>{}
+                );
+
+                visitor->Start(metaInfo, objectCount, EObjectsOrder::Undefined, {});
+
+                for (auto floatFeatureIdx : xrange(floatFeatureCount)) {
+                    visitor->AddFloatFeature(
+                        floatFeatureIdx,
+                        TMaybeOwningConstArrayHolder<float>::CreateOwning(std::move(floatFeatures[floatFeatureIdx]))
+                    );
+                }
+                for (auto catFeatureIdx : xrange(catFeatureCount)) {
+                    visitor->AddCatFeature(
+                        floatFeatureCount + catFeatureIdx,
+                        TMaybeOwningConstArrayHolder<ui32>::CreateOwning(std::move(catFeatures[catFeatureIdx]))
+                    );
+                }
+                if (!target.empty()) {
+                    visitor->AddTarget(target);
+                }
+
+                visitor->Finish();
+            }
+        );
+    }
+}
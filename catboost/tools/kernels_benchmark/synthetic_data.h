@@ -0,0 +1,43 @@
+#pragma once
+
+#include <catboost/libs/data_new/data_provider.h>
+
+#include <util/generic/vector.h>
+#include <util/random/fast.h>
+#include <util/system/types.h>
+
+
+namespace NKernelsBenchmark {
+
+    /* All generators are deterministic for a given rng state, so results are comparable between runs
+     * and between revisions.
+     */
+
+    // [featureIdx][objectIdx], uniform in [0, 1)
+    TVector<TVector<float>> GenerateFloatFeatures(ui32 featureCount, ui32 objectCount, TFastRng64* rng);
+
+    // hashes of `uniqueValueCount` distinct string values, as they are stored for raw data
+    TVector<ui32> GenerateCatFeatureHashes(ui32 uniqueValueCount);
+
+    // [featureIdx][objectIdx], values are sampled uniformly from `valueHashes`
+    TVector<TVector<ui32>> GenerateCatFeatures(
+        ui32 featureCount,
+        ui32 objectCount,
+        const TVector<ui32>& valueHashes,
+        TFastRng64* rng);
+
+    // 0 or 1 with probability depending on the first float feature to make CTRs and splits meaningful
+    TVector<float> GenerateBinaryTarget(const TVector<TVector<float>>& floatFeatures, ui32 objectCount, TFastRng64* rng);
+
+    // `borderCount` borders evenly spaced in (0, 1)
+    TVector<float> GenerateBorders(ui32 borderCount);
+
+    /* float features have flat indices [0, floatFeatureCount), categorical features follow them
+     * dataset has no target if `target` is empty
+     */
+    NCB::TDataProviderPtr CreateRawDataProvider(
+        ui32 objectCount,
+        TVector<TVector<float>>&& floatFeatures,
+        TVector<TVector<ui32>>&& catFeatures,
+        TVector<float>&& target);
+}
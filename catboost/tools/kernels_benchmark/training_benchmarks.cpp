@@ -0,0 +1,366 @@
+#include "benchmark.h"
+#include "synthetic_data.h"
+
+#include <catboost/libs/algo/fold.h>
+#include <catboost/libs/algo/learn_context.h>
+#include <catboost/libs/algo/online_ctr.h>
+#include <catboost/libs/algo/score_calcer.h>
+#include <catboost/libs/algo/tensor_search_helpers.h>
+#include <catboost/libs/cat_feature/cat_feature.h>
+#include <catboost/libs/column_description/column.h>
+#include <catboost/libs/data_new/dsv_parser.h>
+#include <catboost/libs/data_new/meta_info.h>
+#include <catboost/libs/data_new/quantization.h>
+#include <catboost/libs/data_new/visitor.h>
+#include <catboost/libs/labels/label_converter.h>
+#include <catboost/libs/options/catboost_options.h>
+#include <catboost/libs/options/output_file_options.h>
+#include <catboost/libs/options/plain_options_helper.h>
+#include <catboost/libs/train_lib/data.h>
+
+#include <library/json/json_value.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/string/builder.h>
+
+
+using namespace NCB;
+
+
+namespace NKernelsBenchmark {
+
+    static const TVector<ui64> DocCounts = {10000, 100000, 1000000};
+
+
+    // quantized training data and learn context initialized as before the first iteration
+    struct TTrainingEnvironment {
+        TTrainingForCPUDataProviders Data;
+        THolder<TLearnContext> Ctx;
+    };
+
+    static TAtomicSharedPtr<TTrainingEnvironment> CreateTrainingEnvironment(
+        ui32 objectCount,
+        ui32 floatFeatureCount,
+        ui32 catFeatureCount,
+        ui32 catFeatureUniqueValueCount,
+        const TBenchmarkOptions& options,
+        NPar::TLocalExecutor* localExecutor
+    ) {
+        TFastRng64 rng(options.Seed);
+        auto floatFeatures = GenerateFloatFeatures(floatFeatureCount, objectCount, &rng);
+        auto catFeatures = GenerateCatFeatures(
+            catFeatureCount,
+            objectCount,
+            GenerateCatFeatureHashes(catFeatureUniqueValueCount),
+            &rng);
+        auto target = GenerateBinaryTarget(floatFeatures, objectCount, &rng);
+
+        TDataProviders dataProviders;
+        dataProviders.Learn = CreateRawDataProvider(
+            objectCount,
+            std::move(floatFeatures),
+            std::move(catFeatures),
+            std::move(target));
+
+        NJson::TJsonValue plainParams;
+        plainParams.InsertValue("loss_function", "Logloss");
+        plainParams.InsertValue("boosting_type", "Plain");
+        plainParams.InsertValue("bootstrap_type", "No");
+        plainParams.InsertValue("depth", 6);
+        plainParams.InsertValue("random_seed", options.Seed);
+        plainParams.InsertValue("thread_count", options.ThreadCount);
+        plainParams.InsertValue("allow_writing_files", false);
+        NJson::TJsonValue jsonParams;
+        NJson::TJsonValue outputJsonParams;
+        NCatboostOptions::PlainJsonToOptions(plainParams, &jsonParams, &outputJsonParams);
+        auto params = NCatboostOptions::LoadOptions(jsonParams);
+        NCatboostOptions::TOutputFilesOptions outputOptions;
+        outputOptions.Load(outputJsonParams);
+
+        TLabelConverter labelConverter;
+        TRestorableFastRng64 rand(options.Seed);
+        auto environment = MakeAtomicShared<TTrainingEnvironment>();
+        environment->Data = GetTrainingData(
+            std::move(dataProviders),
+            /*bordersFile*/ Nothing(),
+            /*ensureConsecutiveLearnFeaturesDataForCpu*/ true,
+            /*allowWriteFiles*/ false,
+            /*quantizedFeaturesInfo*/ nullptr,
+            &params,
+            &labelConverter,
+            localExecutor,
+            &rand
+        ).Cast<TQuantizedForCPUObjectsDataProvider>();
+
+        environment->Ctx = MakeHolder<TLearnContext>(
+            params,
+            /*objectiveDescriptor*/ Nothing(),
+            /*evalMetricDescriptor*/ Nothing(),
+            outputOptions,
+            environment->Data.Learn->MetaInfo.FeaturesLayout,
+            /*initRand*/ Nothing(),
+            localExecutor);
+        environment->Ctx->LearnProgress.ApproxDimension = 1;
+        environment->Ctx->InitContext(environment->Data);
+        return environment;
+    }
+
+
+    namespace {
+        // consumes parsed values without storing them to measure the parser only
+        class TNullRawObjectsOrderDataVisitor : public IRawObjectsOrderDataVisitor {
+        public:
+            void SetGroupWeights(TVector<float>&&) override {}
+            void SetPairs(TVector<TPair>&&) override {}
+            TMaybeData<TConstArrayRef<TGroupId>> GetGroupIds() const override {
+                return Nothing();
+            }
+
+            void Start(bool, const TDataMetaInfo&, ui32, EObjectsOrder, TVector<TIntrusivePtr<IResourceHolder>>) override {}
+            void StartNextBlock(ui32) override {}
+
+            void AddGroupId(ui32, TGroupId) override {}
+            void AddSubgroupId(ui32, TSubgroupId) override {}
+            void AddTimestamp(ui32, ui64) override {}
+
+            void AddFloatFeature(ui32, ui32, float) override {}
+            void AddAllFloatFeatures(ui32, TConstArrayRef<float>) override {}
+
+            ui32 GetCatFeatureValue(ui32, TStringBuf feature) override {
+                return CalcCatFeatureHash(feature);
+            }
+            void AddCatFeature(ui32, ui32, TStringBuf) override {}
+            void AddAllCatFeatures(ui32, TConstArrayRef<ui32>) override {}
+
+            void AddTarget(ui32, const TString&) override {}
+            void AddTarget(ui32, float) override {}
+            void AddBaseline(ui32, ui32, float) override {}
+            void AddWeight(ui32, float) override {}
+            void AddGroupWeight(ui32, float) override {}
+
+            void Finish() override {}
+        };
+
+        struct TDsvParserInput {
+            TVector<TColumn> Columns;
+            TVector<bool> FeatureIgnored;
+            TFeaturesLayoutPtr FeaturesLayout;
+            TVector<float> FloatFeaturesBuffer;
+            TVector<ui32> CatFeaturesBuffer;
+            TNullRawObjectsOrderDataVisitor Visitor;
+            TVector<TString> Lines;
+        };
+    }
+
+    // parsing of lines with label, 20 numeric and 5 categorical features
+    static TBenchmark MakeDsvLineParserBenchmark() {
+        return {
+            "TDsvLineParser[num=20,categ=5]",
+            DocCounts,
+            [] (ui64 size, const TBenchmarkOptions& options, NPar::TLocalExecutor*) {
+                const ui32 floatFeatureCount = 20;
+                const ui32 catFeatureCount = 5;
+
+                auto input = MakeAtomicShared<TDsvParserInput>();
+                TDataColumnsMetaInfo columnsInfo;
+                columnsInfo.Columns.push_back({EColumn::Label, ""});
+                for (auto featureIdx : xrange(floatFeatureCount)) {
+                    Y_UNUSED(featureIdx);
+                    columnsInfo.Columns.push_back({EColumn::Num, ""});
+                }
+                for (auto featureIdx : xrange(catFeatureCount)) {
+                    Y_UNUSED(featureIdx);
+                    columnsInfo.Columns.push_back({EColumn::Categ, ""});
+                }
+                input->Columns = columnsInfo.Columns;
+                TDataMetaInfo metaInfo(std::move(columnsInfo), false, false);
+                input->FeaturesLayout = metaInfo.FeaturesLayout;
+                input->FeatureIgnored.assign(floatFeatureCount + catFeatureCount, false);
+                input->FloatFeaturesBuffer.yresize(floatFeatureCount);
+                input->CatFeaturesBuffer.yresize(catFeatureCount);
+
+                TFastRng64 rng(options.Seed);
+                ui64 totalLength = 0;
+                input->Lines.reserve(size);
+                for (auto lineIdx : xrange(size)) {
+                    Y_UNUSED(lineIdx);
+                    TStringBuilder line;
+                    line << rng.Uniform(2);
+                    for (auto featureIdx : xrange(floatFeatureCount)) {
+                        Y_UNUSED(featureIdx);
+                        line << '\t' << float(rng.GenRandReal1());
+                    }
+                    for (auto featureIdx : xrange(catFeatureCount)) {
+                        Y_UNUSED(featureIdx);
+                        line << "\tvalue" << rng.Uniform(1000);
+                    }
+                    totalLength += line.size();
+                    input->Lines.push_back(std::move(line));
+                }
+
+                TBenchmarkCase benchmarkCase;
+                benchmarkCase.ItemName = "line";
+                benchmarkCase.ItemCount = size;
+                benchmarkCase.BytesPerItem = totalLength / size;
+                benchmarkCase.Run = [input] () {
+                    TDsvLineParser parser(
+                        '\t',
+                        input->Columns,
+                        input->FeatureIgnored,
+                        input->FeaturesLayout.Get(),
+                        input->FloatFeaturesBuffer,
+                        input->CatFeaturesBuffer,
+                        &input->Visitor);
+                    for (const auto& line : input->Lines) {
+                        const auto errorContext = parser.Parse(line, /*inBlockIdx*/ 0);
+                        Y_VERIFY(!errorContext);
+                    }
+                };
+                return benchmarkCase;
+            }
+        };
+    }
+
+    // building of categorical feature perfect hash for a feature with all values unique
+    static TBenchmark MakeCatFeaturePerfectHashBenchmark() {
+        return {
+            "CatFeaturePerfectHash[all_values_unique]",
+            {100000, 1000000, 10000000},
+            [] (ui64 size, const TBenchmarkOptions& options, NPar::TLocalExecutor* localExecutor) {
+                TVector<TVector<ui32>> catFeatures(1, GenerateCatFeatureHashes(size));
+                auto dataProvider = CreateRawDataProvider(size, {}, std::move(catFeatures), {});
+                TRawObjectsDataProviderPtr rawObjectsData(
+                    dynamic_cast<TRawObjectsDataProvider*>(dataProvider->ObjectsData.Get()));
+                Y_VERIFY(rawObjectsData);
+
+                TBenchmarkCase benchmarkCase;
+                benchmarkCase.ItemCount = size;
+                // hashed value and perfect hash index
+                benchmarkCase.BytesPerItem = 2 * sizeof(ui32);
+                benchmarkCase.Run = [=] () {
+                    // perfect hash is built once for quantized features info, so new one is needed for each run
+                    auto quantizedFeaturesInfo = MakeIntrusive<TQuantizedFeaturesInfo>(
+                        *rawObjectsData->GetFeaturesLayout(),
+                        /*ignoredFeatures*/ TConstArrayRef<ui32>(),
+                        NCatboostOptions::TBinarizationOptions(),
+                        /*floatFeaturesAllowNansInTestOnly*/ true,
+                        /*allowWriteFiles*/ false);
+                    TRestorableFastRng64 rand(options.Seed);
+                    Quantize(TQuantizationOptions(), rawObjectsData, quantizedFeaturesInfo, &rand, localExecutor);
+                };
+                return benchmarkCase;
+            }
+        };
+    }
+
+    // bucket statistics accumulation for float features at depth 6 (CalcStatsKernel)
+    static TBenchmark MakeCalcStatsBenchmark() {
+        return {
+            "CalcStats[float_features=4,depth=6]",
+            DocCounts,
+            [] (ui64 size, const TBenchmarkOptions& options, NPar::TLocalExecutor* localExecutor) {
+                const ui32 floatFeatureCount = 4;
+                const int depth = 6;
+                auto environment = CreateTrainingEnvironment(size, floatFeatureCount, 0, 0, options, localExecutor);
+                auto* ctx = environment->Ctx.Get();
+                auto* fold = &ctx->LearnProgress.Folds[0];
+
+                TFastRng64 rng(options.Seed);
+                TVector<TIndexType> indices;
+                indices.yresize(size);
+                for (auto& index : indices) {
+                    index = rng.Uniform(1 << depth);
+                }
+                ctx->SampledDocs.Create(
+                    ctx->LearnProgress.Folds,
+                    /*isPairwiseScoring*/ false,
+                    static_cast<int>(ctx->Params.ObliviousTreeOptions->DevScoreCalcObjBlockSize));
+                Bootstrap(ctx->Params, indices, fold, &ctx->SampledDocs, localExecutor, &ctx->Rand);
+
+                TBenchmarkCase benchmarkCase;
+                benchmarkCase.ItemName = "doc x feature";
+                benchmarkCase.ItemCount = size * floatFeatureCount;
+                // bucket, leaf index, weighted derivative and sample weight
+                benchmarkCase.BytesPerItem = sizeof(ui8) + sizeof(TIndexType) + sizeof(double) + sizeof(float);
+                benchmarkCase.Run = [=] () {
+                    auto* ctx = environment->Ctx.Get();
+                    TStats3D stats3d;
+                    for (auto floatFeatureIdx : xrange(floatFeatureCount)) {
+                        TSplitCandidate split;
+                        split.Type = ESplitType::FloatFeature;
+                        split.FeatureIdx = floatFeatureIdx;
+                        CalcStatsAndScores(
+                            *environment->Data.Learn->ObjectsData,
+                            fold->GetAllCtrs(),
+                            ctx->SampledDocs,
+                            ctx->SmallestSplitSideDocs,
+                            fold,
+                            TFlatPairsInfo(),
+                            ctx->Params,
+                            split,
+                            depth,
+                            /*useTreeLevelCaching*/ false,
+                            localExecutor,
+                            &ctx->PrevTreeLevelStats,
+                            &stats3d,
+                            /*pairwiseStats*/ nullptr,
+                            /*scoreBins*/ nullptr);
+                    }
+                };
+                return benchmarkCase;
+            }
+        };
+    }
+
+    // online CTRs calculation for a single categorical feature projection
+    static TBenchmark MakeComputeOnlineCtrsBenchmark() {
+        return {
+            "ComputeOnlineCTRs[unique_values=1000]",
+            DocCounts,
+            [] (ui64 size, const TBenchmarkOptions& options, NPar::TLocalExecutor* localExecutor) {
+                auto environment = CreateTrainingEnvironment(
+                    size,
+                    /*floatFeatureCount*/ 1,
+                    /*catFeatureCount*/ 1,
+                    /*catFeatureUniqueValueCount*/ 1000,
+                    options,
+                    localExecutor);
+                const auto* fold = &environment->Ctx->LearnProgress.Folds[0];
+                TProjection projection;
+                projection.AddCatFeature(0);
+
+                TOnlineCTR onlineCtr;
+                ComputeOnlineCTRs(environment->Data, *fold, projection, environment->Ctx.Get(), &onlineCtr);
+                ui64 ctrValueCount = 0;
+                for (const auto& ctr : onlineCtr.Feature) {
+                    for (auto y : xrange(ctr.GetYSize())) {
+                        for (auto x : xrange(ctr.GetXSize())) {
+                            ctrValueCount += ctr[y][x].size();
+                        }
+                    }
+                }
+
+                TBenchmarkCase benchmarkCase;
+                benchmarkCase.ItemCount = size;
+                // perfect hash index, target class and calculated CTR values
+                benchmarkCase.BytesPerItem = 2 * sizeof(ui32) + ctrValueCount * sizeof(ui8) / size;
+                benchmarkCase.Run = [=] () {
+                    TOnlineCTR onlineCtr;
+                    ComputeOnlineCTRs(environment->Data, *fold, projection, environment->Ctx.Get(), &onlineCtr);
+                };
+                return benchmarkCase;
+            }
+        };
+    }
+
+
+    TVector<TBenchmark> GetTrainingBenchmarks() {
+        return {
+            MakeDsvLineParserBenchmark(),
+            MakeCatFeaturePerfectHashBenchmark(),
+            MakeCalcStatsBenchmark(),
+            MakeComputeOnlineCtrsBenchmark()
+        };
+    }
+}
@@ -0,0 +1,134 @@
+#include "quantile_sketch.h"
+
+#include <util/generic/algorithm.h>
+#include <util/generic/utility.h>
+#include <util/generic/yexception.h>
+
+#include <cmath>
+#include <utility>
+
+namespace NSplitSelection {
+    static constexpr ui32 MIN_LEVEL_CAPACITY = 8;
+    static constexpr double LEVEL_CAPACITY_DECAY = 2.0 / 3.0;
+    TQuantileSketch::TQuantileSketch(ui32 capacity)
+        : Capacity(capacity)
+        , Compactors(1)
+    {
+        Y_ENSURE(capacity >= MIN_LEVEL_CAPACITY, "quantile sketch capacity should be at least " << MIN_LEVEL_CAPACITY);
+    }
+
+    size_t TQuantileSketch::GetLevelCapacity(size_t level) const {
+        const size_t depthFromTop = Compactors.size() - 1 - level;
+        const double capacity = Capacity * std::pow(LEVEL_CAPACITY_DECAY, (double)depthFromTop);
+        return Max<size_t>((size_t)std::ceil(capacity), MIN_LEVEL_CAPACITY);
+    }
+
+    size_t TQuantileSketch::GenCompactionOffset() {
+        RandState = RandState * 6364136223846793005ULL + 1442695040888963407ULL;
+        return RandState >> 63;
+    }
+
+    void TQuantileSketch::Compress() {
+        for (size_t level = 0; level < Compactors.size(); ++level) {
+            if (Compactors[level].size() < GetLevelCapacity(level)) {
+                continue;
+            }
+            if (level + 1 == Compactors.size()) {
+                Compactors.emplace_back();
+            }
+            TVector<float>& compactor = Compactors[level];
+            TVector<float>& nextCompactor = Compactors[level + 1];
+
+            Sort(compactor.begin(), compactor.end());
+
+            // keep one value at this level if count is odd so that total weight is preserved
+            const size_t pairedSize = compactor.size() & ~size_t(1);
+            const size_t offset = GenCompactionOffset();
+            for (size_t i = offset; i < pairedSize; i += 2) {
+                nextCompactor.push_back(compactor[i]);
+            }
+            if (pairedSize != compactor.size()) {
+                compactor[0] = compactor.back();
+                compactor.resize(1);
+            } else {
+                compactor.clear();
+            }
+        }
+    }
+
+    void TQuantileSketch::Merge(const TQuantileSketch& rhs) {
+        if (rhs.Empty()) {
+            return;
+        }
+        if (Empty()) {
+            MinValue = rhs.MinValue;
+            MaxValue = rhs.MaxValue;
+        } else {
+            MinValue = Min(MinValue, rhs.MinValue);
+            MaxValue = Max(MaxValue, rhs.MaxValue);
+        }
+        Count += rhs.Count;
+        if (Compactors.size() < rhs.Compactors.size()) {
+            Compactors.resize(rhs.Compactors.size());
+        }
+        for (size_t level = 0; level < rhs.Compactors.size(); ++level) {
+            Compactors[level].insert(
+                Compactors[level].end(),
+                rhs.Compactors[level].begin(),
+                rhs.Compactors[level].end());
+        }
+        Compress();
+    }
+
+    size_t TQuantileSketch::GetRetainedSize() const {
+        size_t result = 0;
+        for (const auto& compactor : Compactors) {
+            result += compactor.size();
+        }
+        return result;
+    }
+
+    TVector<float> TQuantileSketch::GetSortedSample(size_t sampleSize) const {
+        if (Empty() || (sampleSize == 0)) {
+            return {};
+        }
+
+        // (value, weight)
+        TVector<std::pair<float, ui64>> weightedValues;
+        weightedValues.reserve(GetRetainedSize());
+        for (size_t level = 0; level < Compactors.size(); ++level) {
+            for (float value : Compactors[level]) {
+                weightedValues.emplace_back(value, ui64(1) << level);
+            }
+        }
+        Sort(weightedValues.begin(), weightedValues.end());
+
+        TVector<float> sample;
+        sample.yresize(sampleSize);
+        const double totalWeight = Count;
+        ui64 cumulativeWeight = 0;
+        size_t valueIdx = 0;
+        for (size_t i = 0; i < sampleSize; ++i) {
+            const double rank = (i + 0.5) * totalWeight / sampleSize;
+            while ((valueIdx + 1 < weightedValues.size())
+                   && (double)(cumulativeWeight + weightedValues[valueIdx].second) <= rank)
+            {
+                cumulativeWeight += weightedValues[valueIdx].second;
+                ++valueIdx;
+            }
+            sample[i] = weightedValues[valueIdx].first;
+        }
+        sample.front() = MinValue;
+        sample.back() = MaxValue;
+        return sample;
+    }
+}
+
+THashSet<float> BestSplit(
+    const NSplitSelection::TQuantileSketch& sketch,
+    int maxBordersCount,
+    EBorderSelectionType type,
+    size_t sampleSize) {
+    TVector<float> sortedSample = sketch.GetSortedSample(Min<ui64>(sampleSize, sketch.GetCount()));
+    return BestSplit(sortedSample, maxBordersCount, type, /*nanValueIsInfty*/ false, /*featuresAreSorted*/ true);
+}
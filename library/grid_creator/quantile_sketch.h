@@ -0,0 +1,84 @@
+#pragma once
+
+#include "binarization.h"
+
+#include <util/generic/hash_set.h>
+#include <util/generic/utility.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+namespace NSplitSelection {
+    /* Mergeable streaming quantile sketch (KLL compactor hierarchy).
+     *
+     * Values are kept in levels of compactors, a value at level h represents 2^h source values.
+     * When a level overflows it is sorted and every second value (with random offset) is promoted
+     * to the next level, so total weight is preserved and memory is O(capacity) regardless of the
+     * number of added values. Rank error is O(1 / capacity).
+     *
+     * Sketches built independently (e.g. on different blocks of data) can be merged.
+     * Results are deterministic for the same sequence of Add and Merge calls.
+     *
+     * NaNs must not be added.
+     */
+    class TQuantileSketch {
+    public:
+        static constexpr ui32 DEFAULT_CAPACITY = 2048;
+
+    public:
+        explicit TQuantileSketch(ui32 capacity = DEFAULT_CAPACITY);
+
+        void Add(float value) {
+            if (Count == 0) {
+                MinValue = value;
+                MaxValue = value;
+            } else {
+                MinValue = Min(MinValue, value);
+                MaxValue = Max(MaxValue, value);
+            }
+            ++Count;
+            Compactors[0].push_back(value);
+            if (Compactors[0].size() >= GetLevelCapacity(0)) {
+                Compress();
+            }
+        }
+
+        void Merge(const TQuantileSketch& rhs);
+
+        ui64 GetCount() const {
+            return Count;
+        }
+
+        bool Empty() const {
+            return Count == 0;
+        }
+
+        // number of values kept in sketch
+        size_t GetRetainedSize() const;
+
+        /* Sorted sample of sampleSize values taken at uniformly spaced ranks, contains exact min and max.
+         * Its empirical distribution approximates the distribution of added values, so it can be used
+         * instead of the full sorted data in binarizers.
+         */
+        TVector<float> GetSortedSample(size_t sampleSize) const;
+
+    private:
+        size_t GetLevelCapacity(size_t level) const;
+        size_t GenCompactionOffset();
+        void Compress();
+
+    private:
+        ui32 Capacity;
+        ui64 Count = 0;
+        float MinValue = 0.0f;
+        float MaxValue = 0.0f;
+        TVector<TVector<float>> Compactors; // [level]
+        ui64 RandState = 0; // LCG state for compaction offsets, kept copyable
+    };
+}
+
+// Select borders using sorted sample of sampleSize values from sketch instead of full sorted data.
+THashSet<float> BestSplit(
+    const NSplitSelection::TQuantileSketch& sketch,
+    int maxBordersCount,
+    EBorderSelectionType type,
+    size_t sampleSize);
@@ -0,0 +1,93 @@
+#include <library/unittest/registar.h>
+
+#include <library/grid_creator/quantile_sketch.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+using NSplitSelection::TQuantileSketch;
+
+static TVector<float> GenerateValues(size_t size, ui64 seed) {
+    TFastRng64 rand(seed);
+    TVector<float> values;
+    values.reserve(size);
+    for (auto i : xrange(size)) {
+        Y_UNUSED(i);
+        // heavy duplicate value and continuous part
+        values.push_back(rand.GenRandReal1() < 0.2 ? 0.5f : (float)rand.GenRandReal1());
+    }
+    return values;
+}
+
+static void CheckRanks(const TVector<float>& sortedValues, const TVector<float>& sortedSample, double maxRankError) {
+    UNIT_ASSERT(IsSorted(sortedSample.begin(), sortedSample.end()));
+    UNIT_ASSERT_VALUES_EQUAL(sortedSample.front(), sortedValues.front());
+    UNIT_ASSERT_VALUES_EQUAL(sortedSample.back(), sortedValues.back());
+    for (auto i : xrange(sortedSample.size())) {
+        const double expectedRank = (i + 0.5) / sortedSample.size();
+        const double lowerRank = double(LowerBound(sortedValues.begin(), sortedValues.end(), sortedSample[i]) - sortedValues.begin())
+            / sortedValues.size();
+        const double upperRank = double(UpperBound(sortedValues.begin(), sortedValues.end(), sortedSample[i]) - sortedValues.begin())
+            / sortedValues.size();
+        UNIT_ASSERT(lowerRank - maxRankError <= expectedRank);
+        UNIT_ASSERT(expectedRank <= upperRank + maxRankError);
+    }
+}
+
+Y_UNIT_TEST_SUITE(QuantileSketchTests) {
+    Y_UNIT_TEST(TestSmallIsExact) {
+        TVector<float> values = GenerateValues(500, 0);
+        TQuantileSketch sketch;
+        for (float value : values) {
+            sketch.Add(value);
+        }
+        Sort(values.begin(), values.end());
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetCount(), values.size());
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetSortedSample(values.size()), values);
+    }
+
+    Y_UNIT_TEST(TestRankError) {
+        TVector<float> values = GenerateValues(1000000, 1);
+        TQuantileSketch sketch;
+        for (float value : values) {
+            sketch.Add(value);
+        }
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetCount(), values.size());
+        UNIT_ASSERT(sketch.GetRetainedSize() < 4 * TQuantileSketch::DEFAULT_CAPACITY);
+
+        Sort(values.begin(), values.end());
+        CheckRanks(values, sketch.GetSortedSample(1000), 0.01);
+    }
+
+    Y_UNIT_TEST(TestMerge) {
+        TVector<float> values = GenerateValues(300000, 2);
+        TVector<TQuantileSketch> blockSketches(7);
+        for (auto i : xrange(values.size())) {
+            blockSketches[i * blockSketches.size() / values.size()].Add(values[i]);
+        }
+        TQuantileSketch sketch;
+        for (const auto& blockSketch : blockSketches) {
+            sketch.Merge(blockSketch);
+        }
+        UNIT_ASSERT_VALUES_EQUAL(sketch.GetCount(), values.size());
+
+        Sort(values.begin(), values.end());
+        CheckRanks(values, sketch.GetSortedSample(1000), 0.01);
+    }
+
+    Y_UNIT_TEST(TestBestSplit) {
+        TVector<float> values = GenerateValues(200000, 3);
+        TQuantileSketch sketch;
+        for (float value : values) {
+            sketch.Add(value);
+        }
+        const auto borders = BestSplit(sketch, 32, EBorderSelectionType::GreedyLogSum, 100000);
+        UNIT_ASSERT(!borders.empty());
+        UNIT_ASSERT(borders.size() <= 32);
+        for (float border : borders) {
+            UNIT_ASSERT(0.0f <= border && border <= 1.0f);
+        }
+    }
+}